@@ -1,14 +1,40 @@
-const gateway = `ws://${window.location.hostname}/ws`;
+// ?control=1 selects the control socket (plain /ws carries the log stream)
+const gateway = `ws://${window.location.hostname}/ws?control=1`;
 let websocket;
 
+// Binary control protocol (see include/ControlProtocol.h). Used once the
+// firmware confirms the version on connect, JSON otherwise.
+const PROTOCOL_VERSION = 1;
+const OPCODES = { vu: 0x01, white: 0x02, brightness: 0x03, animation: 0x04, colour: 0x05 };
+let binaryProtocol = false;
+
+// Live LED view - binary MSG_FRAME stream (see include/FrameStreamer.h)
+const MSG_FRAME = 0x80;
+const FRAME_FLAG_KEY = 0x01;
+const LIVE_VIEW_FPS = 15;
+let liveView = null;    // { cols, rows, pixels }
+
+// Audio spectrum - binary MSG_SPECTRUM stream (see include/SpectrumStreamer.h)
+const MSG_SPECTRUM = 0x81;
+const SPECTRUM_HZ = 30;
+let spectrumSeq = 0;
+
 document.addEventListener('DOMContentLoaded', function() {
     initWebSocket();
     initColorPicker();
 });
 
+// Page load cost (compare with "assets" in /api/telemetry)
+window.addEventListener('load', function() {
+    const entries = performance.getEntriesByType('resource').concat(performance.getEntriesByType('navigation'));
+    const bytes = entries.reduce((total, entry) => total + (entry.transferSize || 0), 0);
+    console.log(`Page load: ${Math.round(performance.now())} ms, ${bytes} bytes transferred`);
+});
+
 function initWebSocket() {
     console.log('Trying to open a WebSocket connection...');
     websocket = new WebSocket(gateway);
+    websocket.binaryType = 'arraybuffer';
     websocket.onopen = onOpen;
     websocket.onclose = onClose;
     websocket.onmessage = onMessage;
@@ -16,7 +42,13 @@ function initWebSocket() {
 
 function onOpen(event) {
     console.log('Connection opened');
-    websocket.send(JSON.stringify({ "message": "connect" }));
+    binaryProtocol = false;
+    websocket.send(JSON.stringify({ "message": "connect", "binary": PROTOCOL_VERSION }));
+
+    // (Re)subscribe - state always, the streams whose views are open
+    liveView = null;
+    spectrumSeq = 0;
+    subscribeTopics();
 }
 
 function onClose(event) {
@@ -25,15 +57,17 @@ function onClose(event) {
 }
 
 function onMessage(event) {
-    const data = JSON.parse(event.data);
-    console.log(data);
-
-    // Ignore log messages (handled by /logs page)
-    if (data.type === "log") {
+    if (event.data instanceof ArrayBuffer) {
+        onBinaryMessage(event.data);
         return;
     }
+    const data = JSON.parse(event.data);
+    console.log(data);
 
-    if (data.message === "states") {
+    if (data.message === "protocol") {
+        binaryProtocol = (data.binary === PROTOCOL_VERSION);
+        console.log(`Binary control protocol ${binaryProtocol ? 'enabled' : 'not supported'}`);
+    } else if (data.message === "states") {
         data.controls.forEach(control => {
             const element = document.getElementById(control.name);
             if (!element) return;
@@ -56,6 +90,185 @@ function onMessage(event) {
     }
 }
 
+function onBinaryMessage(buffer) {
+    const view = new DataView(buffer);
+    if (view.byteLength > 0 && view.getUint8(0) === MSG_SPECTRUM) {
+        onSpectrumMessage(view);
+        return;
+    }
+    if (view.byteLength < 10 || view.getUint8(0) !== MSG_FRAME) {
+        return;
+    }
+
+    const flags = view.getUint8(1);
+    const cols = view.getUint16(2, true);
+    const rows = view.getUint16(4, true);
+
+    if (!liveView || liveView.cols !== cols || liveView.rows !== rows) {
+        if (!(flags & FRAME_FLAG_KEY)) {
+            return;  // Deltas are useless without the keyframe they build on
+        }
+        liveView = { cols: cols, rows: rows, pixels: new Uint8Array(cols * rows * 3) };
+    }
+
+    // Runs of u16 start, u16 count, count * RGB
+    let pos = 10;
+    while (pos + 4 <= view.byteLength) {
+        const start = view.getUint16(pos, true);
+        const count = view.getUint16(pos + 2, true);
+        pos += 4;
+        liveView.pixels.set(new Uint8Array(buffer, pos, count * 3), start * 3);
+        pos += count * 3;
+    }
+
+    drawLiveView();
+}
+
+function drawLiveView() {
+    const canvas = document.getElementById('liveCanvas');
+    if (!canvas || !liveView) return;
+
+    if (canvas.width !== liveView.cols || canvas.height !== liveView.rows) {
+        canvas.width = liveView.cols;
+        canvas.height = liveView.rows;
+    }
+
+    const ctx = canvas.getContext('2d');
+    const image = ctx.createImageData(liveView.cols, liveView.rows);
+    const src = liveView.pixels;
+    for (let i = 0, j = 0; i < src.length; i += 3, j += 4) {
+        image.data[j] = src[i];
+        image.data[j + 1] = src[i + 1];
+        image.data[j + 2] = src[i + 2];
+        image.data[j + 3] = 255;
+    }
+    ctx.putImageData(image, 0, 0);
+}
+
+function onSpectrumMessage(view) {
+    // type, band count, u32 seq, level, bands[], peaks[]
+    const bands = view.getUint8(1);
+    if (view.byteLength < 7 + bands * 2) return;
+
+    // Rate backoff on the device can skip readings but never reorders them
+    const seq = view.getUint32(2, true);
+    if (seq === spectrumSeq) return;
+    spectrumSeq = seq;
+
+    const canvas = document.getElementById('spectrumCanvas');
+    if (!canvas) return;
+    const ctx = canvas.getContext('2d');
+    const width = canvas.width / bands;
+    const height = canvas.height;
+
+    ctx.fillStyle = '#000';
+    ctx.fillRect(0, 0, canvas.width, height);
+    for (let i = 0; i < bands; i++) {
+        const level = view.getUint8(7 + i) / 255;
+        const peak = view.getUint8(7 + bands + i) / 255;
+        const x = i * width + 2;
+        ctx.fillStyle = '#00D9FF';
+        ctx.fillRect(x, height * (1 - level), width - 4, height * level);
+        ctx.fillStyle = '#e0e0e0';
+        ctx.fillRect(x, height * (1 - peak), width - 4, 2);
+    }
+}
+
+function isViewActive(id) {
+    const button = document.getElementById(id);
+    return button && button.classList.contains('active');
+}
+
+function subscribeTopics() {
+    const topics = ["state"];
+    if (isViewActive('liveView')) topics.push("frames");
+    if (isViewActive('spectrumView')) topics.push("spectrum");
+    websocket.send(JSON.stringify({
+        "message": "subscribe", "topics": topics,
+        "fps": LIVE_VIEW_FPS, "scale": 1, "hz": SPECTRUM_HZ
+    }));
+}
+
+function toggleLiveView(element) {
+    const active = !element.classList.contains('active');
+    element.classList.toggle('active', active);
+    element.textContent = active ? 'Hide' : 'Show';
+    document.getElementById('liveCanvas').style.display = active ? 'block' : 'none';
+
+    liveView = null;
+    subscribeTopics();
+}
+
+function toggleSpectrumView(element) {
+    const active = !element.classList.contains('active');
+    element.classList.toggle('active', active);
+    element.textContent = active ? 'Hide' : 'Show';
+    document.getElementById('spectrumCanvas').style.display = active ? 'block' : 'none';
+
+    spectrumSeq = 0;
+    subscribeTopics();
+}
+
+// Boot phases from /api/boot, in start order. Instant events (first-led,
+// first-frame...) have no duration
+function toggleBootView(element) {
+    const active = !element.classList.contains('active');
+    element.classList.toggle('active', active);
+    element.textContent = active ? 'Hide' : 'Show';
+    const table = document.getElementById('bootProfile');
+    table.style.display = active ? 'table' : 'none';
+    if (!active) {
+        return;
+    }
+
+    fetch('/api/boot')
+        .then(response => response.json())
+        .then(boot => {
+            const rows = boot.phases
+                .slice()
+                .sort((a, b) => a.startMs - b.startMs)
+                .map(phase => {
+                    const duration = phase.durationUs >= 1000 ? `${Math.round(phase.durationUs / 1000)} ms` : '';
+                    return `<tr><td>${phase.name}</td><td>@${phase.startMs} ms</td><td>${duration}</td></tr>`;
+                });
+            rows.push(`<tr><td>setup</td><td></td><td>${boot.totalMs} ms</td></tr>`);
+            table.innerHTML = rows.join('');
+        })
+        .catch(error => console.log('Boot profile unavailable:', error));
+}
+
+function sendBinary(opcode, a = 0, b = 0, c = 0) {
+    websocket.send(new Uint8Array([opcode, a, b, c]).buffer);
+}
+
+function hexToRgb(hex) {
+    let value = hex.replace('#', '');
+    if (value.length === 3) {
+        value = value.split('').map(ch => ch + ch).join('');
+    }
+    const number = parseInt(value, 16);
+    return [(number >> 16) & 0xff, (number >> 8) & 0xff, number & 0xff];
+}
+
+function sendControl(name, value, animation) {
+    if (binaryProtocol && OPCODES[name] !== undefined) {
+        if (name === 'colour') {
+            sendBinary(OPCODES.colour, ...hexToRgb(value));
+        } else if (name === 'animation') {
+            sendBinary(OPCODES.animation, value ? 1 : 0, animation || 0);
+        } else {
+            sendBinary(OPCODES[name], Number(value) & 0xff);
+        }
+        return;
+    }
+
+    const message = { "message": name, "value": value };
+    if (animation !== undefined) {
+        message.animation = animation;
+    }
+    websocket.send(JSON.stringify(message));
+}
+
 function populateAnimations(animations) {
     const select = document.getElementById('animation');
     select.innerHTML = '<option value="-1">Select Animation</option>';
@@ -79,26 +292,16 @@ function animationChange(element) {
     
     if (value > -1) {
         element.classList.add("active");
-        websocket.send(JSON.stringify({
-            "message": "animation",
-            "value": true,
-            "animation": value
-        }));
+        sendControl("animation", true, value);
     } else {
         element.classList.remove("active");
-        websocket.send(JSON.stringify({
-            "message": "animation",
-            "value": false
-        }));
+        sendControl("animation", false);
     }
 }
 
 function toggleControl(element) {
     const isActive = element.classList.contains('active');
-    websocket.send(JSON.stringify({
-        "message": element.id,
-        "value": !isActive
-    }));
+    sendControl(element.id, !isActive);
 
     // If turning on White, reset animation dropdown (VU works with animations)
     if (!isActive && element.id === 'white') {
@@ -111,10 +314,7 @@ function toggleControl(element) {
 }
 
 function changeBrightness(element) {
-    websocket.send(JSON.stringify({
-        "message": element.id,
-        "value": parseInt(element.value)
-    }));
+    sendControl(element.id, parseInt(element.value));
 }
 
 let currentColor = '#ff0000';
@@ -222,10 +422,7 @@ function updateColorDisplay(color) {
 
 function setColor(color) {
     updateColorDisplay(color);
-    websocket.send(JSON.stringify({
-        "message": "colour",
-        "value": color
-    }));
+    sendControl("colour", color);
 
     // Reset animation dropdown so same animation can be re-selected
     const animSelect = document.getElementById('animation');
@@ -276,10 +473,7 @@ function isValidHex(hex) {
 }
 
 function colourChange(element) {
-    websocket.send(JSON.stringify({
-        "message": element.id,
-        "value": element.value
-    }));
+    sendControl(element.id, element.value);
 }
 
 
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Read-only web asset bundle, laid out for serving straight from flash
+ *
+ * Written by scripts/build_web_assets.py to the "assets" partition. All
+ * integers are little-endian, every section is 4-byte aligned:
+ *
+ *   Header   magic "UIAB", version, entry count, total size, checksum, build
+ *   Entry[]  fixed-size index, one per file (see Entry)
+ *   blobs    gzipped file contents, contiguous, each padded to 4 bytes
+ *
+ * The checksum is FNV-1a over everything after the header, so a partially
+ * written partition is rejected rather than served. The build id is the
+ * "build" of the assets.json written alongside, so the device can tell a
+ * bundle from an older upload than its file system.
+ *
+ * The reader only needs a pointer to the bytes - a mapped flash partition on
+ * the device, or a file read into memory on a development machine - and has
+ * no Arduino dependencies.
+ */
+namespace AssetBundle {
+
+static const uint32_t MAGIC = 0x42415549;   // "UIAB"
+static const uint16_t VERSION = 2;
+static const uint32_t FLAG_IMMUTABLE = 0x01;
+
+struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t size;          ///< Header + index + blobs
+    uint32_t checksum;
+    uint32_t build;         ///< FNV-1a of the files' ETags, in order
+};
+
+struct Entry {
+    char path[32];          ///< NUL-padded, e.g. "/index.html"
+    char type[24];          ///< Content type, NUL-padded
+    char etag[16];          ///< Content hash, hex, not terminated
+    uint32_t offset;        ///< Of the gzipped blob, from the bundle start
+    uint32_t size;          ///< Uncompressed size
+    uint32_t gzSize;        ///< Blob size
+    uint32_t flags;
+};
+
+static_assert(sizeof(Header) == 20, "AssetBundle::Header layout");
+static_assert(sizeof(Entry) == 88, "AssetBundle::Entry layout");
+
+uint32_t checksum(const uint8_t* data, size_t length);
+
+class Reader {
+public:
+    Reader();
+
+    /**
+     * @brief Validate and attach to a bundle
+     * @param base Start of the bundle (must stay valid while in use)
+     * @param length Bytes available at base (e.g. the partition size)
+     * @return false if the bundle is missing, truncated or corrupt
+     */
+    bool open(const uint8_t* base, size_t length);
+
+    uint16_t count() const { return count_; }
+    uint32_t build() const { return build_; }
+    const Entry* entry(uint16_t index) const;
+    const Entry* find(const char* path) const;
+
+    /**
+     * @brief Gzipped contents of an entry, in place
+     */
+    const uint8_t* data(const Entry& entry) const { return base_ + entry.offset; }
+
+private:
+    const uint8_t* base_;
+    const Entry* entries_;
+    uint16_t count_;
+    uint32_t build_;
+};
+
+} // namespace AssetBundle
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Latest audio analysis, published by VuGraph for other consumers
+ *
+ * Single writer (VuGraph::update on the main loop), any number of readers.
+ * A sequence lock keeps it consistent without ever making the writer wait:
+ * the sequence is odd while a write is in progress and readers retry if it
+ * changed underneath them.
+ *
+ * Peaks are held here (in level units) so they exist even while the VU tab
+ * isn't being drawn.
+ */
+class AudioSnapshot {
+public:
+    static const int NUM_BANDS = 7;
+
+    struct Levels {
+        uint32_t seq;               ///< Publish counter (changes on every publish)
+        uint8_t bands[NUM_BANDS];   ///< 0-255 per band
+        uint8_t peaks[NUM_BANDS];   ///< Peak hold per band
+        uint8_t level;              ///< Overall level
+    };
+
+    AudioSnapshot();
+
+    AudioSnapshot(const AudioSnapshot&) = delete;
+    AudioSnapshot& operator=(const AudioSnapshot&) = delete;
+
+    /**
+     * @brief Publish new band levels (writer only)
+     * @param bands NUM_BANDS levels, 0-255
+     * @param level Overall level, 0-255
+     */
+    void publish(const int* bands, int level);
+
+    /**
+     * @brief Copy the latest consistent levels
+     * @return false if nothing has been published yet
+     */
+    bool read(Levels& out) const;
+
+    /**
+     * @brief Current publish counter (cheap change check)
+     */
+    uint32_t getSequence() const { return seq_ >> 1; }
+
+private:
+    static const unsigned long PEAK_HOLD_MS = 500;
+    static const unsigned long PEAK_DECAY_MS = 50;
+    static const uint8_t PEAK_DECAY_STEP = 26;    ///< One VU segment
+
+    volatile uint32_t seq_;
+    Levels levels_;
+
+    unsigned long peakTimers_[NUM_BANDS];
+};
+
+// Global audio snapshot (written by VuGraph)
+extern AudioSnapshot g_audioSnapshot;
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Records timestamps and heap usage for each boot phase
+ *
+ * Phases are opened with beginPhase() and closed with endPhase(). Each
+ * phase records its start time, duration, free system heap and LVGL heap
+ * usage when it ends. The summary is logged once boot is complete and
+ * exposed through /api/boot and the telemetry endpoint.
+ *
+ * Events that only happen after setup() (first lit LED frame, first UI
+ * frame, end of the fade-in) are still recorded after finish().
+ *
+ * Not thread-safe: call from the main loop task only. Work timed on
+ * another task is added afterwards with record().
+ */
+class BootProfiler {
+public:
+    struct Phase {
+        const char* name;       ///< Static string - not copied
+        uint32_t startUs;       ///< micros() when the phase started
+        uint32_t durationUs;    ///< 0 while the phase is still running
+        uint32_t heapFree;      ///< Free system heap when the phase ended
+        uint32_t lvglUsed;      ///< LVGL heap in use when the phase ended
+        bool done;
+    };
+
+    static const int MAX_PHASES = 24;
+
+    BootProfiler();
+
+    /**
+     * @brief Start a phase
+     * @param name Phase name (must be a string literal or otherwise outlive the profiler)
+     * @return Phase index to pass to endPhase(), or -1 if the table is full
+     */
+    int beginPhase(const char* name);
+
+    /**
+     * @brief Finish a phase and sample heap usage
+     * @param index Index returned by beginPhase()
+     */
+    void endPhase(int index);
+
+    /**
+     * @brief Record an instantaneous event (zero-length phase)
+     */
+    void mark(const char* name);
+
+    /**
+     * @brief Add a phase that was timed elsewhere (e.g. on another task)
+     * @param startUs micros() when it started
+     * @param durationUs How long it took
+     */
+    void record(const char* name, uint32_t startUs, uint32_t durationUs);
+
+    /**
+     * @brief Mark boot as complete and log the summary
+     */
+    void finish();
+
+    bool isFinished() const { return finished_; }
+    int getPhaseCount() const { return phaseCount_; }
+    const Phase& getPhase(int index) const { return phases_[index]; }
+
+    /**
+     * @brief Total boot time in microseconds (until finish())
+     */
+    uint32_t getTotalUs() const { return totalUs_; }
+
+    /**
+     * @brief Current LVGL heap usage in bytes (0 before lv_init())
+     */
+    static uint32_t getLvglHeapUsed();
+
+private:
+    Phase phases_[MAX_PHASES];
+    int phaseCount_;
+    uint32_t totalUs_;
+    bool finished_;
+};
+
+// Global boot profiler instance (constructed before setup())
+extern BootProfiler g_bootProfiler;
@@ -23,14 +23,6 @@ private:
     int maxBrightness_;             ///< Maximum brightness value
     BrightnessCallback callback_;   ///< Callback for brightness changes
     
-    // Static styles for the slider components
-    static lv_style_t indicatorStyle_;
-    static lv_style_t knobStyle_;
-    static bool stylesInitialized_;
-    
-    /// Initialize static styles (called once)
-    static void initializeStyles();
-    
     /// Create and style the slider widget
     void createSlider();
     
@@ -49,6 +49,7 @@ public:
      * @brief Set the color from a hex string (e.g. "#FF0000")
      */
     void setColor(const String& hexString);
+    void setColor(const char* hexString);
 
     /**
      * @brief Set the color from RGB components
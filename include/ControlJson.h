@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include "ControlProtocol.h"
+
+/**
+ * @brief Decoding of JSON control messages into ControlProtocol::Control
+ *
+ * Shared by the WebSocket JSON protocol and PATCH /api/state, so both
+ * accept exactly the same values as the binary protocol. Nothing here
+ * touches the UI or LEDs - decoded changes go to the ControlQueue.
+ */
+namespace ControlJson {
+
+/**
+ * @brief FNV-1a of a message type - lets the dispatch switch on a constant
+ */
+constexpr uint32_t hashMessageType(const char* type, uint32_t hash = 2166136261u) {
+    return *type ? hashMessageType(type + 1, (hash ^ (uint8_t)*type) * 16777619u) : hash;
+}
+
+/**
+ * @brief Decode "#rrggbb" or "rrggbb" (exactly six hex digits)
+ */
+bool decodeColour(const char* hexValue, ControlProtocol::Control& control);
+
+/**
+ * @brief Decode one WebSocket control message ({"message":..,"value":..})
+ * @param messageType hashMessageType() of its "message"
+ */
+bool decodeControl(uint32_t messageType, JsonVariantConst request, ControlProtocol::Control& control);
+
+/**
+ * @brief Decode a PATCH /api/state body into the changes it asks for
+ *
+ * Fields: "animation" (bool, index, or {"state":bool,"index":n}),
+ * "colour", "white", "vu" (bool) and "brightness" (int, clamped).
+ * Controls come out animation first, since starting one turns white
+ * off - an explicit "white" in the same request still wins.
+ *
+ * @param currentAnimation Index kept when only the state is given
+ * @param controls Room for ControlQueue::SLOT_COUNT changes
+ * @return false if any field is invalid or none was given
+ */
+bool decodeState(JsonVariantConst state, uint8_t currentAnimation,
+                 ControlProtocol::Control* controls, uint8_t& count);
+
+} // namespace ControlJson
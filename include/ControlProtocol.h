@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Binary WebSocket control protocol
+ *
+ * Control changes from the web UI (slider drags, toggles, colour picks) can
+ * be sent as fixed 4 byte binary frames instead of JSON text:
+ *
+ *   byte 0     opcode (ControlOpcode)
+ *   bytes 1-3  payload, meaning depends on the opcode (unused bytes are 0)
+ *
+ * Several frames may be sent back to back in one WebSocket message; JSON
+ * clients can do the same with {"message":"batch","commands":[...]}.
+ * Changes are applied once per main loop pass, latest value per control.
+ *
+ * A client asks for it by adding "binary":<version> to its JSON "connect"
+ * message. If the firmware speaks that version it answers with
+ * {"message":"protocol","binary":<version>} and the client switches its
+ * control traffic to binary frames. Clients that don't ask, or firmware
+ * that doesn't answer, keep using JSON - both are always accepted.
+ *
+ * Device to client state (states, animations, logs) stays JSON. Binary
+ * device to client messages start with a message type >= 0x80 so they
+ * can never be mistaken for a control opcode:
+ *
+ *   MSG_FRAME  LED frame stream (see FrameStreamer), little-endian:
+ *     byte 0     MSG_FRAME
+ *     byte 1     flags (FRAME_FLAG_KEY: runs cover the whole frame)
+ *     bytes 2-3  cols
+ *     bytes 4-5  rows
+ *     bytes 6-9  frame sequence
+ *     then runs of: u16 start pixel, u16 pixel count, count * RGB
+ *   Pixels are row-major in matrix order (x along the strip, y = strip).
+ *
+ *   MSG_SPECTRUM  Audio spectrum stream (see SpectrumStreamer):
+ *     byte 0     MSG_SPECTRUM
+ *     byte 1     band count (N)
+ *     bytes 2-5  audio sequence, little-endian
+ *     byte 6     overall level
+ *     then N band levels, then N peak levels (one byte each, 0-255)
+ */
+namespace ControlProtocol {
+
+static const uint8_t VERSION = 1;
+static const size_t FRAME_SIZE = 4;
+
+enum ControlOpcode : uint8_t {
+    OP_VU         = 0x01,   ///< [state]
+    OP_WHITE      = 0x02,   ///< [state]
+    OP_BRIGHTNESS = 0x03,   ///< [brightness]
+    OP_ANIMATION  = 0x04,   ///< [state, animation index]
+    OP_COLOUR     = 0x05    ///< [r, g, b]
+};
+
+/**
+ * @brief Number of animations (LEDManager::AnimationType) - valid indexes
+ *        are 0 to ANIMATION_COUNT - 1
+ */
+static const uint8_t ANIMATION_COUNT = 15;
+
+enum MessageType : uint8_t {
+    MSG_FRAME    = 0x80,
+    MSG_SPECTRUM = 0x81
+};
+
+static const uint8_t FRAME_FLAG_KEY = 0x01;
+static const size_t FRAME_HEADER_SIZE = 10;
+static const size_t FRAME_RUN_HEADER_SIZE = 4;
+
+static const size_t SPECTRUM_HEADER_SIZE = 7;
+
+/**
+ * @brief A decoded control change - both JSON and binary messages end up here
+ */
+struct Control {
+    uint8_t opcode;
+    uint8_t payload[FRAME_SIZE - 1];
+};
+
+/**
+ * @brief Decode a binary frame
+ * @return false if the frame has the wrong size, an unknown opcode or an
+ *         animation index out of range
+ */
+inline bool decode(const uint8_t* data, size_t len, Control& control) {
+    if (len != FRAME_SIZE || data[0] < OP_VU || data[0] > OP_COLOUR) {
+        return false;
+    }
+    if (data[0] == OP_ANIMATION && data[2] >= ANIMATION_COUNT) {
+        return false;
+    }
+    control.opcode = data[0];
+    memcpy(control.payload, data + 1, sizeof(control.payload));
+    return true;
+}
+
+} // namespace ControlProtocol
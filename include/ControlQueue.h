@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ControlProtocol.h"
+
+/**
+ * @brief Pending control changes, one slot per control (last writer wins)
+ *
+ * WebSocket messages arrive on the AsyncTCP task, possibly from several
+ * clients dragging the same slider at once. Instead of running the UI and
+ * LED handlers for every message there, each decoded change is posted to
+ * the slot for its opcode, overwriting any value that hasn't been applied
+ * yet. The main loop drains the queue once per pass, so each control is
+ * applied at most once per frame with its latest value.
+ *
+ * Drained changes come out in the order their latest value arrived, so
+ * changes to different controls keep their relative order.
+ *
+ * post() is safe from any task; drain() is called from the main loop.
+ */
+class ControlQueue {
+public:
+    static const uint8_t SLOT_COUNT = ControlProtocol::OP_COLOUR;
+
+    /**
+     * @brief Queue telemetry (totals since boot)
+     */
+    struct Stats {
+        uint32_t posted;
+        uint32_t applied;       ///< Changes handed out by drain()
+        uint32_t superseded;    ///< Overwritten before they were applied
+    };
+
+    ControlQueue();
+
+    ControlQueue(const ControlQueue&) = delete;
+    ControlQueue& operator=(const ControlQueue&) = delete;
+
+    /**
+     * @brief Post a decoded change, replacing any pending one for that control
+     */
+    void post(const ControlProtocol::Control& control);
+
+    /**
+     * @brief Post several changes at once - they are drained together, in
+     *        this order, never split across two main loop passes
+     */
+    void post(const ControlProtocol::Control* controls, uint8_t count);
+
+    /**
+     * @brief Take every pending change, oldest first
+     * @param out Room for SLOT_COUNT changes
+     * @return Number of changes written to out
+     */
+    uint8_t drain(ControlProtocol::Control* out);
+
+    Stats getStats() const;
+
+private:
+    struct Slot {
+        ControlProtocol::Control control;
+        uint32_t order;         ///< When the latest value arrived
+        bool pending;
+    };
+
+    Slot slots_[SLOT_COUNT];
+    uint32_t nextOrder_;
+    portMUX_TYPE mux_;
+    Stats stats_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief What one running instance of an effect carries between frames
+ *
+ * The main effect, every layer, every zone and every run of strips the
+ * main effect covers between zones owns one, so two instances of the same
+ * effect never step each other's positions. LEDManager points the effects
+ * at the instance being rendered.
+ *
+ * Plain data - reset() before first use, and whenever the instance starts
+ * a different effect.
+ */
+struct EffectState {
+    static const uint8_t RIPPLES = 8;
+    static const uint8_t COMETS = 3;
+
+    uint32_t phase;     ///< Steps run so far - the counter-driven effects derive their position from it
+
+    struct Ripple {
+        uint8_t age[RIPPLES];   ///< 0 = unused
+        int8_t x[RIPPLES];      ///< Centre
+        int8_t y[RIPPLES];
+        uint8_t hue[RIPPLES];
+        uint8_t next;           ///< Slot the next ripple spawns in
+        uint8_t baseHue;
+        uint8_t cooldown;       ///< Steps until the next spawn
+    } ripple;
+
+    struct Comet {
+        int16_t pos[COMETS];    ///< Position along the row
+        int8_t row[COMETS];
+        int8_t dir[COMETS];     ///< 1 = right, -1 = left
+        uint8_t hue[COMETS];
+    } comet;
+
+    void reset() {
+        memset(this, 0, sizeof(*this));
+        static const int8_t ROWS[COMETS] = { 0, 2, 4 };
+        static const int8_t DIRS[COMETS] = { 1, -1, 1 };
+        static const uint8_t HUES[COMETS] = { 0, 85, 170 };
+        memcpy(comet.row, ROWS, sizeof(ROWS));
+        memcpy(comet.dir, DIRS, sizeof(DIRS));
+        memcpy(comet.hue, HUES, sizeof(HUES));
+    }
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+#include <FastLED.h>
+
+#include "ControlProtocol.h"
+
+/**
+ * @brief Streams the LED frame to subscribed WebSocket clients
+ *
+ * Clients subscribe with {"message":"frames","fps":N,"scale":S} (fps 0
+ * unsubscribes). The published frame (LEDManager::getFrame()) is point
+ * sampled every S-th LED in both directions, then delta-encoded against the
+ * last frame *that client* received as runs of changed pixels (see
+ * ControlProtocol MSG_FRAME). A keyframe is sent after subscribing or
+ * whenever a delta would be larger than the whole frame.
+ *
+ * Backpressure is per client: if a client's send queue is full its frame is
+ * skipped and its baseline kept, so the next delta is still correct and the
+ * LED loop never waits on a slow socket.
+ *
+ * subscribe()/removeClient() may be called from the WebSocket event handler;
+ * all buffers are (re)allocated from update() on the main loop, including
+ * after the LED layout changes (every client then gets a new keyframe).
+ */
+class FrameStreamer {
+public:
+    /**
+     * @brief Stream telemetry (totals since boot)
+     */
+    struct Stats {
+        uint8_t subscribers;
+        uint32_t framesSent;
+        uint32_t keyframes;
+        uint32_t bytesSent;
+        uint32_t bytesRaw;          ///< What keyframes for every sent frame would have cost
+        uint32_t skipped;           ///< Frames skipped because a client queue was full
+        uint32_t encodeUs;          ///< Time spent sampling and encoding
+    };
+
+    static const uint8_t MAX_SUBSCRIBERS = 4;
+    static const uint8_t MAX_FPS = 30;
+    static const uint8_t MAX_SCALE = 8;
+
+    explicit FrameStreamer(AsyncWebSocket* webSocket);
+    ~FrameStreamer();
+
+    FrameStreamer(const FrameStreamer&) = delete;
+    FrameStreamer& operator=(const FrameStreamer&) = delete;
+
+    /**
+     * @brief Subscribe, resubscribe or (fps 0) unsubscribe a client
+     * @return false if all subscriber slots are taken
+     */
+    bool subscribe(uint32_t clientId, uint8_t fps, uint8_t scale);
+
+    /**
+     * @brief Drop a disconnected client's subscription
+     */
+    void removeClient(uint32_t clientId);
+
+    /**
+     * @brief Send due frames (call from the main loop after the LED update)
+     */
+    void update();
+
+    Stats getStats() const;
+
+private:
+    struct Subscriber {
+        uint32_t id;            ///< 0 = free slot
+        uint8_t fps;
+        uint8_t scale;
+        bool changed;           ///< fps/scale changed by subscribe()
+        // Main loop only
+        uint8_t activeFps;
+        uint8_t activeScale;
+        uint8_t* baseline;      ///< RGB of the last frame this client received
+        uint16_t cols;
+        uint16_t rows;
+        bool needsKeyframe;
+        uint32_t lastSeq;
+        unsigned long lastSent;
+    };
+
+    AsyncWebSocket* webSocket_;
+    Subscriber subscribers_[MAX_SUBSCRIBERS];
+    portMUX_TYPE mux_;
+
+    uint8_t* current_;          ///< Sampled frame, RGB
+    uint8_t* message_;          ///< Encoded message
+    size_t capacityPixels_;     ///< Size of current_ / message_ in pixels
+
+    Stats stats_;
+    uint32_t geometryVersion_;  ///< LEDManager layout the baselines were sized for
+
+    void applySubscriptionChanges();
+    bool ensureBuffers(size_t pixels);
+    void freeBuffers();
+    void sample(const CRGB* frame, uint8_t scale, uint16_t cols, uint16_t rows);
+    size_t encode(Subscriber& sub, uint32_t seq);
+    void sendDueFrames(uint8_t scale, uint32_t seq, unsigned long now);
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/**
+ * @brief Fixed-capacity bump allocator for short-lived JsonDocuments
+ *
+ * Gives a JsonDocument a preallocated buffer so parsing or building a
+ * WebSocket message doesn't touch the heap. Blocks are released when the
+ * document is cleared or destroyed; the arena rewinds once nothing is live.
+ * If a document outgrows the buffer, the arena falls back to malloc and
+ * counts it, so an oversized message still works and shows up in telemetry.
+ *
+ * Not thread safe - use one arena per task.
+ */
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    /**
+     * @brief Arena telemetry (totals since boot)
+     */
+    struct Stats {
+        uint32_t capacity;
+        uint32_t peakBytes;     ///< High-water mark of the arena buffer
+        uint32_t fallbacks;     ///< Allocations that had to go to the heap
+    };
+
+    static const size_t CAPACITY = 4096;
+
+    JsonArena();
+
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t newSize) override;
+
+    Stats getStats() const;
+
+private:
+    static const size_t HEADER_SIZE = 8;    ///< Block size, keeps payloads 8-byte aligned
+
+    alignas(8) uint8_t buffer_[CAPACITY];
+    size_t used_;
+    size_t live_;
+    Stats stats_;
+
+    bool owns(const void* ptr) const;
+    static size_t& blockSize(void* ptr);
+};
@@ -3,6 +3,14 @@
 #include <Arduino.h>
 #include <FastLED.h>
 #include <Preferences.h>
+#include <esp_attr.h>
+
+#include "EffectState.h"
+#include "LedOverlay.h"
+#include "LayerCompositor.h"
+#include "LedZones.h"
+#include "PowerLimiter.h"
+#include "OutputStage.h"
 
 /**
  * @brief Modern C++ LED Manager class
@@ -57,6 +65,25 @@ public:
      * @brief Update LED animations and effects
      */
     void update();
+
+    /**
+     * @brief Ask for a new strip layout, applied in place by the next update()
+     *
+     * Safe from any task. Frame buffers are swapped on the main loop between
+     * two frames; the rest of the system keeps running.
+     * FastLED's ESP32 RMT driver sizes its pixel buffer on the first show()
+     * and never grows it, so layouts with more LEDs than the boot layout
+     * can't be applied in place.
+     * @return false if this needs a restart (not initialized, or more LEDs
+     *         than the boot layout)
+     */
+    bool requestReconfigure(int numStrips, int ledsPerStrip);
+
+    /**
+     * @brief Incremented whenever the strip layout changes
+     * Consumers holding per-layout buffers compare it to rebuild them
+     */
+    uint32_t getGeometryVersion() const { return geometryVersion_; }
     
     /**
      * @brief Set LED brightness
@@ -65,15 +92,85 @@ public:
     void setBrightness(uint8_t brightness);
     
     /**
-     * @brief Perform startup fade-in sequence
+     * @brief Start the startup fade-in
+     *
+     * Draws the saved scene and shows the first frame at zero brightness;
+     * update() then ramps brightness up over ~2 s, one step per frame,
+     * so the rest of setup() and the main loop keep running.
+     * After a warm restart (see prepareForRestart()) the scene is shown at
+     * full brightness straight away instead.
+     */
+    void startFadeIn();
+
+    /**
+     * @brief Stash the current state in RTC memory before an intentional restart
+     *
+     * Flushes any unsaved state to NVS, then leaves a checksummed snapshot
+     * (mode, colour, brightness, animation and its phase) that survives a
+     * software reset. initialize() restores it on the next boot and the
+     * fade-in is skipped, so the lights carry on where they were.
+     */
+    void prepareForRestart();
+
+    /**
+     * @brief Check if this boot resumed from a restart snapshot
      */
-    void performStartupFadeIn();
+    bool isResumed() const { return resumed_; }
 
     /**
-     * @brief Show OTA update progress on LEDs
-     * @param progress Progress percentage (0-100)
+     * @brief Check if the startup fade-in is still running
      */
-    void showOTAProgress(uint8_t progress);
+    bool isFading() const { return fading_; }
+
+    /**
+     * @brief Run extra effects blended over the current one
+     *
+     * Safe from any task - applied at the start of the next frame. Layers
+     * sit above the main animation (or solid/white colour), bottom first.
+     * @param count 0 turns layering off
+     * @return false if not initialized, out of layer memory, or a layer
+     *         has an unknown effect or blend mode
+     */
+    bool setLayers(const LayerCompositor::Layer* layers, uint8_t count);
+
+    const LayerCompositor& getCompositor() const { return compositor_; }
+
+    /**
+     * @brief Replace the zone definitions - saved, applied by the next update()
+     * Safe from any task
+     * @return false if not initialized, zones overlap, or a zone has an
+     *         unknown effect or audio band
+     */
+    bool setZones(const LedZones::Zone* zones, uint8_t count);
+
+    const LedZones& getZones() const { return zones_; }
+
+    /**
+     * @brief Replace the power supplies and their mA budgets - saved,
+     *        applied by the next update()
+     * Safe from any task
+     * @param count 0 turns power limiting off
+     * @return false if not initialized or the supplies are invalid
+     */
+    bool setPowerSupplies(const PowerLimiter::Supply* supplies, uint8_t count);
+
+    const PowerLimiter& getPowerLimiter() const { return limiter_; }
+
+    /**
+     * @brief Replace gamma, colour correction, per-strip white balance and
+     *        colour order - saved, applied by the next update()
+     * Safe from any task
+     * @return false if not initialized or the settings are invalid
+     */
+    bool setOutputSettings(const OutputStage::Settings& settings);
+
+    const OutputStage& getOutputStage() const { return outputStage_; }
+
+    /**
+     * @brief Status layer over the effect (OTA progress, error flashes)
+     * Requests are safe from any task; it is drawn by update()
+     */
+    LedOverlay& getOverlay() { return overlay_; }
 
     /**
      * @brief Get current brightness
@@ -162,6 +259,19 @@ public:
      * @brief Clear saved LED state from preferences
      */
     void clearSavedState();
+
+    /**
+     * @brief State persistence telemetry
+     */
+    struct PersistStats {
+        uint32_t lifetimeWrites;    ///< Blob writes over the device's life (flash wear)
+        uint32_t writes;            ///< Writes since boot
+        uint32_t skipped;           ///< Debounced saves that matched the stored copy
+        bool migrated;              ///< Converted from the per-key format this boot
+        bool resumed;               ///< Restored from the restart snapshot this boot
+    };
+
+    PersistStats getPersistStats() const { return persistStats_; }
     
     /**
      * @brief Fill all LEDs with white
@@ -206,6 +316,31 @@ public:
      */
     bool isConfigValid() const;
     
+    /**
+     * @brief Get the most recently shown LED frame
+     * A snapshot published with each show(), never the buffer being
+     * rendered into. Valid until the next update() on the main loop.
+     * With effect layers this is the blended frame, with the overlay drawn
+     * over it while one is up. Brightness, gamma, calibration and power
+     * limiting are never in it
+     * @return Pointer to getTotalLeds() pixels, or nullptr if not allocated
+     */
+    const CRGB* getFrame() const { return published_; }
+
+    /**
+     * @brief Get the published frame sequence number
+     * Incremented every time a frame is pushed to the strips
+     */
+    uint32_t getFrameSequence() const { return frameSeq_; }
+
+    /**
+     * @brief Convert a 2D matrix coordinate to its snake-wired LED index
+     * @param x Column position within the strip
+     * @param y Row (strip index)
+     * @return LED index, or -1 if out of bounds
+     */
+    int xyToIndex(int x, int y) const;
+
     /**
      * @brief Get animation description
      * @param animation Animation type
@@ -226,6 +361,8 @@ private:
     
     // Member variables
     CRGB* leds_;
+    CRGB* published_;   ///< Last shown frame (see getFrame())
+    CRGB* output_;      ///< Transmit buffer, in wire order (see OutputStage)
     int numStrips_;
     int ledsPerStrip_;
     int totalLeds_;
@@ -244,29 +381,125 @@ private:
     bool stateLoaded_;
     unsigned long stateChangedTime_;
     static const unsigned long STATE_SAVE_DEBOUNCE_MS = 5000;
+
+    /**
+     * @brief Saved state, stored as one "state" blob in the led-state namespace
+     * Only the bytes before writeCount are compared to decide whether a save
+     * is needed; crc covers everything before it
+     */
+    struct StateBlob {
+        uint8_t version;
+        uint8_t brightness;
+        uint8_t flags;          ///< STATE_FLAG_*
+        uint8_t animation;
+        uint8_t colour[3];
+        uint8_t reserved;
+        uint32_t writeCount;
+        uint32_t crc;
+    };
+    static const uint8_t STATE_BLOB_VERSION = 1;
+    static const uint8_t STATE_FLAG_ANIMATION = 0x01;
+    static const uint8_t STATE_FLAG_WHITE = 0x02;
+    static const uint8_t STATE_FLAG_VU = 0x04;
+
+    StateBlob persisted_;       ///< Last blob read or written
+    bool havePersisted_;
+    PersistStats persistStats_;
+
+    /**
+     * @brief Warm restart handoff, kept in RTC memory across a software reset
+     * Only trusted with the right magic, version and crc after ESP_RST_SW,
+     * and invalidated as soon as it has been read
+     */
+    struct RestartSnapshot {
+        uint32_t magic;
+        uint8_t version;
+        uint8_t reserved[3];
+        StateBlob state;            ///< writeCount and crc unused
+        uint32_t animationPhase;
+        uint32_t crc;               ///< Over everything before it
+    };
+    static const uint32_t RESTART_SNAPSHOT_MAGIC = 0x4C454453;  // "LEDS"
+    static const uint8_t RESTART_SNAPSHOT_VERSION = 1;
+    static RestartSnapshot restartSnapshot_;
+
+    bool resumed_;
     
     // VU data
     int vuLevels_[7];
     int audioLevel_;
 
-    // OTA progress tracking
-    uint8_t lastOTAProgress_;
+    // Output stage: effect layers, then the status layer, then the LUT pass
+    // into output_ and the power limit (see setLayers(), getOverlay(),
+    // setOutputSettings(), setPowerSupplies())
+    LayerCompositor compositor_;
+    LedOverlay overlay_;
+    OutputStage outputStage_;
+    PowerLimiter limiter_;
+    uint8_t outputLevel_;       ///< Brightness for this frame (user, VU or fade)
+
+    // Zones (see setZones()). Effects render through a view: leds_,
+    // numStrips_ and totalLeds_ narrowed to the zone's strips
+    LedZones zones_;
+    struct RenderView {
+        CRGB* leds;
+        int numStrips;
+        int totalLeds;
+        int firstStrip;         ///< Keeps the snake wiring parity right
+        uint8_t audioBand;      ///< LedZones::AUDIO_SPREAD or a fixed band
+        int audioLevel;
+    };
+    int viewFirstStrip_;
+    uint8_t viewAudioBand_;
 
     Preferences preferences_;
     
     // Animation timing
     unsigned long lastAnimationUpdate_;
+    EffectState mainEffect_;    ///< The main effect's own state
+    EffectState* effect_;       ///< State of the effect being rendered (main, layer, zone or run)
+
+    // Published frame counter (see getFrameSequence())
+    uint32_t frameSeq_;
+
+    // Startup fade-in (see startFadeIn())
+    bool fading_;
+    unsigned long fadeStart_;
+    unsigned long fadeDurationMs_;
+    bool firstLightMarked_;     ///< "first-led" recorded in the boot profile
+
+    // In-place reconfiguration (see requestReconfigure())
+    CLEDController* controller_;
+    int ledCapacity_;           ///< LED count at the first show()
+    uint32_t geometryVersion_;
+    portMUX_TYPE reconfigureMux_;
+    bool reconfigurePending_;
+    int pendingStrips_;
+    int pendingLedsPerStrip_;
     
     // Private methods
     void loadConfiguration();
     void loadState();
+    bool loadLegacyState(Preferences& statePrefs);
     void saveState();
     void saveStateIfNeeded();
+    void buildStateBlob(StateBlob& blob) const;
+    void applyStateBlob(const StateBlob& blob);
+    static uint32_t stateBlobCrc(const StateBlob& blob);
+    bool restoreRestartSnapshot();
+    static uint32_t restartSnapshotCrc(const RestartSnapshot& snapshot);
     bool allocateLedArrays();
+    void applyPendingReconfigure();
     void deallocateLedArrays();
     void updateBrightness();
-    int getAnimationInterval() const;
-    void runAnimation();
+    int getAnimationInterval(AnimationType animation) const;
+    void runAnimation(AnimationType animation);
+    void renderLayers(unsigned long now);
+    RenderView applyView(const RenderView& view);
+    RenderView stripView(int firstStrip, int stripCount, uint8_t audioBand) const;
+    void applyZones(bool layoutChanged);
+    void renderZones(unsigned long now);
+    void dimZones(CRGB* frame) const;
     
     // Animation implementations
     void fadeAll(int amount);
@@ -295,7 +528,6 @@ private:
     void moveDown();
     int getRandomLed(int divisions, int division) const;
     CRGB pickColour(int led, int vuValue, CRGB colour1, CRGB colour2, CRGB colour3) const;
-    int xyToIndex(int x, int y) const;  // Convert 2D coord to snake-wired linear index
     
     // Static animation descriptions
     static const char* animationDescriptions_[];
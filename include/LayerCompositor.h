@@ -0,0 +1,129 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "EffectState.h"
+
+/**
+ * @brief Extra effect layers blended over the main effect
+ *
+ * Up to MAX_LAYERS effects run on top of the current animation, each in
+ * its own buffer, and are blended into the output frame bottom to top
+ * with a blend mode and an opacity. LEDManager renders the effects into
+ * the layer buffers; this class owns the buffers and does the blending.
+ *
+ * The buffers come from one pool sized for the boot LED count in begin(),
+ * so turning a layer on is a memset on the main loop, never an allocation.
+ *
+ * request() is safe from any task; the new layer set is picked up by
+ * applyPending() at the start of the next frame.
+ */
+class LayerCompositor {
+public:
+    static const uint8_t MAX_LAYERS = 3;
+
+    enum BlendMode : uint8_t {
+        BLEND_ADD = 0,      ///< Saturating sum
+        BLEND_SCREEN,       ///< 1 - (1 - a)(1 - b): brightens without clipping
+        BLEND_MULTIPLY,     ///< a * b: the layer masks what is below
+        BLEND_ALPHA,        ///< Crossfade to the layer by opacity
+        BLEND_MAX,          ///< Per-channel maximum
+        BLEND_COUNT
+    };
+
+    /**
+     * @brief One requested layer
+     */
+    struct Layer {
+        uint8_t effect;         ///< LEDManager::AnimationType
+        uint8_t blend;          ///< BlendMode
+        uint8_t opacity;
+    };
+
+    /**
+     * @brief Per-layer cost (totals since the layer was last set up)
+     */
+    struct LayerStats {
+        uint32_t frames;        ///< Frames blended
+        uint32_t renders;       ///< Effect steps run
+        uint32_t renderUs;
+        uint32_t blendUs;
+    };
+
+    /**
+     * @brief A layer in use, with its buffer and the effect's own timing
+     */
+    struct ActiveLayer {
+        Layer layer;
+        CRGB* buffer;
+        unsigned long lastUpdate;
+        EffectState effect;     ///< The effect's own state
+        LayerStats stats;
+    };
+
+    LayerCompositor();
+    ~LayerCompositor();
+
+    LayerCompositor(const LayerCompositor&) = delete;
+    LayerCompositor& operator=(const LayerCompositor&) = delete;
+
+    /**
+     * @brief Allocate the buffer pool
+     * @param capacity Most LEDs any layout will have
+     * @return false if out of memory - layers stay unavailable
+     */
+    bool begin(int capacity);
+
+    /**
+     * @brief Replace the layer set (0 layers turns compositing off)
+     * @return false if count or a blend mode is out of range
+     */
+    bool request(const Layer* layers, uint8_t count);
+
+    /**
+     * @brief Take a pending layer set - call at the start of a frame
+     * @param pixels Current LED count; new layers start cleared
+     */
+    void applyPending(int pixels);
+
+    /**
+     * @brief Blank every layer buffer (the LED layout changed)
+     */
+    void clearBuffers(int pixels);
+
+    uint8_t getLayerCount() const { return count_; }
+    bool isAvailable() const { return pool_ != nullptr; }
+    ActiveLayer& getLayer(uint8_t index) { return layers_[index]; }
+    const ActiveLayer& getLayer(uint8_t index) const { return layers_[index]; }
+
+    /**
+     * @brief Blend every layer over base into out
+     * @param out Output frame, may not be base
+     */
+    void compose(CRGB* out, const CRGB* base, int pixels);
+
+    /**
+     * @brief Blend one buffer into another in place
+     */
+    static void blend(CRGB* dst, const CRGB* src, int pixels, BlendMode mode, uint8_t opacity);
+
+    static const char* getBlendName(uint8_t mode);
+
+    /**
+     * @brief Look up a blend mode by name
+     * @return BLEND_COUNT if unknown
+     */
+    static BlendMode parseBlendName(const char* name);
+
+private:
+    CRGB* pool_;
+    int capacity_;
+    ActiveLayer layers_[MAX_LAYERS];
+    uint8_t count_;
+
+    portMUX_TYPE mux_;
+    bool pending_;
+    Layer pendingLayers_[MAX_LAYERS];
+    uint8_t pendingCount_;
+};
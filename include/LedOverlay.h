@@ -0,0 +1,90 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+/**
+ * @brief Status layer composited over the LED effect output
+ *
+ * Progress bars, flashes and error patterns are drawn on top of the frame
+ * the current effect rendered, never into it. The effect keeps running
+ * underneath and its buffer is left untouched, so it carries on without a
+ * jump when the overlay goes away.
+ *
+ * Each indication is a small timed state machine advanced by render() on
+ * the main loop - nothing blocks. Requests (showProgress(), flash(),
+ * clear()) are safe from any task; the newest one replaces the current.
+ *
+ * Overlay pixels are shown at LEVEL whatever the user brightness, so a
+ * progress bar stays visible with the strips dimmed or in VU mode. They
+ * are drawn at full value; the OutputStage applies LEVEL through the same
+ * gamma and calibration tables as the effect (see getSpan()).
+ */
+class LedOverlay {
+public:
+    static const uint8_t LEVEL = 150;
+
+    enum Mode : uint8_t {
+        NONE = 0,
+        PROGRESS,       ///< Bar filling every strip in unison, solid green at 100%
+        FLASH           ///< Whole strip on/off a number of times, then clears itself
+    };
+
+    LedOverlay();
+
+    LedOverlay(const LedOverlay&) = delete;
+    LedOverlay& operator=(const LedOverlay&) = delete;
+
+    /**
+     * @brief Show a progress bar (0-100), replacing any other indication
+     */
+    void showProgress(uint8_t percent);
+
+    /**
+     * @brief Flash a colour over the effect
+     * @param count Number of flashes
+     * @param periodMs Length of each on and each off phase
+     */
+    void flash(CRGB colour, uint8_t count, uint16_t periodMs);
+
+    /**
+     * @brief Remove the current indication
+     */
+    void clear();
+
+    bool isActive() const { return mode_ != NONE; }
+
+    /**
+     * @brief Advance the current indication and compose the output frame
+     *
+     * Called once per frame from the main loop. Pixels the overlay doesn't
+     * cover are the effect's, unchanged; getSpan() tells the two apart.
+     * @param out Output frame (numStrips * ledsPerStrip pixels), may be base
+     * @param base Effect frame, not modified
+     * @return false if no indication is active - out is untouched and the
+     *         effect frame should be shown as usual
+     */
+    bool render(CRGB* out, const CRGB* base, int numStrips, int ledsPerStrip);
+
+    /**
+     * @brief Pixels of a strip the last render() drew, to be shown at LEVEL
+     *
+     * Always one run per strip: a bar starts at the strip's first LED in
+     * wiring order reversed on even strips, like LEDManager::xyToIndex().
+     * @param first Set to the first covered LED of the strip
+     * @param count Set to the number covered, 0 if none
+     */
+    void getSpan(int strip, int ledsPerStrip, int& first, int& count) const;
+
+private:
+    volatile Mode mode_;
+    uint8_t progress_;
+    CRGB colour_;
+    uint8_t count_;
+    uint16_t periodMs_;
+    unsigned long startMs_;
+    bool started_;              ///< startMs_ set by the first render() of a flash
+    uint32_t generation_;       ///< Bumped by every request
+    portMUX_TYPE mux_;
+    int covered_;               ///< LEDs per strip the last render() drew (main loop only)
+};
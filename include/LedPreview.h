@@ -0,0 +1,118 @@
+#pragma once
+
+#include <lvgl.h>
+#include <Arduino.h>
+
+/**
+ * @brief On-screen preview of the LED matrix
+ *
+ * A single LVGL object that draws the LED frame as a grid of cells from its
+ * own DRAW_MAIN handler - no per-pixel objects. The matrix is downsampled
+ * to at most MAX_COLS x MAX_ROWS cells by point sampling (serpentine wiring
+ * resolved by LEDManager), so the per-update cost depends on the cell count,
+ * not on the number of LEDs.
+ *
+ * update() is throttled and only runs when a new frame has been published.
+ * Cells are compared in RGB565 and only the spans of changed cells are
+ * invalidated.
+ */
+class LedPreview {
+public:
+    /**
+     * @brief Preview cost telemetry (per 1 second window)
+     */
+    struct Stats {
+        uint16_t cols;
+        uint16_t rows;
+        uint16_t cellPx;            ///< Cell size on screen
+        uint32_t samplesPerSec;     ///< Preview updates that sampled a new frame
+        uint32_t sampleUsPerSec;    ///< Time spent sampling/diffing the frame
+        uint32_t drawUsPerSec;      ///< Time spent in the draw handler
+        uint32_t changedCellsPerSec;
+        uint32_t maxSampleUs;       ///< Worst single update in the window
+    };
+
+    static const int MAX_COLS = 64;
+    static const int MAX_ROWS = 48;
+    static const uint32_t UPDATE_INTERVAL_MS = 66;  // ~15 fps
+
+    LedPreview();
+    ~LedPreview();
+
+    LedPreview(LedPreview&& other) noexcept;
+    LedPreview& operator=(LedPreview&& other) noexcept;
+
+    LedPreview(const LedPreview&) = delete;
+    LedPreview& operator=(const LedPreview&) = delete;
+
+    /**
+     * @brief Create the preview object on the specified parent
+     * @param parent The parent LVGL object (layout handled by parent)
+     * @param width Width in pixels
+     * @param height Height in pixels
+     * @return true if initialization was successful
+     */
+    bool initialize(lv_obj_t* parent, int32_t width, int32_t height);
+
+    /**
+     * @brief Sample the latest published LED frame (throttled)
+     * Call from the UI loop while the preview is on screen
+     */
+    void update();
+
+    /**
+     * @brief Get preview cost telemetry
+     */
+    Stats getStats() const;
+
+    bool isInitialized() const { return initialized_; }
+    lv_obj_t* getLvglObject() const { return obj_; }
+
+private:
+    lv_obj_t* obj_;
+    bool initialized_;
+
+    // Geometry - rebuilt when the LED layout changes
+    int ledCols_;
+    int ledRows_;
+    int cols_;
+    int rows_;
+    int cellPx_;
+    int32_t offsetX_;   ///< Centres the grid inside the object
+    int32_t offsetY_;
+
+    uint16_t* cells_;   ///< RGB565 per cell, cols_ * rows_
+    uint32_t lastFrameSeq_;
+    unsigned long lastUpdate_;
+
+    // Cost accounting
+    unsigned long windowStart_;
+    uint32_t samples_;
+    uint32_t sampleUs_;
+    uint32_t drawUs_;
+    uint32_t changedCells_;
+    uint32_t maxSampleUs_;
+    Stats lastStats_;
+
+    /**
+     * @brief Recompute the cell grid for the current LED layout
+     * @return true if a grid is available
+     */
+    bool layoutGrid();
+
+    /**
+     * @brief Invalidate cells [col0, col1] on a row
+     */
+    void invalidateSpan(int row, int col0, int col1);
+
+    /**
+     * @brief Draw the cells that intersect the current clip area
+     */
+    void draw(lv_event_t* e);
+
+    void rollWindow(unsigned long now);
+    void freeCells();
+    void cleanup();
+
+    static void drawEvent(lv_event_t* e);
+};
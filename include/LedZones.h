@@ -0,0 +1,127 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "EffectState.h"
+
+/**
+ * @brief Named strip ranges, each running its own effect
+ *
+ * A zone is a run of whole strips (e.g. "bar" = strips 0-1, "ceiling" =
+ * strips 2-9) with its own effect, brightness and audio mapping. Strips
+ * outside every zone keep the main effect / colour. LEDManager renders
+ * each zone through a view of just its strips, and the effects keep to the
+ * strips they are given, so an effect never writes outside its zone.
+ * Zones with EFFECT_OFF stay dark and cost nothing.
+ *
+ * Definitions are stored compactly as one "zones" blob in the led-config
+ * namespace. Zones that don't fit the current layout are kept but not
+ * rendered.
+ *
+ * request() is safe from any task; the main loop picks the new set up
+ * with applyPending().
+ */
+class LedZones {
+public:
+    static const uint8_t MAX_ZONES = 4;
+    static const uint8_t NAME_LENGTH = 12;      ///< Including the terminator
+    static const uint8_t EFFECT_OFF = 0xFF;     ///< Idle zone - dark, skipped
+    static const uint8_t AUDIO_SPREAD = 0xFF;   ///< Bands spread across the zone's strips
+
+    /**
+     * @brief One zone, stored as is (17 bytes)
+     */
+    struct Zone {
+        char name[NAME_LENGTH];
+        uint8_t firstStrip;
+        uint8_t stripCount;
+        uint8_t effect;         ///< LEDManager::AnimationType or EFFECT_OFF
+        uint8_t brightness;     ///< Scales the zone under the global brightness
+        uint8_t audioBand;      ///< 0-6: every strip follows this band, or AUDIO_SPREAD
+    };
+
+    /**
+     * @brief Per-zone effect timing and state
+     */
+    struct ZoneState {
+        unsigned long lastUpdate;
+        EffectState effect;
+    };
+
+    /**
+     * @brief Strips left to the main effect
+     */
+    struct Run {
+        uint8_t firstStrip;
+        uint8_t stripCount;
+    };
+
+    LedZones();
+
+    LedZones(const LedZones&) = delete;
+    LedZones& operator=(const LedZones&) = delete;
+
+    /**
+     * @brief Read the saved zones (applied by the next applyPending())
+     */
+    void load();
+
+    /**
+     * @brief Replace the zones, save them and queue them for the main loop
+     *
+     * Zones must have at least one strip, a NUL-terminated name and must
+     * not overlap. Effects are checked by the caller.
+     * @return false if the set is invalid or can't be saved
+     */
+    bool request(const Zone* zones, uint8_t count);
+
+    /**
+     * @brief Take a pending zone set, or re-fit the zones to a new layout
+     * @param numStrips Strips in the current layout
+     * @param force Rebuild even without a pending set (layout changed)
+     * @return true if the active zones changed
+     */
+    bool applyPending(int numStrips, bool force = false);
+
+    /**
+     * @brief The saved definitions (what the web UI edits)
+     */
+    uint8_t getDefinedCount() const { return definedCount_; }
+    const Zone& getDefined(uint8_t index) const { return defined_[index]; }
+
+    /**
+     * @brief Zones rendered in the current layout
+     */
+    uint8_t getCount() const { return count_; }
+    const Zone& getZone(uint8_t index) const { return zones_[index]; }
+    ZoneState& getState(uint8_t index) { return states_[index]; }
+
+    uint8_t getRunCount() const { return runCount_; }
+    const Run& getRun(uint8_t index) const { return runs_[index]; }
+    EffectState& getRunState(uint8_t index) { return runStates_[index]; }
+
+    /**
+     * @brief True if any active zone is dimmed (output stage has work)
+     */
+    bool hasBrightness() const { return dimmed_; }
+
+private:
+    static const uint8_t STORE_VERSION = 1;
+
+    // Saved definitions, and a set waiting for the main loop
+    Zone defined_[MAX_ZONES];
+    uint8_t definedCount_;
+    bool pending_;
+    portMUX_TYPE mux_;
+
+    // Main loop only
+    Zone zones_[MAX_ZONES];
+    ZoneState states_[MAX_ZONES];
+    uint8_t count_;
+    Run runs_[MAX_ZONES + 1];
+    EffectState runStates_[MAX_ZONES + 1];  ///< The main effect's state on each run
+    uint8_t runCount_;
+    bool dimmed_;
+
+    static bool validate(const Zone* zones, uint8_t count);
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+/**
+ * @brief Timing histograms for the main loop hot paths, served at /metrics
+ *
+ * Sections are timed with the CPU cycle counter and counted into fixed
+ * buckets (BUCKET_BOUNDS_US, plus +Inf) - no allocation, a few compares
+ * per observation. Everything timed runs on the main loop task; the
+ * exporter reads from the AsyncTCP task and may see a count one
+ * observation ahead of its buckets, which Prometheus tolerates.
+ *
+ * Instrument with the macros below. Built with METRICS_ENABLED=0 they
+ * expand to nothing (arguments included) and g_metrics doesn't exist.
+ *
+ * The class has no Arduino dependency beyond the cycle counter, so it
+ * also builds for the host (steady_clock stands in, 1 "cycle" = 1 ns).
+ */
+#ifndef METRICS_ENABLED
+#define METRICS_ENABLED 1
+#endif
+
+#if METRICS_ENABLED
+
+class Metrics {
+public:
+    enum Histogram : uint8_t {
+        LOOP = 0,           ///< Whole loop() pass
+        LED_UPDATE,         ///< LEDManager::update()
+        LED_RENDER,         ///< Effects, zones and layers
+        LED_OUTPUT,         ///< Compositing, overlay, LUT pass and power limit
+        LED_SHOW,           ///< FastLED.show()
+        UI_UPDATE,          ///< UIManager::update()
+        UI_RENDER,          ///< lv_timer_handler() (LVGL draw and input)
+        WEB_UPDATE,         ///< WebUIManager::update() (controls and streams)
+        HISTOGRAM_COUNT
+    };
+
+    enum Gauge : uint8_t {
+        WS_QUEUE_DEPTH = 0, ///< Messages queued across state WebSocket clients
+        GAUGE_COUNT
+    };
+
+    static const uint8_t BUCKET_COUNT = 12;            ///< Last one is +Inf
+    static const uint32_t BUCKET_BOUNDS_US[BUCKET_COUNT - 1];
+
+    struct HistogramData {
+        uint32_t buckets[BUCKET_COUNT];     ///< Not cumulative
+        uint32_t count;
+        uint64_t sumUs;
+    };
+
+    struct GaugeData {
+        uint32_t value;
+        uint32_t peak;      ///< Since boot
+    };
+
+    Metrics();
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    /**
+     * @brief Count a duration measured with cycles()
+     */
+    void observe(Histogram id, uint32_t cycles);
+
+    void setGauge(Gauge id, uint32_t value);
+
+    const HistogramData& getHistogram(uint8_t id) const { return histograms_[id]; }
+    const GaugeData& getGauge(uint8_t id) const { return gauges_[id]; }
+
+    /**
+     * @brief Metric name (without prefix or unit) and help text
+     */
+    static const char* getHistogramName(uint8_t id);
+    static const char* getHistogramHelp(uint8_t id);
+    static const char* getGaugeName(uint8_t id);
+    static const char* getGaugeHelp(uint8_t id);
+
+    static inline uint32_t cycles() {
+#ifdef ARDUINO
+        return ESP.getCycleCount();
+#else
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /**
+     * @brief Times the enclosing block
+     */
+    class Scope {
+    public:
+        explicit Scope(Histogram id) : id_(id), start_(cycles()) {}
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Histogram id_;
+        uint32_t start_;
+    };
+
+private:
+    HistogramData histograms_[HISTOGRAM_COUNT];
+    GaugeData gauges_[GAUGE_COUNT];
+    uint32_t cyclesPerUs_;
+};
+
+extern Metrics g_metrics;
+
+inline Metrics::Scope::~Scope() {
+    g_metrics.observe(id_, cycles() - start_);
+}
+
+#define METRICS_CONCAT_(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_(a, b)
+
+/// Time the rest of the enclosing block
+#define METRICS_SCOPE(id) Metrics::Scope METRICS_CONCAT(metricsScope_, __LINE__)(Metrics::id)
+/// Time a section within a block: METRICS_START(t); ...; METRICS_OBSERVE(ID, t);
+#define METRICS_START(var) uint32_t var = Metrics::cycles()
+#define METRICS_OBSERVE(id, var) g_metrics.observe(Metrics::id, Metrics::cycles() - (var))
+/// value is not evaluated when metrics are compiled out
+#define METRICS_GAUGE(id, value) g_metrics.setGauge(Metrics::id, (value))
+
+#else
+
+#define METRICS_SCOPE(id) do {} while (0)
+#define METRICS_START(var) do {} while (0)
+#define METRICS_OBSERVE(id, var) do {} while (0)
+#define METRICS_GAUGE(id, value) do {} while (0)
+
+#endif
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+class LedOverlay;
+class PowerLimiter;
+
+/**
+ * @brief Final pass from the logical frame to the transmit buffer
+ *
+ * Brightness, gamma, colour correction, per-strip white balance and the
+ * strip's colour order are folded into one set of per-channel lookup
+ * tables, so each pixel costs three table reads on its way to the wire.
+ * The tables are rebuilt only when the level or the settings change
+ * (every frame during a fade, otherwise almost never).
+ *
+ * Table entries are 8.8 fixed point. While the frame rate is high enough
+ * to hide it (DITHER_ON_FPS), the fraction is carried from frame to frame
+ * per pixel and channel (temporal error diffusion), so low brightness
+ * levels keep the gradients that 8-bit output would collapse into steps.
+ * The carried error is one byte per channel, allocated once in begin().
+ *
+ * Overlay pixels go through the same gamma and calibration but at the
+ * overlay's own level instead of the brightness, and are never dithered.
+ *
+ * The same pass publishes the effect frame for the preview/streams and
+ * sums the output channels for the PowerLimiter - the output stage
+ * touches each pixel once. FastLED then sends the buffer as is: the
+ * controller is registered as RGB and shown at full brightness with
+ * dithering off.
+ *
+ * The defaults (linear, no correction, GRB) give the same output as
+ * FastLED's own brightness scaling. Settings are stored as one "output"
+ * blob in the led-config namespace; request() is safe from any task and
+ * is picked up by the next prepare().
+ */
+class OutputStage {
+public:
+    static const uint8_t MAX_CALIBRATIONS = 4;
+    static const uint8_t GAMMA_LINEAR = 10;    ///< Gamma is stored x10
+    static const uint16_t DITHER_ON_FPS = 100;  ///< Dither from this frame rate...
+    static const uint16_t DITHER_OFF_FPS = 80;  ///< ...until it drops below this
+
+    /**
+     * @brief Channel order on the wire
+     */
+    enum ColourOrder : uint8_t {
+        ORDER_RGB = 0,
+        ORDER_RBG,
+        ORDER_GRB,          ///< WS2812B
+        ORDER_GBR,
+        ORDER_BRG,
+        ORDER_BGR,
+        ORDER_COUNT
+    };
+
+    /**
+     * @brief White balance for a range of strips (e.g. a different batch)
+     */
+    struct Calibration {
+        uint8_t firstStrip;
+        uint8_t stripCount;
+        uint8_t balance[3];     ///< Red, green, blue gains, 255 = unchanged
+    };
+
+    /**
+     * @brief Everything the tables are built from, stored as is
+     */
+    struct Settings {
+        uint8_t gamma;          ///< x10: 10 = linear, 22 = typical
+        uint8_t order;          ///< ColourOrder
+        uint8_t correction[3];  ///< Whole-install red, green, blue gains
+        uint8_t calibrationCount;
+        Calibration calibrations[MAX_CALIBRATIONS];
+    };
+
+    struct Stats {
+        uint32_t frames;
+        uint32_t passUs;        ///< Total, output pass without dithering
+        uint32_t ditherFrames;
+        uint32_t ditherUs;      ///< Total, output pass with dithering
+        uint32_t pixels;        ///< Last frame
+        uint32_t rebuilds;
+        uint32_t rebuildUs;     ///< Total, table rebuilds
+        uint16_t fps;           ///< Achieved frame rate (smoothed)
+        bool dithering;
+    };
+
+    OutputStage();
+    ~OutputStage();
+
+    OutputStage(const OutputStage&) = delete;
+    OutputStage& operator=(const OutputStage&) = delete;
+
+    /**
+     * @brief Allocate the dither error buffer
+     * @param capacity Most LEDs any layout will have
+     * @return false if out of memory - output is never dithered
+     */
+    bool begin(int capacity);
+
+    /**
+     * @brief Drop the carried dither error (the LED layout changed)
+     */
+    void clearDither();
+
+    /**
+     * @brief Read the saved settings (applied by the next prepare())
+     */
+    void load();
+
+    /**
+     * @brief Replace the settings, save them and queue them for the main loop
+     * @return false if the settings are invalid or can't be saved
+     */
+    bool request(const Settings& settings);
+
+    /**
+     * @brief The saved settings (what the API edits)
+     */
+    Settings getSettings() const;
+
+    /**
+     * @brief Take pending settings and bring the tables up to date
+     * @param level Brightness the next frame is shown at
+     */
+    void prepare(uint8_t level);
+
+    /**
+     * @brief Map a frame into the transmit buffer
+     * @param out Transmit buffer, in wire order
+     * @param frame Logical frame, not modified
+     * @param publish If set, frame is also copied here
+     * @param limiter If set, receives the channel sums of each supply
+     * @param overlay If set, the pixels it drew are shown at its level
+     */
+    void render(CRGB* out, const CRGB* frame, CRGB* publish, int numStrips, int ledsPerStrip,
+                PowerLimiter* limiter, const LedOverlay* overlay = nullptr);
+
+    Stats getStats() const { return stats_; }
+
+    static Settings defaults();
+    static const char* getOrderName(uint8_t order);
+
+    /**
+     * @brief Look up a colour order by name ("GRB", ...)
+     * @return ORDER_COUNT if unknown
+     */
+    static ColourOrder parseOrderName(const char* name);
+
+private:
+    static const uint8_t STORE_VERSION = 1;
+
+    /**
+     * @brief Output value per input value (8.8), for each slot on the wire
+     */
+    struct Lut {
+        uint16_t slot[3][256];
+        uint32_t overlay[3];    ///< Overlay level and gain per slot, applied to gammaTable_
+    };
+
+    // Saved settings, and whether the main loop has them yet
+    Settings defined_;
+    bool pending_;
+    mutable portMUX_TYPE mux_;
+
+    // Main loop only
+    Settings settings_;
+    uint16_t gammaTable_[256];  ///< 8.8, 255.0 at full
+    uint8_t gammaBuilt_;        ///< Gamma gammaTable_ holds, 0 = none
+    Lut luts_[MAX_CALIBRATIONS + 1];    ///< [0] for strips without a calibration
+    uint8_t level_;
+    bool stale_;
+    Stats stats_;
+
+    // Temporal dithering
+    uint8_t* error_;            ///< Carried fraction, 3 bytes per pixel
+    int capacity_;
+    unsigned long lastFrameUs_;
+    uint32_t frameIntervalUs_;  ///< Smoothed
+
+    void rebuild(uint8_t level);
+    void updateFrameRate();
+    uint8_t findLut(int strip) const;
+    static bool validate(const Settings& settings);
+};
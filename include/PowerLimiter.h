@@ -0,0 +1,153 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+/**
+ * @brief Keeps the estimated strip current within each supply's budget
+ *
+ * A supply feeds a range of whole strips and has a budget in mA. Every
+ * frame the output stage sums the red, green and blue channels of each
+ * supply's pixels, the limiter estimates the current at the level the
+ * frame will be shown at (FastLED's WS2812 model: per-channel mA at full,
+ * plus idle draw per LED) and scales the supply's pixels down just enough
+ * to fit.
+ *
+ * The sums are handed over by OutputStage::render() as it writes the
+ * transmit buffer, so they see gamma and calibration, and limiting costs
+ * no extra walk over the frame until a supply actually goes over budget.
+ * A single supply feeding every strip is limited through the global
+ * brightness instead.
+ *
+ * With no supplies configured the limiter is off. Definitions are stored
+ * as one "power" blob in the led-config namespace; request() is safe from
+ * any task, the main loop picks the new set up with applyPending().
+ */
+class PowerLimiter {
+public:
+    static const uint8_t MAX_SUPPLIES = 4;
+
+    // Estimate model, mA (matches FastLED's power_mgt defaults at 5 V)
+    static const uint8_t RED_MA = 16;       ///< Red channel at full
+    static const uint8_t GREEN_MA = 11;
+    static const uint8_t BLUE_MA = 15;
+    static const uint8_t IDLE_MA = 1;       ///< Per LED, even when dark
+
+    /**
+     * @brief One supply, stored as is (4 bytes)
+     */
+    struct Supply {
+        uint8_t firstStrip;
+        uint8_t stripCount;
+        uint16_t budgetMa;
+    };
+
+    /**
+     * @brief Per-supply telemetry (since the supplies were last set)
+     */
+    struct SupplyStats {
+        uint32_t estimatedMa;       ///< Last frame, before limiting
+        uint32_t peakMa;            ///< Highest estimate, before limiting
+        uint8_t scale;              ///< Last frame's scale, 255 = within budget
+        uint32_t throttledFrames;
+        uint32_t throttleEvents;    ///< Times the supply went over budget
+    };
+
+    PowerLimiter();
+
+    PowerLimiter(const PowerLimiter&) = delete;
+    PowerLimiter& operator=(const PowerLimiter&) = delete;
+
+    /**
+     * @brief Read the saved supplies (applied by the next applyPending())
+     */
+    void load();
+
+    /**
+     * @brief Replace the supplies, save them and queue them for the main loop
+     *
+     * Supplies must have at least one strip and a non-zero budget, and must
+     * not overlap. 0 supplies turns limiting off.
+     * @return false if the set is invalid or can't be saved
+     */
+    bool request(const Supply* supplies, uint8_t count);
+
+    /**
+     * @brief Take a pending supply set - call at the start of a frame
+     */
+    void applyPending();
+
+    bool isEnabled() const { return count_ > 0; }
+
+    /**
+     * @brief Start a frame's sums
+     */
+    void beginFrame();
+
+    /**
+     * @brief Supply feeding a strip
+     * @return Supply index, or -1 if the strip isn't on a supply
+     */
+    int findSupply(int strip) const;
+
+    /**
+     * @brief Add one strip's channel sums to its supply
+     */
+    void addStrip(int supply, uint32_t red, uint32_t green, uint32_t blue, uint32_t pixels);
+
+    /**
+     * @brief Bring every supply within budget
+     *
+     * Uses the sums added since beginFrame().
+     * Supplies over budget have their pixels in frame scaled down.
+     * @param level Brightness the frame will be shown at
+     * @return Brightness to show the frame at - level, unless one supply
+     *         feeds every strip and is throttled
+     */
+    uint8_t limit(CRGB* frame, int numStrips, int ledsPerStrip, uint8_t level);
+
+    /**
+     * @brief The saved supplies (what the API edits)
+     */
+    uint8_t getDefinedCount() const { return definedCount_; }
+    const Supply& getDefined(uint8_t index) const { return defined_[index]; }
+
+    /**
+     * @brief Supplies in use and their figures
+     */
+    uint8_t getCount() const { return count_; }
+    const Supply& getSupply(uint8_t index) const { return supplies_[index]; }
+    const SupplyStats& getStats(uint8_t index) const { return stats_[index]; }
+
+    /**
+     * @brief Average time limiting a frame
+     */
+    uint32_t getAverageUs() const { return frames_ ? totalUs_ / frames_ : 0; }
+
+private:
+    static const uint8_t STORE_VERSION = 1;
+
+    // Saved definitions, and a set waiting for the main loop
+    Supply defined_[MAX_SUPPLIES];
+    uint8_t definedCount_;
+    bool pending_;
+    portMUX_TYPE mux_;
+
+    // Main loop only
+    Supply supplies_[MAX_SUPPLIES];
+    SupplyStats stats_[MAX_SUPPLIES];
+    uint8_t count_;
+
+    // This frame's channel sums per supply
+    struct Sums {
+        uint32_t red;
+        uint32_t green;
+        uint32_t blue;
+        uint32_t pixels;
+    };
+    Sums sums_[MAX_SUPPLIES];
+    uint32_t frames_;
+    uint32_t totalUs_;
+
+    static bool validate(const Supply* supplies, uint8_t count);
+};
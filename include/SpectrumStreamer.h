@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+
+#include "AudioSnapshot.h"
+#include "ControlProtocol.h"
+
+/**
+ * @brief Streams audio band levels to subscribed WebSocket clients
+ *
+ * Clients subscribe to the "spectrum" topic with a rate in Hz (max 60).
+ * Each message is a MSG_SPECTRUM frame (see ControlProtocol) built once from
+ * g_audioSnapshot and shared by every client due at that moment; a client
+ * never gets the same audio sequence twice.
+ *
+ * Backpressure is per client: when a client's send queue is full its
+ * interval is doubled (up to MAX_INTERVAL_MS), and after RECOVER_AFTER clean
+ * sends it steps back towards the requested rate. Readings are never queued
+ * - a skipped client simply gets the latest levels next time.
+ *
+ * subscribe()/removeClient() may be called from the WebSocket event handler;
+ * everything else runs from update() on the main loop.
+ */
+class SpectrumStreamer {
+public:
+    /**
+     * @brief Stream telemetry (totals since boot)
+     */
+    struct Stats {
+        uint8_t subscribers;
+        uint8_t throttled;          ///< Subscribers currently below their requested rate
+        uint32_t messagesSent;
+        uint32_t bytesSent;
+        uint32_t skipped;           ///< Sends skipped because a client queue was full
+        uint32_t backoffs;          ///< Times a client's rate was halved
+    };
+
+    static const uint8_t MAX_SUBSCRIBERS = 4;
+    static const uint8_t MAX_HZ = 60;
+    static const uint8_t DEFAULT_HZ = 30;
+    static const size_t MESSAGE_SIZE = ControlProtocol::SPECTRUM_HEADER_SIZE + AudioSnapshot::NUM_BANDS * 2;
+
+    explicit SpectrumStreamer(AsyncWebSocket* webSocket);
+
+    SpectrumStreamer(const SpectrumStreamer&) = delete;
+    SpectrumStreamer& operator=(const SpectrumStreamer&) = delete;
+
+    /**
+     * @brief Subscribe, change rate or (hz 0) unsubscribe a client
+     * @return false if all subscriber slots are taken
+     */
+    bool subscribe(uint32_t clientId, uint8_t hz);
+
+    /**
+     * @brief Drop a disconnected client's subscription
+     */
+    void removeClient(uint32_t clientId);
+
+    /**
+     * @brief Send due spectrum messages (call from the main loop)
+     */
+    void update();
+
+    Stats getStats() const;
+
+private:
+    static const uint16_t MAX_INTERVAL_MS = 500;   ///< Slowest backed-off rate (2 Hz)
+    static const uint8_t RECOVER_AFTER = 30;       ///< Clean sends before speeding up again
+
+    struct Subscriber {
+        uint32_t id;            ///< 0 = free slot
+        uint8_t hz;
+        bool changed;           ///< hz changed by subscribe()
+        // Main loop only
+        uint16_t minIntervalMs; ///< Requested rate
+        uint16_t intervalMs;    ///< Current rate after backoff
+        uint8_t cleanSends;
+        uint32_t lastSeq;
+        unsigned long lastSent;
+    };
+
+    AsyncWebSocket* webSocket_;
+    Subscriber subscribers_[MAX_SUBSCRIBERS];
+    portMUX_TYPE mux_;
+
+    Stats stats_;
+
+    void applySubscriptionChanges();
+    size_t encode(const AudioSnapshot::Levels& levels, uint8_t* message);
+};
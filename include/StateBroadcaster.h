@@ -0,0 +1,167 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+
+#include "JsonArena.h"
+
+#ifndef DEFAULT_MAX_WS_CLIENTS
+#define DEFAULT_MAX_WS_CLIENTS 8
+#endif
+
+/**
+ * @brief Coalescing, delta-based control state broadcaster for WebSocket clients
+ *
+ * notifyClients() only marks the state as pending. update() (main loop)
+ * snapshots the controls at most once per interval, diffs them against the
+ * last snapshot sent and broadcasts a "states" message containing only the
+ * controls that changed - the web UI already applies controls individually.
+ *
+ * Clients whose send queue is full are skipped; the superseded delta is
+ * dropped and the client gets a full state once its queue has drained.
+ *
+ * Messages are built in a JsonArena and serialized once into a shared
+ * buffer that every recipient's send queue references, so a broadcast
+ * costs one allocation however many clients receive it. The full state
+ * is cached until a control changes, so connect replies and resyncs
+ * reuse it.
+ */
+class StateBroadcaster {
+public:
+    /**
+     * @brief Control fields (bitmask)
+     */
+    enum Field : uint8_t {
+        FIELD_VU         = 1 << 0,
+        FIELD_WHITE      = 1 << 1,
+        FIELD_ANIMATION  = 1 << 2,
+        FIELD_COLOUR     = 1 << 3,
+        FIELD_BRIGHTNESS = 1 << 4,
+        FIELD_ALL        = 0x1F
+    };
+
+    /**
+     * @brief Broadcast telemetry (totals since boot)
+     */
+    struct Stats {
+        uint32_t intervalMs;
+        uint32_t notifications;     ///< notifyClients() calls
+        uint32_t coalesced;         ///< Notifications folded into another message
+        uint32_t unchanged;         ///< Flushes where nothing had actually changed
+        uint32_t messagesSent;      ///< Per-client messages queued
+        uint32_t bytesSent;
+        uint32_t bytesSaved;        ///< vs. one full state per notification per client
+        uint32_t dropped;           ///< Deltas skipped for backed-up clients
+        uint32_t resyncs;           ///< Full states sent (connect replies and recoveries)
+        uint32_t serialized;        ///< Messages serialized (one per broadcast, not per client)
+        uint32_t serializeFailures; ///< Messages dropped for lack of memory
+        uint8_t clients;
+    };
+
+    static const uint32_t DEFAULT_INTERVAL_MS = 50;
+
+    explicit StateBroadcaster(AsyncWebSocket* webSocket);
+
+    StateBroadcaster(const StateBroadcaster&) = delete;
+    StateBroadcaster& operator=(const StateBroadcaster&) = delete;
+
+    /**
+     * @brief Load the broadcast interval from preferences
+     */
+    void begin();
+
+    /**
+     * @brief Mark the state as changed (cheap - safe from any context)
+     */
+    void markDirty();
+
+    /**
+     * @brief Send pending deltas and resyncs (call from the main loop)
+     */
+    void update();
+
+    /**
+     * @brief Track a newly connected client
+     */
+    void addClient(uint32_t clientId);
+
+    /**
+     * @brief Stop tracking a disconnected client
+     */
+    void removeClient(uint32_t clientId);
+
+    /**
+     * @brief Send the full state to one client from the next update()
+     * Safe from the WebSocket event handler
+     */
+    void requestFullState(uint32_t clientId);
+
+    /**
+     * @brief Set and persist the minimum time between broadcasts
+     */
+    void setInterval(uint32_t intervalMs);
+
+    Stats getStats() const;
+
+    /**
+     * @brief Messages waiting in the send queues of every tracked client
+     * Call from the main loop
+     */
+    uint32_t getQueueDepth();
+
+    JsonArena::Stats getArenaStats() const { return arena_.getStats(); }
+
+    /**
+     * @brief Serialize a document into a buffer the WebSocket library shares
+     * between the send queues of every client it is passed to
+     * @return nullptr if the buffer could not be allocated
+     */
+    static AsyncWebSocketSharedBuffer serialize(const JsonDocument& doc);
+
+private:
+    struct Snapshot {
+        bool vu;
+        bool white;
+        bool animation;
+        int animationIndex;
+        char colour[8];     ///< "#RRGGBB"
+        uint8_t brightness;
+    };
+
+    struct ClientSlot {
+        uint32_t id;
+        bool needsResync;
+    };
+
+    AsyncWebSocket* webSocket_;
+    uint32_t intervalMs_;
+    unsigned long lastFlush_;
+
+    volatile bool pending_;
+    volatile uint32_t pendingNotifications_;
+
+    Snapshot lastSent_;
+    bool haveLastSent_;
+    size_t fullMessageBytes_;   ///< Size of the last full state (for bytesSaved)
+
+    ClientSlot clients_[DEFAULT_MAX_WS_CLIENTS];
+    uint8_t clientCount_;
+    portMUX_TYPE mux_;
+
+    Stats stats_;
+
+    JsonArena arena_;                       ///< Main loop only
+    AsyncWebSocketSharedBuffer fullState_;  ///< Cached full state
+    Snapshot fullStateSnapshot_;
+
+    void captureSnapshot(Snapshot& snapshot) const;
+    uint8_t diff(const Snapshot& a, const Snapshot& b) const;
+    void appendControls(JsonArray controls, const Snapshot& snapshot, uint8_t fields) const;
+    void sendResyncs();
+    void setNeedsResync(uint32_t clientId, bool needsResync);
+    AsyncWebSocketSharedBuffer serializeState(const Snapshot& snapshot, uint8_t fields);
+    AsyncWebSocketSharedBuffer getFullState(const Snapshot& current);
+    bool sendBuffer(AsyncWebSocketClient* client, const AsyncWebSocketSharedBuffer& message);
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+#include <esp_partition.h>
+
+#include "AssetBundle.h"
+
+/**
+ * @brief Serves the pre-compressed web UI files
+ *
+ * scripts/build_web_assets.py gzips every file in data/ and describes each
+ * with its content type, a content hash and sizes. The files come from one
+ * of two places:
+ *  - the "assets" flash partition (AssetBundle), mapped into the address
+ *    space and sent straight from flash - no file system, no read buffers
+ *  - otherwise the .gz files and /assets.json manifest on LittleFS
+ *
+ * LittleFS is what uploadfs and a filesystem update through /update write,
+ * so its manifest decides: the bundle is used only while its build id
+ * matches the manifest's, and a stale one is skipped with a warning.
+ *
+ * Responses carry Content-Encoding: gzip and the hash as a strong ETag; a
+ * matching If-None-Match is answered with 304 without touching the body.
+ *
+ * HTML is sent with Cache-Control: no-cache (revalidated on every load).
+ * Everything else is referenced with a ?v=<hash> suffix, so it is marked
+ * immutable for a year.
+ *
+ * Without either (a filesystem image built from plain data/) begin()
+ * returns false and the caller keeps serving files as they are.
+ */
+class StaticAssets {
+public:
+    static const uint8_t MAX_ASSETS = 16;
+
+    /**
+     * @brief Serving telemetry (totals since boot)
+     */
+    struct Stats {
+        uint8_t assets;
+        bool mapped;                ///< Served from the flash partition
+        uint32_t requests;
+        uint32_t notModified;       ///< Answered with 304
+        uint32_t bytesSent;         ///< Compressed bodies sent
+        uint32_t bytesRaw;          ///< What the same requests cost uncompressed, without 304s
+        uint32_t handlerUs;         ///< Time spent in the request handlers
+    };
+
+    StaticAssets();
+    ~StaticAssets();
+
+    StaticAssets(const StaticAssets&) = delete;
+    StaticAssets& operator=(const StaticAssets&) = delete;
+
+    /**
+     * @brief Load the LittleFS manifest, and map the asset partition if it
+     *        holds the same build
+     * @return false if there are no usable assets
+     */
+    bool begin(fs::FS& fs);
+
+    /**
+     * @brief Add a GET route for every asset, plus / for index.html
+     */
+    void registerRoutes(AsyncWebServer* server);
+
+    /**
+     * @brief Send an asset by path (also used by routes that serve a page)
+     * @return false if the path isn't in the manifest - nothing was sent
+     */
+    bool send(AsyncWebServerRequest* request, const char* path);
+
+    bool isLoaded() const { return count_ > 0; }
+
+    Stats getStats() const;
+
+private:
+    static const char MANIFEST_PATH[];
+    static const char PARTITION_LABEL[];
+
+    struct Asset {
+        char path[32];
+        char type[24];
+        char etag[20];          ///< Quoted, ready for the header
+        uint32_t size;
+        uint32_t gzSize;
+        bool immutable;
+        const uint8_t* data;    ///< Gzipped body in mapped flash, or nullptr (LittleFS)
+    };
+
+    fs::FS* fs_;
+    AssetBundle::Reader bundle_;
+    spi_flash_mmap_handle_t mapHandle_;
+    bool mapped_;
+    Asset assets_[MAX_ASSETS];
+    uint8_t count_;
+    Stats stats_;
+
+    bool mapPartition(uint32_t build);
+    bool loadManifest(uint32_t& build);
+    const Asset* find(const char* path) const;
+    void sendAsset(AsyncWebServerRequest* request, const Asset& asset);
+};
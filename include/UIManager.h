@@ -10,6 +10,7 @@
 #include "WhiteButton.h"
 #include "VuButton.h"
 #include "VuGraph.h"
+#include "LedPreview.h"
 
 /**
  * @brief Modern C++ class for managing the entire LVGL UI system
@@ -29,6 +30,32 @@
  */
 class UIManager {
 public:
+    /**
+     * @brief Display power/refresh state driven by touch interaction
+     */
+    enum class DisplayState {
+        ACTIVE,     ///< Touch or drag in progress - boosted refresh
+        IDLE,       ///< No recent touch - throttled refresh
+        DIMMED,     ///< Idle past dim timeout - backlight dimmed
+        SUSPENDED   ///< Idle past suspend timeout - backlight off, LVGL stopped
+    };
+
+    /**
+     * @brief Display policy telemetry
+     */
+    struct DisplayStats {
+        DisplayState state;
+        uint32_t refreshPeriodMs;   ///< Current LVGL refresh timer period
+        uint32_t uiBusyUs;          ///< Time spent in update() over the last second
+        uint32_t baselineBusyUs;    ///< Typical update() cost per second while rendering
+        uint32_t freedUs;           ///< CPU per second handed back to the LED path
+        uint32_t suspendedMs;       ///< Total time spent suspended
+        uint32_t wakeCount;         ///< Number of wakes from dimmed/suspended
+        uint32_t dimTimeoutMs;
+        uint32_t suspendTimeoutMs;
+        uint32_t styleToggleUs;     ///< Measured cost of one state toggle (style re-resolve) at boot
+    };
+
     /**
      * @brief Default constructor
      */
@@ -153,6 +180,33 @@ public:
      */
     VuGraph* getVuGraph() const { return vuGraph_.get(); }
 
+    /**
+     * @brief Get the LED preview instance (nullptr until the LEDs tab is opened)
+     */
+    LedPreview* getLedPreview() const { return ledPreview_.get(); }
+
+    /**
+     * @brief Configure idle timeouts (0 disables the stage) and persist them
+     * @param dimMs Idle time before the backlight is dimmed
+     * @param suspendMs Idle time before the backlight is blanked and LVGL suspended
+     */
+    void setIdleTimeouts(uint32_t dimMs, uint32_t suspendMs);
+
+    /**
+     * @brief Wake the display from dimmed/suspended state
+     */
+    void wakeDisplay();
+
+    /**
+     * @brief Get display policy telemetry
+     */
+    DisplayStats getDisplayStats() const;
+
+    /**
+     * @brief Get display state name for telemetry
+     */
+    static const char* getDisplayStateName(DisplayState state);
+
     /**
      * @brief Show OTA update screen
      */
@@ -185,17 +239,6 @@ public:
     static lv_obj_t* createSectionLabel(lv_obj_t* parent, const char* text);
 
 private:
-    // Shared styles (initialized once)
-    static lv_style_t stylePanelMain_;
-    static lv_style_t stylePanelInset_;
-    static lv_style_t styleSectionLabel_;
-    static bool stylesInitialized_;
-
-    /**
-     * @brief Initialize shared styles (called once)
-     */
-    static void initStyles();
-
     // UI component instances using smart pointers
     std::unique_ptr<BrightnessSlider> brightnessSlider_;
     std::unique_ptr<ColourWheel> colourWheel_;
@@ -203,11 +246,28 @@ private:
     std::unique_ptr<WhiteButton> whiteButton_;
     std::unique_ptr<VuButton> vuButton_;
     std::unique_ptr<VuGraph> vuGraph_;
+    std::unique_ptr<LedPreview> ledPreview_;
+
+    /**
+     * @brief Tab indices in the tabview
+     */
+    enum TabIndex {
+        TAB_COLOUR = 0,
+        TAB_VU,
+        TAB_LEDS,
+        TAB_COUNT
+    };
 
     // LVGL objects
     lv_obj_t* tabview_;
     lv_obj_t* tab1_;  // Colour tab
     lv_obj_t* tab2_;  // VU tab
+    lv_obj_t* tab3_;  // LED preview tab
+
+    // Lazy tab construction - contents are built the first time a tab is shown
+    bool tabBuilt_[TAB_COUNT];
+    unsigned long tabHiddenSince_[TAB_COUNT];
+    uint32_t tabReleaseMs_;     ///< Hidden time before releasable tabs are destroyed (0 = never)
 
     // OTA screen objects
     lv_obj_t* otaScreen_;
@@ -220,6 +280,62 @@ private:
     bool initialized_;
     bool screenInitialized_;
 
+    // Display refresh / idle policy
+    lv_display_t* display_;
+    lv_indev_t* indev_;
+    DisplayState displayState_;
+    uint32_t refreshPeriodMs_;
+    uint32_t dimTimeoutMs_;
+    uint32_t suspendTimeoutMs_;
+    uint8_t backlightLevel_;
+    unsigned long suspendedSince_;
+    unsigned long lastTouchPoll_;
+    uint32_t suspendedMs_;
+    uint32_t wakeCount_;
+
+    // CPU accounting for update() (1 second windows)
+    unsigned long busyWindowStart_;
+    uint32_t busyAccumUs_;
+    uint32_t busyLastUs_;
+    uint32_t busyBaselineUs_;
+    uint32_t styleToggleUs_;
+
+    static const uint32_t REFRESH_ACTIVE_MS = 16;
+    static const uint32_t REFRESH_NORMAL_MS = LV_DEF_REFR_PERIOD;
+    static const uint32_t REFRESH_IDLE_MS = 100;
+    static const uint32_t IDLE_THROTTLE_MS = 3000;
+    static const uint32_t SUSPENDED_TOUCH_POLL_MS = 50;
+    static const uint32_t DEFAULT_DIM_TIMEOUT_MS = 60000;
+    static const uint32_t DEFAULT_SUSPEND_TIMEOUT_MS = 300000;
+    static const uint8_t DIM_BACKLIGHT_LEVEL = 24;
+    static const uint32_t DEFAULT_TAB_RELEASE_MS = 0;
+
+    /**
+     * @brief Load idle timeouts from preferences
+     */
+    void loadDisplayConfig();
+
+    /**
+     * @brief Pick refresh rate / backlight / suspend state from touch activity
+     * @param now Current time in ms
+     */
+    void updateDisplayPolicy(unsigned long now);
+
+    /**
+     * @brief Apply a refresh period to the display and touch read timers
+     */
+    void setRefreshPeriod(uint32_t periodMs);
+
+    /**
+     * @brief Accumulate update() cost into the current 1 second window
+     */
+    void accountBusyTime(unsigned long now, uint32_t busyUs);
+
+    /**
+     * @brief Time a state toggle on the effects dropdown (style re-resolve cost)
+     */
+    void measureStyleToggle();
+
     /**
      * @brief Apply the synth theme to the screen
      */
@@ -231,10 +347,44 @@ private:
     bool createTabview();
 
     /**
-     * @brief Initialize all UI components
+     * @brief Initialize the always-visible components (colour tab) and audio sampling
      */
     bool initializeComponents();
 
+    /**
+     * @brief Build the contents of a tab if not built yet
+     * @param tab Tab index
+     * @return true if the tab contents exist after the call
+     */
+    bool buildTab(int tab);
+
+    /**
+     * @brief Destroy the contents of a releasable tab
+     * @param tab Tab index
+     */
+    void releaseTab(int tab);
+
+    /**
+     * @brief Build the active tab on first view and release tabs hidden for too long
+     * @param now Current time in ms
+     */
+    void updateLazyTabs(unsigned long now);
+
+    /**
+     * @brief Create the colour tab widgets (fader, VU button, wheel, white, effects)
+     */
+    bool buildColourTab();
+
+    /**
+     * @brief Create the VU tab widgets (bar graph)
+     */
+    bool buildVuTab();
+
+    /**
+     * @brief Create the LED preview tab widgets
+     */
+    bool buildLedsTab();
+
     /**
      * @brief Setup display driver
      */
@@ -0,0 +1,83 @@
+/**
+ * @file UIStyles.h
+ *
+ * Shared constant LVGL styles for the synth theme.
+ *
+ * The property tables are `const` and live in flash (.rodata); widgets
+ * reference them with lv_obj_add_style() instead of copying the theme into
+ * per-object local styles. Visual state changes (checked, pressed, active,
+ * lit VU segments) are selected by LVGL states so toggling a state only
+ * re-resolves styles and never allocates.
+ *
+ * State conventions:
+ * - LV_STATE_CHECKED  - button on / VU segment lit
+ * - LV_STATE_PRESSED  - finger down
+ * - LV_STATE_USER_1   - effects dropdown active (CHECKED is used by the dropdown while open)
+ * - LV_STATE_USER_1..3 - VU peak indicator zone (green / yellow / red)
+ */
+
+#ifndef UI_STYLES_H
+#define UI_STYLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+/** Effects dropdown "animation running" state */
+#define UI_STATE_ACTIVE         LV_STATE_USER_1
+
+/** VU peak indicator zone states */
+#define UI_STATE_PEAK_GREEN     LV_STATE_USER_1
+#define UI_STATE_PEAK_YELLOW    LV_STATE_USER_2
+#define UI_STATE_PEAK_RED       LV_STATE_USER_3
+#define UI_STATE_PEAK_ANY       (LV_STATE_USER_1 | LV_STATE_USER_2 | LV_STATE_USER_3)
+
+/* Containers */
+extern const lv_style_t ui_style_panel_main;
+extern const lv_style_t ui_style_panel_inset;
+extern const lv_style_t ui_style_section_label;
+extern const lv_style_t ui_style_container_clear;   /**< Transparent, borderless, no padding */
+
+/* Tabview */
+extern const lv_style_t ui_style_tabview;
+extern const lv_style_t ui_style_tab_page;
+extern const lv_style_t ui_style_tab_bar;
+extern const lv_style_t ui_style_tab_button;
+extern const lv_style_t ui_style_tab_button_checked;
+
+/* Hardware-style buttons (VU, WHITE, effects dropdown) */
+extern const lv_style_t ui_style_button;
+extern const lv_style_t ui_style_button_checked;     /**< Cyan "on" look */
+extern const lv_style_t ui_style_button_pressed;
+extern const lv_style_t ui_style_button_white_checked;
+extern const lv_style_t ui_style_button_white_pressed;
+
+/* Effects dropdown */
+extern const lv_style_t ui_style_dropdown;
+extern const lv_style_t ui_style_dropdown_pressed;
+extern const lv_style_t ui_style_dropdown_list;
+extern const lv_style_t ui_style_dropdown_list_selected;
+
+/* Brightness fader */
+extern const lv_style_t ui_style_slider_track;
+extern const lv_style_t ui_style_slider_indicator;
+extern const lv_style_t ui_style_slider_knob;
+
+/* VU graph */
+extern const lv_style_t ui_style_vu_segment;
+extern const lv_style_t ui_style_vu_segment_green;
+extern const lv_style_t ui_style_vu_segment_green_lit;
+extern const lv_style_t ui_style_vu_segment_yellow;
+extern const lv_style_t ui_style_vu_segment_yellow_lit;
+extern const lv_style_t ui_style_vu_segment_red;
+extern const lv_style_t ui_style_vu_segment_red_lit;
+extern const lv_style_t ui_style_vu_peak;
+extern const lv_style_t ui_style_vu_label;
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*UI_STYLES_H*/
@@ -62,11 +62,36 @@ public:
      */
     bool initialize(lv_obj_t* parent);
 
+    /**
+     * @brief Initialize audio sampling only (no LVGL objects)
+     * Widgets can be attached later with createWidgets() when the tab is first shown
+     * @return true if initialization was successful, false otherwise
+     */
+    bool initializeAudio();
+
+    /**
+     * @brief Create the bar/segment widgets on the specified parent
+     * @param parent The parent LVGL object (usually a tab)
+     * @return true if creation was successful, false otherwise
+     */
+    bool createWidgets(lv_obj_t* parent);
+
+    /**
+     * @brief Delete the bar/segment widgets, keeping audio sampling running
+     */
+    void destroyWidgets();
+
+    /**
+     * @brief Check if the bar widgets currently exist
+     */
+    bool hasWidgets() const { return canvas_ != nullptr; }
+
     /**
      * @brief Update the VU meter with new audio data
-     * Should be called regularly to refresh the display
+     * Should be called regularly - audio is always sampled (LED effects depend on it)
+     * @param render Whether to redraw the bars (false while hidden or display suspended)
      */
-    void update();
+    void update(bool render = true);
 
     /**
      * @brief Get the overall audio volume level
@@ -149,10 +174,17 @@ private:
     void createFrequencyLabels();
 
     /**
-     * @brief Get color for a segment based on its position
+     * @brief Get the shared const style for a segment based on its position
      * @param segmentIndex Segment index (0 = bottom, SEGMENTS_PER_BAR-1 = top)
      * @param lit Whether the segment is lit or dim
-     * @return Color for the segment
+     * @return Zone style (dim applied by default, lit applied at LV_STATE_CHECKED)
+     */
+    static const lv_style_t* getSegmentStyle(int segmentIndex, bool lit);
+
+    /**
+     * @brief Get the peak indicator state for a segment position
+     * @param segmentIndex Segment index (0 = bottom, SEGMENTS_PER_BAR-1 = top)
+     * @return One of the UI_STATE_PEAK_* zone states
      */
-    lv_color_t getSegmentColor(int segmentIndex, bool lit);
+    static lv_state_t getPeakState(int segmentIndex);
 };
\ No newline at end of file
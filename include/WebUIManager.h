@@ -10,6 +10,14 @@
 #include <Preferences.h>
 #include <ArduinoJson.h>
 
+#include "StateBroadcaster.h"
+#include "ControlProtocol.h"
+#include "ControlJson.h"
+#include "FrameStreamer.h"
+#include "SpectrumStreamer.h"
+#include "ControlQueue.h"
+#include "StaticAssets.h"
+
 /**
  * @brief Modern C++ Web UI Manager class
  * 
@@ -33,6 +41,15 @@ public:
     WebUIManager(const WebUIManager&) = delete;
     WebUIManager& operator=(const WebUIManager&) = delete;
 
+    /**
+     * @brief Start mounting LittleFS on a background task
+     *
+     * Call early in setup() so the mount (and the format fallback, if the
+     * image is unusable) overlaps display and Wi-Fi init. initialize()
+     * waits for it, or mounts inline if it was never started.
+     */
+    static void startFilesystemMount();
+
     /**
      * @brief Initialize web server and all endpoints
      * @return true if successful, false otherwise
@@ -46,6 +63,7 @@ public:
     
     /**
      * @brief Notify all WebSocket clients with state update
+     * Coalesced - the changed controls are sent from update()
      */
     void notifyClients();
     
@@ -56,16 +74,105 @@ public:
     bool isInitialized() const { return initialized_; }
 
     /**
-     * @brief Get WebSocket instance for external use (e.g., Logger)
+     * @brief WebSocket topics a control client can subscribe to (bitmask)
+     * Log lines have their own socket (see logSocket_), not a topic here
+     */
+    enum Topic : uint8_t {
+        TOPIC_STATE    = 1 << 0,    ///< Control state deltas (default on connect)
+        TOPIC_FRAMES   = 1 << 1,    ///< LED frame stream
+        TOPIC_SPECTRUM = 1 << 2     ///< Audio band levels
+    };
+
+    /**
+     * @brief Per-topic traffic (bytes/s over the last second)
+     */
+    struct TopicStats {
+        uint8_t stateClients;
+        uint32_t stateBytesPerSec;
+        uint8_t frameClients;
+        uint32_t frameBytesPerSec;
+        uint8_t spectrumClients;
+        uint32_t spectrumBytesPerSec;
+        uint8_t logClients;
+    };
+
+    TopicStats getTopicStats() const { return topicStats_; }
+
+    /**
+     * @brief Get the control WebSocket instance
      * @return Pointer to AsyncWebSocket instance
      */
     AsyncWebSocket* getWebSocket() { return &webSocket_; }
 
+    /**
+     * @brief Inbound control message telemetry (totals since boot)
+     */
+    struct ControlStats {
+        uint32_t jsonMessages;
+        uint32_t binaryMessages;
+        uint32_t jsonDecodeUs;      ///< Time spent parsing JSON controls
+        uint32_t binaryDecodeUs;    ///< Time spent decoding binary frames
+        uint32_t rejected;          ///< Malformed or unknown messages
+        uint32_t batches;           ///< Messages carrying more than one control
+    };
+
+    ControlStats getControlStats() const { return controlStats_; }
+
+    /**
+     * @brief Get applied vs. superseded control change counts
+     */
+    ControlQueue::Stats getControlQueueStats() const { return controlQueue_.getStats(); }
+
+    /**
+     * @brief GET/PATCH /api/state telemetry (totals since boot)
+     */
+    struct StateApiStats {
+        uint32_t gets;
+        uint32_t patches;
+        uint32_t rejected;          ///< Malformed bodies or invalid fields
+        uint32_t handlerUs;         ///< Time spent building / decoding
+    };
+
+    StateApiStats getStateApiStats() const { return stateApiStats_; }
+
+    /**
+     * @brief Get WebSocket state broadcast telemetry
+     */
+    StateBroadcaster::Stats getBroadcastStats() const { return broadcaster_.getStats(); }
+
+    /**
+     * @brief Get LED frame stream telemetry
+     */
+    FrameStreamer::Stats getFrameStreamStats() const { return frameStreamer_.getStats(); }
+
+    /**
+     * @brief Get audio spectrum stream telemetry
+     */
+    SpectrumStreamer::Stats getSpectrumStreamStats() const { return spectrumStreamer_.getStats(); }
+
 private:
     // Member variables
     bool initialized_;
     AsyncWebServer* server_;  // Pointer to shared server (from WiFiSetupManager)
-    AsyncWebSocket webSocket_;
+    StaticAssets assets_;           ///< Gzipped web files from the asset manifest
+    AsyncWebSocket webSocket_;      ///< /ws?control=1 - web UI controls and topics
+    AsyncWebSocket logSocket_;      ///< Plain /ws - Logger's live log page
+    volatile uint8_t logClients_;   ///< Logger is only attached while > 0
+    StateBroadcaster broadcaster_;
+    FrameStreamer frameStreamer_;
+    SpectrumStreamer spectrumStreamer_;
+    JsonArena arena_;                           ///< Inbound messages (AsyncTCP task)
+    AsyncWebSocketSharedBuffer animationsMessage_;  ///< Built once, sent on connect
+    ControlStats controlStats_;
+    ControlQueue controlQueue_;                 ///< Decoded controls, applied from update()
+    StateApiStats stateApiStats_;
+
+    // Per-topic rate window
+    TopicStats topicStats_;
+    unsigned long topicWindowStart_;
+    uint32_t stateBytesAtWindow_;
+    uint32_t frameBytesAtWindow_;
+    uint32_t spectrumBytesAtWindow_;
     
     // Private methods
     bool initializeLittleFS();
@@ -74,27 +181,61 @@ private:
     void setupRoutes();
     void setupAPIEndpoints();
     void setupStaticFiles();
+    void sendPage(AsyncWebServerRequest* request, const char* path);
     
     // WebSocket handling
-    void handleWebSocketMessage(void* arg, uint8_t* data, size_t len);
+    void handleWebSocketMessage(AsyncWebSocketClient* client, void* arg, uint8_t* data, size_t len);
+    void handleJsonMessage(AsyncWebSocketClient* client, const uint8_t* data, size_t len);
+    void handleBinaryMessage(const uint8_t* data, size_t len);
     void onWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, 
                          AwsEventType type, void* arg, uint8_t* data, size_t len);
     
     // API response generators
-    String generateAnimationsResponse();
+    AsyncWebSocketSharedBuffer buildAnimationsMessage();
+    String generateTelemetryResponse();
+    String generateBootResponse();
+    String generateMetricsResponse();
+    static void addBootProfile(JsonObject boot);
     String generateStateResponse();
+
+    // REST state API
+    void handleStatePatch(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    void handleLayersPut(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    static bool collectBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                            size_t index, size_t total, size_t maxBody);
+    String generateLayersResponse();
+    void handleZonesPut(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    String generateZonesResponse();
+    void handlePowerPut(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    String generatePowerResponse();
+    static void addPower(JsonObject power);
+    void handleOutputPut(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    String generateOutputResponse();
+    static void addOutputStats(JsonObject output);
+    static void addLayers(JsonArray layers);
     
     // WebSocket message handlers
-    void handleConnectMessage();
-    void handleVuMessage(const JsonDocument& request);
-    void handleWhiteMessage(const JsonDocument& request);
-    void handleBrightnessMessage(const JsonDocument& request);
-    void handleAnimationMessage(const JsonDocument& request);
-    void handleColorMessage(const JsonDocument& request);
+    void handleConnectMessage(AsyncWebSocketClient* client, const JsonDocument& request);
+    void handleFramesMessage(AsyncWebSocketClient* client, const JsonDocument& request);
+    void handleSubscribeMessage(AsyncWebSocketClient* client, const JsonDocument& request);
+    void handleBatchMessage(const JsonDocument& request);
+    void onLogSocketEvent(AsyncWebSocketClient* client, AwsEventType type);
+    void updateTopicStats(unsigned long now);
+    void applyControl(const ControlProtocol::Control& control);
+    void applyPendingControls();
+
+    // Control handlers (shared by the JSON and binary protocols)
+    void handleVu(bool state);
+    void handleWhite(bool state);
+    void handleBrightness(uint8_t value);
+    void handleAnimation(bool runAnimation, int animation);
+    void handleColour(uint8_t r, uint8_t g, uint8_t b);
 
     // Static WebSocket event handler (needed for C-style callback)
     static void staticWebSocketEventHandler(AsyncWebSocket* server, AsyncWebSocketClient* client,
                                           AwsEventType type, void* arg, uint8_t* data, size_t len);
+    static void staticLogSocketEventHandler(AsyncWebSocket* server, AsyncWebSocketClient* client,
+                                          AwsEventType type, void* arg, uint8_t* data, size_t len);
 };
 
 // Forward declaration
@@ -0,0 +1,162 @@
+Import("env")
+import gzip
+import hashlib
+import json
+import os
+import re
+import shutil
+import struct
+
+# Builds the LittleFS image contents from data/ into the build directory:
+#   - every file gzipped (<name>.gz), the uncompressed copy is left out
+#   - local style/script references in HTML get a ?v=<hash> suffix so the
+#     referenced files can be cached forever by the browser
+#   - /assets.json lists path, content type, strong ETag and sizes for
+#     StaticAssets on the device, and a build id over all the ETags
+# buildfs/uploadfs then pack this directory instead of data/.
+#
+# The same files are also packed into assets.bin (see include/AssetBundle.h)
+# for the "assets" partition, which the device serves straight from mapped
+# flash. Flash it with: pio run -t uploadassets. It carries the same build
+# id, and the device only uses it while that matches the file system's
+# manifest - a later uploadfs or filesystem OTA takes over from it.
+
+SOURCE_DIR = env.subst("$PROJECT_DATA_DIR")
+OUTPUT_DIR = os.path.join(env.subst("$BUILD_DIR"), "webdata")
+MANIFEST = "assets.json"
+BUNDLE = os.path.join(env.subst("$BUILD_DIR"), "assets.bin")
+
+BUNDLE_MAGIC = 0x42415549   # "UIAB"
+BUNDLE_VERSION = 2
+BUNDLE_FLAG_IMMUTABLE = 0x01
+HEADER = struct.Struct("<IHHIII")
+ENTRY = struct.Struct("<32s24s16sIIII")
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".json": "application/json",
+    ".svg": "image/svg+xml",
+    ".png": "image/png",
+    ".ico": "image/x-icon",
+}
+
+REFERENCE = re.compile(r'(href|src)="/?([A-Za-z0-9_.-]+\.(?:css|js))"')
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:16]
+
+
+def fnv1a(data):
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def build_id(assets):
+    return fnv1a("".join(asset["etag"] for asset in assets).encode())
+
+
+def build_bundle(assets, blobs):
+    def align(value):
+        return (value + 3) & ~3
+
+    offset = HEADER.size + ENTRY.size * len(assets)
+    index = b""
+    body = b""
+    for asset, blob in zip(assets, blobs):
+        # Path and type must keep a terminating NUL in their fixed fields
+        assert len(asset["path"]) < 32 and len(asset["type"]) < 24, asset["path"]
+        flags = BUNDLE_FLAG_IMMUTABLE if asset["immutable"] else 0
+        index += ENTRY.pack(asset["path"].encode(), asset["type"].encode(), asset["etag"].encode(),
+                            offset + len(body), asset["size"], len(blob), flags)
+        body += blob + b"\0" * (align(len(blob)) - len(blob))
+
+    payload = index + body
+    header = HEADER.pack(BUNDLE_MAGIC, BUNDLE_VERSION, len(assets), HEADER.size + len(payload), fnv1a(payload),
+                         build_id(assets))
+    with open(BUNDLE, "wb") as f:
+        f.write(header + payload)
+    print("[WebAssets] Bundle %s: %d bytes" % (BUNDLE, HEADER.size + len(payload)))
+
+
+def build_web_assets():
+    if os.path.isdir(OUTPUT_DIR):
+        shutil.rmtree(OUTPUT_DIR)
+    os.makedirs(OUTPUT_DIR)
+
+    files = {}
+    for name in sorted(os.listdir(SOURCE_DIR)):
+        path = os.path.join(SOURCE_DIR, name)
+        if os.path.isfile(path) and not name.startswith("."):
+            with open(path, "rb") as f:
+                files[name] = f.read()
+
+    # Hash everything HTML can reference first, then rewrite the references
+    hashes = {name: content_hash(data) for name, data in files.items() if not name.endswith(".html")}
+
+    def versioned(match):
+        name = match.group(2)
+        if name not in hashes:
+            return match.group(0)
+        return '%s="%s?v=%s"' % (match.group(1), name, hashes[name][:8])
+
+    assets = []
+    blobs = []
+    raw_total = 0
+    gz_total = 0
+    for name, data in files.items():
+        extension = os.path.splitext(name)[1]
+        if extension == ".html":
+            data = REFERENCE.sub(versioned, data.decode("utf-8")).encode("utf-8")
+
+        # mtime=0 keeps the image reproducible
+        compressed = gzip.compress(data, compresslevel=9, mtime=0)
+        with open(os.path.join(OUTPUT_DIR, name + ".gz"), "wb") as f:
+            f.write(compressed)
+
+        assets.append({
+            "path": "/" + name,
+            "type": CONTENT_TYPES.get(extension, "application/octet-stream"),
+            "etag": content_hash(data),
+            "size": len(data),
+            "gz": len(compressed),
+            # HTML URLs never change, so it must be revalidated; everything
+            # else is only ever requested through a versioned URL
+            "immutable": extension != ".html",
+        })
+        blobs.append(compressed)
+        raw_total += len(data)
+        gz_total += len(compressed)
+
+    with open(os.path.join(OUTPUT_DIR, MANIFEST), "w") as f:
+        json.dump({"version": 1, "build": "%08x" % build_id(assets), "assets": assets}, f, separators=(",", ":"))
+
+    print("[WebAssets] %d files, %d -> %d bytes gzipped" % (len(assets), raw_total, gz_total))
+    build_bundle(assets, blobs)
+
+
+def assets_partition_offset():
+    partitions = os.path.join(env.subst("$PROJECT_DIR"), env.GetProjectOption("board_build.arduino.partitions", "partitions.csv"))
+    with open(partitions) as f:
+        for line in f:
+            fields = [field.strip() for field in line.split("#")[0].split(",")]
+            if len(fields) >= 5 and fields[0] == "assets":
+                return fields[3]
+    return None
+
+
+build_web_assets()
+env.Replace(PROJECT_DATA_DIR=OUTPUT_DIR)
+
+offset = assets_partition_offset()
+if offset:
+    env.AddCustomTarget(
+        name="uploadassets",
+        dependencies=None,
+        actions=['"$PYTHONEXE" "$UPLOADER" --chip $BOARD_MCU --port "$UPLOAD_PORT" write_flash %s "%s"' % (offset, BUNDLE)],
+        title="Upload web asset bundle",
+        description="Write assets.bin to the assets partition")
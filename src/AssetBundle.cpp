@@ -0,0 +1,77 @@
+#include "AssetBundle.h"
+#include <string.h>
+
+namespace AssetBundle {
+
+uint32_t checksum(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+Reader::Reader()
+    : base_(nullptr)
+    , entries_(nullptr)
+    , count_(0)
+    , build_(0)
+{
+}
+
+bool Reader::open(const uint8_t* base, size_t length) {
+    base_ = nullptr;
+    entries_ = nullptr;
+    count_ = 0;
+    build_ = 0;
+
+    if (!base || length < sizeof(Header)) {
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, base, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION) {
+        return false;
+    }
+
+    size_t indexEnd = sizeof(Header) + (size_t)header.count * sizeof(Entry);
+    if (header.size > length || indexEnd > header.size) {
+        return false;
+    }
+    if (checksum(base + sizeof(Header), header.size - sizeof(Header)) != header.checksum) {
+        return false;
+    }
+
+    const Entry* entries = (const Entry*)(base + sizeof(Header));
+    for (uint16_t i = 0; i < header.count; i++) {
+        const Entry& entry = entries[i];
+        if (memchr(entry.path, '\0', sizeof(entry.path)) == nullptr ||
+            memchr(entry.type, '\0', sizeof(entry.type)) == nullptr ||
+            entry.offset < indexEnd || entry.offset > header.size ||
+            entry.gzSize > header.size - entry.offset) {
+            return false;
+        }
+    }
+
+    base_ = base;
+    entries_ = entries;
+    count_ = header.count;
+    build_ = header.build;
+    return true;
+}
+
+const Entry* Reader::entry(uint16_t index) const {
+    return index < count_ ? &entries_[index] : nullptr;
+}
+
+const Entry* Reader::find(const char* path) const {
+    for (uint16_t i = 0; i < count_; i++) {
+        if (strncmp(entries_[i].path, path, sizeof(entries_[i].path)) == 0) {
+            return &entries_[i];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace AssetBundle
@@ -0,0 +1,56 @@
+#include "AudioSnapshot.h"
+
+AudioSnapshot g_audioSnapshot;
+
+AudioSnapshot::AudioSnapshot()
+    : seq_(0)
+    , levels_()
+{
+    for (int i = 0; i < NUM_BANDS; i++) {
+        peakTimers_[i] = 0;
+    }
+}
+
+void AudioSnapshot::publish(const int* bands, int level) {
+    unsigned long now = millis();
+
+    seq_++;     // Odd: write in progress
+    __sync_synchronize();
+
+    for (int i = 0; i < NUM_BANDS; i++) {
+        uint8_t value = (uint8_t)constrain(bands[i], 0, 255);
+        levels_.bands[i] = value;
+
+        if (value >= levels_.peaks[i]) {
+            levels_.peaks[i] = value;
+            peakTimers_[i] = now;
+        } else if (now - peakTimers_[i] > PEAK_HOLD_MS + PEAK_DECAY_MS) {
+            // Decay one step per interval once the hold has expired
+            uint8_t peak = levels_.peaks[i];
+            peak = (peak > value + PEAK_DECAY_STEP) ? peak - PEAK_DECAY_STEP : value;
+            levels_.peaks[i] = peak;
+            peakTimers_[i] = now - PEAK_HOLD_MS;
+        }
+    }
+    levels_.level = (uint8_t)constrain(level, 0, 255);
+    levels_.seq = (seq_ + 1) >> 1;
+
+    __sync_synchronize();
+    seq_++;     // Even: stable
+}
+
+bool AudioSnapshot::read(Levels& out) const {
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t before = seq_;
+        if (before & 1) {
+            continue;   // Writer mid-update - try again
+        }
+        __sync_synchronize();
+        memcpy(&out, (const void*)&levels_, sizeof(out));
+        __sync_synchronize();
+        if (seq_ == before) {
+            return before != 0;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,88 @@
+#include "BootProfiler.h"
+#include <lvgl.h>
+#include <Logger.h>
+
+// Global boot profiler instance
+BootProfiler g_bootProfiler;
+
+BootProfiler::BootProfiler()
+    : phaseCount_(0)
+    , totalUs_(0)
+    , finished_(false)
+{
+}
+
+int BootProfiler::beginPhase(const char* name) {
+    if (phaseCount_ >= MAX_PHASES) {
+        return -1;
+    }
+
+    Phase& phase = phases_[phaseCount_];
+    phase.name = name;
+    phase.startUs = micros();
+    phase.durationUs = 0;
+    phase.heapFree = 0;
+    phase.lvglUsed = 0;
+    phase.done = false;
+    return phaseCount_++;
+}
+
+void BootProfiler::endPhase(int index) {
+    if (index < 0 || index >= phaseCount_ || phases_[index].done) {
+        return;
+    }
+
+    Phase& phase = phases_[index];
+    phase.durationUs = micros() - phase.startUs;
+    phase.heapFree = ESP.getFreeHeap();
+    phase.lvglUsed = getLvglHeapUsed();
+    phase.done = true;
+}
+
+void BootProfiler::mark(const char* name) {
+    endPhase(beginPhase(name));
+}
+
+void BootProfiler::record(const char* name, uint32_t startUs, uint32_t durationUs) {
+    int index = beginPhase(name);
+    if (index < 0) {
+        return;
+    }
+
+    Phase& phase = phases_[index];
+    phase.startUs = startUs;
+    phase.durationUs = durationUs;
+    phase.heapFree = ESP.getFreeHeap();
+    phase.lvglUsed = getLvglHeapUsed();
+    phase.done = true;
+}
+
+void BootProfiler::finish() {
+    if (finished_) {
+        return;
+    }
+
+    totalUs_ = micros();
+    finished_ = true;
+
+    Logger.info("=== Boot profile (%lu ms total) ===", (unsigned long)(totalUs_ / 1000));
+    for (int i = 0; i < phaseCount_; i++) {
+        const Phase& phase = phases_[i];
+        Logger.info("  %-12s @%6lu ms  %6lu ms  heap %6lu  lvgl %6lu",
+                    phase.name,
+                    (unsigned long)(phase.startUs / 1000),
+                    (unsigned long)(phase.durationUs / 1000),
+                    (unsigned long)phase.heapFree,
+                    (unsigned long)phase.lvglUsed);
+    }
+}
+
+uint32_t BootProfiler::getLvglHeapUsed() {
+    if (!lv_is_initialized()) {
+        return 0;
+    }
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
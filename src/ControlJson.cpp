@@ -0,0 +1,156 @@
+#include "ControlJson.h"
+#include "LEDManager.h"
+#include <ctype.h>
+
+namespace ControlJson {
+
+static_assert(ControlProtocol::ANIMATION_COUNT == LEDManager::CONFETTI + 1,
+              "ControlProtocol::ANIMATION_COUNT must match LEDManager::AnimationType");
+
+static bool decodeAnimationIndex(JsonVariantConst value, uint8_t& index) {
+    // An int in range - 99 is not an animation, and 300 must not wrap to 44
+    if (!value.is<int>()) {
+        return false;
+    }
+    int number = value.as<int>();
+    if (number < 0 || number >= ControlProtocol::ANIMATION_COUNT) {
+        return false;
+    }
+    index = (uint8_t)number;
+    return true;
+}
+
+static uint8_t hexDigit(char c) {
+    return isdigit((unsigned char)c) ? c - '0' : (tolower((unsigned char)c) - 'a' + 10);
+}
+
+bool decodeColour(const char* hexValue, ControlProtocol::Control& control) {
+    if (!hexValue) {
+        return false;
+    }
+    if (*hexValue == '#') {
+        hexValue++;
+    }
+    // Six hex digits and nothing else - strtoul would also take leading
+    // spaces, a sign or "0x"
+    uint32_t number = 0;
+    for (int i = 0; i < 6; i++) {
+        if (!isxdigit((unsigned char)hexValue[i])) {
+            return false;
+        }
+        number = (number << 4) | hexDigit(hexValue[i]);
+    }
+    if (hexValue[6] != '\0') {
+        return false;
+    }
+    memset(&control, 0, sizeof(control));
+    control.opcode = ControlProtocol::OP_COLOUR;
+    control.payload[0] = (number >> 16) & 0xFF;
+    control.payload[1] = (number >> 8) & 0xFF;
+    control.payload[2] = number & 0xFF;
+    return true;
+}
+
+bool decodeControl(uint32_t messageType, JsonVariantConst request, ControlProtocol::Control& control) {
+    memset(&control, 0, sizeof(control));
+
+    switch (messageType) {
+        case hashMessageType("vu"):
+            control.opcode = ControlProtocol::OP_VU;
+            control.payload[0] = (bool)request["value"];
+            return true;
+        case hashMessageType("white"):
+            control.opcode = ControlProtocol::OP_WHITE;
+            control.payload[0] = (bool)request["value"];
+            return true;
+        case hashMessageType("brightness"): {
+            int value = (int)request["value"];
+            control.opcode = ControlProtocol::OP_BRIGHTNESS;
+            control.payload[0] = (uint8_t)constrain(value, 0, 255);
+            return true;
+        }
+        case hashMessageType("animation"):
+            control.opcode = ControlProtocol::OP_ANIMATION;
+            control.payload[0] = (bool)request["value"];
+            // Turning animations off sends no index
+            return request["animation"].isNull() || decodeAnimationIndex(request["animation"], control.payload[1]);
+        case hashMessageType("colour"):
+            return decodeColour(request["value"].as<const char*>(), control);
+        default:
+            return false;
+    }
+}
+
+bool decodeState(JsonVariantConst state, uint8_t currentAnimation,
+                 ControlProtocol::Control* controls, uint8_t& count) {
+    count = 0;
+
+    JsonVariantConst animation = state["animation"];
+    if (!animation.isNull()) {
+        ControlProtocol::Control& control = controls[count++];
+        memset(&control, 0, sizeof(control));
+        control.opcode = ControlProtocol::OP_ANIMATION;
+        control.payload[1] = currentAnimation;
+        if (animation.is<bool>()) {
+            control.payload[0] = animation.as<bool>();
+        } else if (animation.is<int>()) {
+            control.payload[0] = 1;
+            if (!decodeAnimationIndex(animation, control.payload[1])) {
+                return false;
+            }
+        } else if (animation.is<JsonObjectConst>()) {
+            JsonVariantConst runState = animation["state"];
+            JsonVariantConst index = animation["index"];
+            if (!runState.isNull() && !runState.is<bool>()) {
+                return false;
+            }
+            if (!index.isNull() && !decodeAnimationIndex(index, control.payload[1])) {
+                return false;
+            }
+            control.payload[0] = runState | true;
+        } else {
+            return false;
+        }
+    }
+
+    JsonVariantConst colour = state["colour"];
+    if (!colour.isNull() && !decodeColour(colour.as<const char*>(), controls[count++])) {
+        return false;
+    }
+
+    static const struct {
+        const char* name;
+        uint8_t opcode;
+    } SWITCHES[] = {
+        { "white", ControlProtocol::OP_WHITE },
+        { "vu", ControlProtocol::OP_VU },
+    };
+    for (size_t i = 0; i < sizeof(SWITCHES) / sizeof(SWITCHES[0]); i++) {
+        JsonVariantConst value = state[SWITCHES[i].name];
+        if (value.isNull()) {
+            continue;
+        }
+        if (!value.is<bool>()) {
+            return false;
+        }
+        ControlProtocol::Control& control = controls[count++];
+        memset(&control, 0, sizeof(control));
+        control.opcode = SWITCHES[i].opcode;
+        control.payload[0] = value.as<bool>();
+    }
+
+    JsonVariantConst level = state["brightness"];
+    if (!level.isNull()) {
+        if (!level.is<int>()) {
+            return false;
+        }
+        ControlProtocol::Control& control = controls[count++];
+        memset(&control, 0, sizeof(control));
+        control.opcode = ControlProtocol::OP_BRIGHTNESS;
+        control.payload[0] = (uint8_t)constrain(level.as<int>(), 0, 255);
+    }
+
+    return count > 0;
+}
+
+} // namespace ControlJson
@@ -0,0 +1,68 @@
+#include "ControlQueue.h"
+
+ControlQueue::ControlQueue()
+    : nextOrder_(0)
+    , stats_()
+{
+    portMUX_INITIALIZE(&mux_);
+    memset(slots_, 0, sizeof(slots_));
+}
+
+void ControlQueue::post(const ControlProtocol::Control& control) {
+    post(&control, 1);
+}
+
+void ControlQueue::post(const ControlProtocol::Control* controls, uint8_t count) {
+    portENTER_CRITICAL(&mux_);
+    for (uint8_t i = 0; i < count; i++) {
+        const ControlProtocol::Control& control = controls[i];
+        if (control.opcode < ControlProtocol::OP_VU || control.opcode > SLOT_COUNT) {
+            continue;
+        }
+
+        Slot& slot = slots_[control.opcode - ControlProtocol::OP_VU];
+        if (slot.pending) {
+            stats_.superseded++;
+        }
+        slot.control = control;
+        slot.order = nextOrder_++;
+        slot.pending = true;
+        stats_.posted++;
+    }
+    portEXIT_CRITICAL(&mux_);
+}
+
+uint8_t ControlQueue::drain(ControlProtocol::Control* out) {
+    Slot taken[SLOT_COUNT];
+    uint8_t count = 0;
+
+    portENTER_CRITICAL(&mux_);
+    for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+        if (slots_[i].pending) {
+            taken[count++] = slots_[i];
+            slots_[i].pending = false;
+        }
+    }
+    stats_.applied += count;
+    portEXIT_CRITICAL(&mux_);
+
+    // Insertion sort by arrival - at most SLOT_COUNT entries
+    for (uint8_t i = 1; i < count; i++) {
+        Slot slot = taken[i];
+        uint8_t j = i;
+        while (j > 0 && (int32_t)(taken[j - 1].order - slot.order) > 0) {
+            taken[j] = taken[j - 1];
+            j--;
+        }
+        taken[j] = slot;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        out[i] = taken[i].control;
+    }
+    return count;
+}
+
+ControlQueue::Stats ControlQueue::getStats() const {
+    return stats_;
+}
@@ -0,0 +1,325 @@
+#include "FrameStreamer.h"
+#include "LEDManager.h"
+#include <Logger.h>
+
+extern LEDManager* g_ledManager;
+
+static inline void put16(uint8_t* p, uint16_t value) {
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+static inline void put32(uint8_t* p, uint32_t value) {
+    put16(p, value & 0xFFFF);
+    put16(p + 2, value >> 16);
+}
+
+FrameStreamer::FrameStreamer(AsyncWebSocket* webSocket)
+    : webSocket_(webSocket)
+    , current_(nullptr)
+    , message_(nullptr)
+    , capacityPixels_(0)
+    , stats_()
+    , geometryVersion_(0)
+{
+    portMUX_INITIALIZE(&mux_);
+    memset(subscribers_, 0, sizeof(subscribers_));
+}
+
+FrameStreamer::~FrameStreamer() {
+    for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        free(subscribers_[i].baseline);
+    }
+    freeBuffers();
+}
+
+bool FrameStreamer::subscribe(uint32_t clientId, uint8_t fps, uint8_t scale) {
+    if (fps > MAX_FPS) {
+        fps = MAX_FPS;
+    }
+    if (scale < 1) {
+        scale = 1;
+    }
+    if (scale > MAX_SCALE) {
+        scale = MAX_SCALE;
+    }
+
+    bool found = false;
+    portENTER_CRITICAL(&mux_);
+    Subscriber* slot = nullptr;
+    for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        if (subscribers_[i].id == clientId) {
+            slot = &subscribers_[i];
+            break;
+        }
+        if (!slot && subscribers_[i].id == 0) {
+            slot = &subscribers_[i];
+        }
+    }
+    if (slot && (slot->id == clientId || fps > 0)) {
+        slot->id = clientId;
+        slot->fps = fps;
+        slot->scale = scale;
+        slot->changed = true;
+        found = true;
+    }
+    portEXIT_CRITICAL(&mux_);
+
+    return found || fps == 0;
+}
+
+void FrameStreamer::removeClient(uint32_t clientId) {
+    subscribe(clientId, 0, 1);
+}
+
+void FrameStreamer::applySubscriptionChanges() {
+    for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        Subscriber& sub = subscribers_[i];
+
+        portENTER_CRITICAL(&mux_);
+        bool changed = sub.changed;
+        uint8_t fps = sub.fps;
+        uint8_t scale = sub.scale;
+        sub.changed = false;
+        portEXIT_CRITICAL(&mux_);
+
+        if (!changed) {
+            continue;
+        }
+
+        free(sub.baseline);
+        sub.baseline = nullptr;
+
+        if (fps == 0) {
+            portENTER_CRITICAL(&mux_);
+            if (sub.fps == 0 && !sub.changed) {
+                sub.id = 0;     // Slot is free again
+            }
+            portEXIT_CRITICAL(&mux_);
+            continue;
+        }
+
+        sub.activeFps = fps;
+        sub.activeScale = scale;
+        sub.cols = (g_ledManager->getLedsPerStrip() + scale - 1) / scale;
+        sub.rows = (g_ledManager->getNumStrips() + scale - 1) / scale;
+        sub.baseline = (uint8_t*)malloc((size_t)sub.cols * sub.rows * 3);
+        sub.needsKeyframe = true;
+        sub.lastSent = 0;
+        if (!sub.baseline) {
+            Logger.warning("Frame stream: no memory for client #%u", sub.id);
+        }
+    }
+}
+
+bool FrameStreamer::ensureBuffers(size_t pixels) {
+    if (pixels <= capacityPixels_) {
+        return true;
+    }
+
+    freeBuffers();
+    current_ = (uint8_t*)malloc(pixels * 3);
+    message_ = (uint8_t*)malloc(ControlProtocol::FRAME_HEADER_SIZE +
+                                ControlProtocol::FRAME_RUN_HEADER_SIZE + pixels * 3);
+    if (!current_ || !message_) {
+        freeBuffers();
+        return false;
+    }
+    capacityPixels_ = pixels;
+    return true;
+}
+
+void FrameStreamer::freeBuffers() {
+    free(current_);
+    free(message_);
+    current_ = nullptr;
+    message_ = nullptr;
+    capacityPixels_ = 0;
+}
+
+void FrameStreamer::update() {
+    if (!webSocket_ || !g_ledManager || !g_ledManager->isConfigValid()) {
+        return;
+    }
+
+    // A new LED layout invalidates every baseline
+    uint32_t geometry = g_ledManager->getGeometryVersion();
+    if (geometry != geometryVersion_) {
+        geometryVersion_ = geometry;
+        portENTER_CRITICAL(&mux_);
+        for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+            if (subscribers_[i].id != 0) {
+                subscribers_[i].changed = true;
+            }
+        }
+        portEXIT_CRITICAL(&mux_);
+    }
+
+    applySubscriptionChanges();
+
+    uint8_t active = 0;
+    for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        if (subscribers_[i].baseline) {
+            active++;
+        }
+    }
+    stats_.subscribers = active;
+
+    if (active == 0) {
+        freeBuffers();
+        return;
+    }
+
+    // Sized for scale 1 so a resubscribe never reallocates
+    size_t maxPixels = (size_t)g_ledManager->getLedsPerStrip() * g_ledManager->getNumStrips();
+    if (maxPixels > 0xFFFF || !ensureBuffers(maxPixels) || !g_ledManager->getFrame()) {
+        return;
+    }
+
+    uint32_t seq = g_ledManager->getFrameSequence();
+    unsigned long now = millis();
+
+    // Sample once per scale in use, shared by every client at that scale
+    for (uint8_t scale = 1; scale <= MAX_SCALE; scale++) {
+        sendDueFrames(scale, seq, now);
+    }
+}
+
+void FrameStreamer::sendDueFrames(uint8_t scale, uint32_t seq, unsigned long now) {
+    bool sampled = false;
+
+    for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        Subscriber& sub = subscribers_[i];
+        if (!sub.baseline || sub.activeScale != scale || sub.lastSeq == seq) {
+            continue;
+        }
+        if (now - sub.lastSent < 1000UL / sub.activeFps) {
+            continue;
+        }
+
+        AsyncWebSocketClient* client = webSocket_->client(sub.id);
+        if (!client || client->status() != WS_CONNECTED) {
+            continue;
+        }
+        if (client->queueIsFull()) {
+            // Keep the baseline - the next delta is still against what it has
+            stats_.skipped++;
+            sub.lastSent = now;
+            continue;
+        }
+
+        if (!sampled) {
+            unsigned long start = micros();
+            sample(g_ledManager->getFrame(), scale, sub.cols, sub.rows);
+            stats_.encodeUs += micros() - start;
+            sampled = true;
+        }
+
+        unsigned long start = micros();
+        size_t length = encode(sub, seq);
+        stats_.encodeUs += micros() - start;
+
+        sub.lastSeq = seq;
+        if (length == 0) {
+            continue;   // Nothing changed since this client's last frame
+        }
+
+        client->binary((const char*)message_, length);
+        sub.lastSent = now;
+        stats_.framesSent++;
+        stats_.bytesSent += length;
+        stats_.bytesRaw += ControlProtocol::FRAME_HEADER_SIZE + ControlProtocol::FRAME_RUN_HEADER_SIZE +
+                           (uint32_t)sub.cols * sub.rows * 3;
+    }
+}
+
+void FrameStreamer::sample(const CRGB* frame, uint8_t scale, uint16_t cols, uint16_t rows) {
+    uint8_t* out = current_;
+    for (uint16_t y = 0; y < rows; y++) {
+        for (uint16_t x = 0; x < cols; x++) {
+            int index = g_ledManager->xyToIndex(x * scale, y * scale);
+            if (index >= 0) {
+                out[0] = frame[index].r;
+                out[1] = frame[index].g;
+                out[2] = frame[index].b;
+            } else {
+                out[0] = out[1] = out[2] = 0;
+            }
+            out += 3;
+        }
+    }
+}
+
+size_t FrameStreamer::encode(Subscriber& sub, uint32_t seq) {
+    const size_t pixels = (size_t)sub.cols * sub.rows;
+    const size_t keyframeSize = ControlProtocol::FRAME_HEADER_SIZE +
+                                ControlProtocol::FRAME_RUN_HEADER_SIZE + pixels * 3;
+
+    message_[0] = ControlProtocol::MSG_FRAME;
+    message_[1] = 0;
+    put16(message_ + 2, sub.cols);
+    put16(message_ + 4, sub.rows);
+    put32(message_ + 6, seq);
+    size_t pos = ControlProtocol::FRAME_HEADER_SIZE;
+
+    bool keyframe = sub.needsKeyframe;
+    if (!keyframe) {
+        const uint8_t* cur = current_;
+        const uint8_t* base = sub.baseline;
+        size_t i = 0;
+
+        while (i < pixels) {
+            if (memcmp(cur + i * 3, base + i * 3, 3) == 0) {
+                i++;
+                continue;
+            }
+
+            // Extend the run; a single unchanged pixel (3 bytes) is cheaper
+            // to resend than a new run header (4 bytes)
+            size_t end = i + 1;
+            while (end < pixels) {
+                if (memcmp(cur + end * 3, base + end * 3, 3) != 0) {
+                    end++;
+                } else if (end + 1 < pixels && memcmp(cur + (end + 1) * 3, base + (end + 1) * 3, 3) != 0) {
+                    end += 2;
+                } else {
+                    break;
+                }
+            }
+
+            size_t count = end - i;
+            if (pos + ControlProtocol::FRAME_RUN_HEADER_SIZE + count * 3 >= keyframeSize) {
+                keyframe = true;    // Delta wouldn't be smaller than the frame itself
+                break;
+            }
+
+            put16(message_ + pos, i);
+            put16(message_ + pos + 2, count);
+            memcpy(message_ + pos + ControlProtocol::FRAME_RUN_HEADER_SIZE, cur + i * 3, count * 3);
+            pos += ControlProtocol::FRAME_RUN_HEADER_SIZE + count * 3;
+            i = end;
+        }
+
+        if (!keyframe && pos == ControlProtocol::FRAME_HEADER_SIZE) {
+            return 0;
+        }
+    }
+
+    if (keyframe) {
+        message_[1] = ControlProtocol::FRAME_FLAG_KEY;
+        pos = ControlProtocol::FRAME_HEADER_SIZE;
+        put16(message_ + pos, 0);
+        put16(message_ + pos + 2, pixels);
+        memcpy(message_ + pos + ControlProtocol::FRAME_RUN_HEADER_SIZE, current_, pixels * 3);
+        pos = keyframeSize;
+        stats_.keyframes++;
+        sub.needsKeyframe = false;
+    }
+
+    memcpy(sub.baseline, current_, pixels * 3);
+    return pos;
+}
+
+FrameStreamer::Stats FrameStreamer::getStats() const {
+    return stats_;
+}
@@ -0,0 +1,97 @@
+#include "JsonArena.h"
+
+JsonArena::JsonArena()
+    : used_(0)
+    , live_(0)
+    , stats_()
+{
+    stats_.capacity = CAPACITY;
+}
+
+bool JsonArena::owns(const void* ptr) const {
+    const uint8_t* p = static_cast<const uint8_t*>(ptr);
+    return p >= buffer_ && p < buffer_ + CAPACITY;
+}
+
+size_t& JsonArena::blockSize(void* ptr) {
+    return *reinterpret_cast<size_t*>(static_cast<uint8_t*>(ptr) - HEADER_SIZE);
+}
+
+void* JsonArena::allocate(size_t size) {
+    size = (size + 7) & ~(size_t)7;
+    if (used_ + HEADER_SIZE + size > CAPACITY) {
+        stats_.fallbacks++;
+        return malloc(size);
+    }
+
+    uint8_t* block = buffer_ + used_ + HEADER_SIZE;
+    used_ += HEADER_SIZE + size;
+    live_++;
+    blockSize(block) = size;
+
+    if (used_ > stats_.peakBytes) {
+        stats_.peakBytes = used_;
+    }
+    return block;
+}
+
+void JsonArena::deallocate(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    if (!owns(ptr)) {
+        free(ptr);
+        return;
+    }
+
+    uint8_t* block = static_cast<uint8_t*>(ptr);
+    if (block + blockSize(ptr) == buffer_ + used_) {
+        used_ -= HEADER_SIZE + blockSize(ptr);  // Last block - give the space back now
+    }
+    if (--live_ == 0) {
+        used_ = 0;
+    }
+}
+
+void* JsonArena::reallocate(void* ptr, size_t newSize) {
+    if (!ptr) {
+        return allocate(newSize);
+    }
+    if (!owns(ptr)) {
+        return realloc(ptr, newSize);
+    }
+
+    newSize = (newSize + 7) & ~(size_t)7;
+    uint8_t* block = static_cast<uint8_t*>(ptr);
+    size_t oldSize = blockSize(ptr);
+    bool isLast = block + oldSize == buffer_ + used_;
+
+    if (newSize <= oldSize) {
+        if (isLast) {
+            used_ -= oldSize - newSize;
+            blockSize(ptr) = newSize;
+        }
+        return ptr;
+    }
+
+    if (isLast && used_ + (newSize - oldSize) <= CAPACITY) {
+        used_ += newSize - oldSize;
+        blockSize(ptr) = newSize;
+        if (used_ > stats_.peakBytes) {
+            stats_.peakBytes = used_;
+        }
+        return ptr;
+    }
+
+    void* moved = allocate(newSize);
+    if (!moved) {
+        return nullptr;  // Original block stays valid, like realloc()
+    }
+    memcpy(moved, ptr, oldSize);
+    deallocate(ptr);
+    return moved;
+}
+
+JsonArena::Stats JsonArena::getStats() const {
+    return stats_;
+}
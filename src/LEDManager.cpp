@@ -1,9 +1,16 @@
 #include "LEDManager.h"
-#include "UIManager.h"
+#include "BootProfiler.h"
+#include "Metrics.h"
+#include <esp_rom_crc.h>
+#include <esp_system.h>
+#include <new>
 
 // Global LED manager instance
 LEDManager* g_ledManager = nullptr;
 
+// Not cleared by a software reset (see prepareForRestart())
+RTC_NOINIT_ATTR LEDManager::RestartSnapshot LEDManager::restartSnapshot_;
+
 // Legacy compatibility - global state variables
 uint8_t brightness = 128;
 bool showAnimation = false;
@@ -36,6 +43,8 @@ const char* LEDManager::animationDescriptions_[] = {
 
 LEDManager::LEDManager()
     : leds_(nullptr)
+    , published_(nullptr)
+    , output_(nullptr)
     , numStrips_(0)
     , ledsPerStrip_(0)
     , totalLeds_(0)
@@ -50,10 +59,32 @@ LEDManager::LEDManager()
     , stateDirty_(false)
     , stateLoaded_(false)
     , stateChangedTime_(0)
+    , persisted_()
+    , havePersisted_(false)
+    , persistStats_()
+    , resumed_(false)
     , audioLevel_(0)
-    , lastOTAProgress_(255)  // Invalid value to force first update
+    , outputLevel_(0)
+    , viewFirstStrip_(0)
+    , viewAudioBand_(LedZones::AUDIO_SPREAD)
     , lastAnimationUpdate_(0)
+    , mainEffect_()
+    , effect_(&mainEffect_)
+    , frameSeq_(0)
+    , fading_(false)
+    , fadeStart_(0)
+    , fadeDurationMs_(0)
+    , firstLightMarked_(false)
+    , controller_(nullptr)
+    , ledCapacity_(0)
+    , geometryVersion_(0)
+    , reconfigurePending_(false)
+    , pendingStrips_(0)
+    , pendingLedsPerStrip_(0)
 {
+    portMUX_INITIALIZE(&reconfigureMux_);
+    mainEffect_.reset();
+
     // Initialize VU levels array
     for (int i = 0; i < 7; i++) {
         vuLevels_[i] = 0;
@@ -83,13 +114,29 @@ bool LEDManager::initialize() {
         return false;
     }
 
-    // Initialize FastLED
-    FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds_, totalLeds_);
+    // Initialize FastLED. Colour order, brightness and correction are all
+    // done by the output stage, so FastLED sends output_ as is
+    controller_ = &FastLED.addLeds<WS2812B, DATA_PIN, RGB>(leds_, totalLeds_);
+    FastLED.setDither(DISABLE_DITHER);
+    ledCapacity_ = totalLeds_;
+
+    // Layer buffers for the largest layout this boot can apply in place
+    if (!compositor_.begin(ledCapacity_)) {
+        Serial.println("Warning: no memory for effect layers");
+    }
+    if (!outputStage_.begin(ledCapacity_)) {
+        Serial.println("Warning: no memory for output dithering");
+    }
     FastLED.clear();
     FastLED.setBrightness(0);
 
-    // Load saved LED state (brightness, mode, color, animation, etc.)
+    // Load saved LED state (brightness, mode, color, animation, etc.),
+    // then anything newer handed over by a warm restart
     loadState();
+    resumed_ = restoreRestartSnapshot();
+    zones_.load();
+    limiter_.load();
+    outputStage_.load();
 
     // Sync legacy global variables
     brightness = brightness_;
@@ -108,19 +155,76 @@ void LEDManager::update() {
     if (!initialized_ || !isConfigValid() || !leds_) {
         return;
     }
+    METRICS_SCOPE(LED_UPDATE);
+
+    applyPendingReconfigure();
+    applyZones(false);
+    limiter_.applyPending();
 
     updateBrightness();
 
+    METRICS_START(renderStart);
     unsigned long currentTime = millis();
-    if (currentTime - lastAnimationUpdate_ >= (unsigned long)getAnimationInterval()) {
+    if (zones_.getCount() > 0) {
+        renderZones(currentTime);
+    } else if (currentTime - lastAnimationUpdate_ >= (unsigned long)getAnimationInterval(currentAnimation_)) {
         lastAnimationUpdate_ = currentTime;
 
         if (showAnimation_) {
-            runAnimation();
+            runAnimation(currentAnimation_);
         }
     }
-
+    renderLayers(currentTime);
+    METRICS_OBSERVE(LED_RENDER, renderStart);
+
+    // Output stage - layers blended over the effect, zone dimming, then the
+    // overlay, all built in published_. leds_ itself is never touched, so
+    // effects that build on their previous frame carry on unaffected
+    METRICS_START(outputStart);
+    const CRGB* frame = leds_;
+    if (compositor_.getLayerCount() > 0) {
+        compositor_.compose(published_, leds_, totalLeds_);
+        frame = published_;
+    }
+    if (zones_.hasBrightness()) {
+        if (frame == leds_) {
+            memcpy(published_, leds_, sizeof(CRGB) * totalLeds_);
+            frame = published_;
+        }
+        dimZones(published_);
+    }
+    bool overlaid = overlay_.render(published_, frame, numStrips_, ledsPerStrip_);
+    if (overlaid) {
+        frame = published_;
+    }
+
+    // One pass into the transmit buffer: brightness (overlay pixels at the
+    // overlay's level), gamma, calibration and colour order. It also
+    // publishes a plain effect frame and gathers the power limiter's sums
+    outputStage_.prepare(outputLevel_);
+    limiter_.beginFrame();
+    outputStage_.render(output_, frame, frame == leds_ ? published_ : nullptr, numStrips_, ledsPerStrip_,
+                        limiter_.isEnabled() ? &limiter_ : nullptr, overlaid ? &overlay_ : nullptr);
+    uint8_t level = MAX_BRIGHTNESS;
+    if (limiter_.isEnabled()) {
+        level = limiter_.limit(output_, numStrips_, ledsPerStrip_, level);
+    }
+    METRICS_OBSERVE(LED_OUTPUT, outputStart);
+
+    // Show the transmit buffer, then hand the effect buffer back to the
+    // controller (FastLED.clear() elsewhere still clears the effect)
+    controller_->setLeds(output_, totalLeds_);
+    FastLED.setBrightness(level);
+    METRICS_START(showStart);
     FastLED.show();
+    METRICS_OBSERVE(LED_SHOW, showStart);
+    controller_->setLeds(leds_, totalLeds_);
+    frameSeq_++;
+
+    if (!firstLightMarked_ && outputLevel_ > 0) {
+        firstLightMarked_ = true;
+        g_bootProfiler.mark("first-led");
+    }
 
     // Check if state needs saving (debounced)
     saveStateIfNeeded();
@@ -139,114 +243,98 @@ void LEDManager::setBrightness(uint8_t newBrightness) {
     markStateDirty();
 }
 
-void LEDManager::performStartupFadeIn() {
-    if (!initialized_ || !isConfigValid() || !leds_) {
-        return;
+bool LEDManager::setZones(const LedZones::Zone* zones, uint8_t count) {
+    if (!initialized_) {
+        return false;
     }
-
-    // Use saved brightness, minimum 1 for visibility during fade
-    uint8_t targetBrightness = brightness_;
-    if (targetBrightness < 1) {
-        targetBrightness = 1;
-    }
-
-    // Calculate delay to make fade take roughly the same time regardless of brightness
-    // Lower brightness = longer delay per step to maintain visible fade
-    int delayPerStep = max(5, 2000 / max((int)targetBrightness, 1));
-
-    // Determine what to show based on saved state
-    if (showAnimation_) {
-        // For animations: start animation immediately but fade in brightness
-        FastLED.setBrightness(0);
-        for (int i = 0; i <= targetBrightness; i++) {
-            runAnimation();
-            FastLED.setBrightness(i);
-            FastLED.show();
-            delay(delayPerStep);
-        }
-    } else if (whiteMode_) {
-        // Fade in white
-        fillColor(CRGB::White);
-        for (int i = 0; i <= targetBrightness; i++) {
-            FastLED.setBrightness(i);
-            FastLED.show();
-            delay(delayPerStep);
-        }
-    } else {
-        // Fade in solid color (default to red if no color saved)
-        CRGB startupColor = solidColor_;
-        if (startupColor.r == 0 && startupColor.g == 0 && startupColor.b == 0) {
-            startupColor = CRGB::Red;  // Default to red for first boot
-        }
-        fillColor(startupColor);
-        for (int i = 0; i <= targetBrightness; i++) {
-            FastLED.setBrightness(i);
-            FastLED.show();
-            delay(delayPerStep);
+    for (uint8_t i = 0; i < count; i++) {
+        if ((zones[i].effect > CONFETTI && zones[i].effect != LedZones::EFFECT_OFF) ||
+            (zones[i].audioBand >= 7 && zones[i].audioBand != LedZones::AUDIO_SPREAD)) {
+            return false;
         }
     }
+    return zones_.request(zones, count);
+}
 
-    // Ensure final brightness is exactly what was saved
-    FastLED.setBrightness(brightness_);
-    FastLED.show();
+bool LEDManager::setPowerSupplies(const PowerLimiter::Supply* supplies, uint8_t count) {
+    if (!initialized_) {
+        return false;
+    }
+    return limiter_.request(supplies, count);
 }
 
-void LEDManager::showOTAProgress(uint8_t progress) {
-    if (!initialized_ || !isConfigValid() || !leds_) {
-        return;
+bool LEDManager::setOutputSettings(const OutputStage::Settings& settings) {
+    if (!initialized_) {
+        return false;
     }
+    return outputStage_.request(settings);
+}
 
-    // Clamp progress to 0-100
-    if (progress > 100) {
-        progress = 100;
+bool LEDManager::setLayers(const LayerCompositor::Layer* layers, uint8_t count) {
+    if (!initialized_ || !compositor_.isAvailable()) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (layers[i].effect > CONFETTI) {
+            return false;
+        }
     }
+    return compositor_.request(layers, count);
+}
 
-    // Only update if progress changed to reduce jitter
-    if (progress == lastOTAProgress_) {
+void LEDManager::startFadeIn() {
+    if (!initialized_ || !isConfigValid() || !leds_) {
         return;
     }
-    lastOTAProgress_ = progress;
-
-    // Calculate how many LEDs per strip should be lit based on progress
-    int ledsPerStripToLight = (ledsPerStrip_ * progress) / 100;
-
-    // Fill each strip left to right in unison
-    // Account for daisy-chaining: even strips (0,2,4...) are reversed
-    for (int strip = 0; strip < numStrips_; strip++) {
-        int stripStart = strip * ledsPerStrip_;
-        bool reversed = (strip % 2 == 0); // Even strips are reversed
 
-        for (int led = 0; led < ledsPerStripToLight; led++) {
-            // Gradient from cyan (start) to green (end) based on position in strip
-            uint8_t ratio = (led * 255) / ledsPerStrip_;
-
-            // Calculate LED index based on direction
-            int ledIndex;
-            if (reversed) {
-                ledIndex = stripStart + (ledsPerStrip_ - 1 - led); // Fill from right to left
-            } else {
-                ledIndex = stripStart + led; // Fill from left to right
-            }
-
-            leds_[ledIndex] = CHSV(96 + (ratio / 4), 255, 255); // Cyan (96) to green (128)
+    if (resumed_) {
+        // Warm restart - the lights were on a moment ago, pick up at full level
+        if (!showAnimation_) {
+            fillColor(whiteMode_ ? CRGB(CRGB::White) : solidColor_);
         }
+        update();
+        return;
     }
 
-    // Flash all LEDs green when complete
-    if (progress >= 100) {
-        for (int i = 0; i < totalLeds_; i++) {
-            leds_[i] = CRGB::Green;
+    // Use saved brightness, minimum 1 for visibility during fade
+    int targetBrightness = max((int)brightness_, 1);
+
+    // Roughly the same fade time regardless of brightness - lower brightness
+    // gets longer steps so the fade stays visible
+    fadeDurationMs_ = (unsigned long)max(5, 2000 / targetBrightness) * (targetBrightness + 1);
+
+    // Animations draw themselves from update(); static modes are drawn once
+    if (!showAnimation_) {
+        if (whiteMode_) {
+            fillColor(CRGB::White);
+        } else {
+            // Default to red if no color saved (first boot)
+            CRGB startupColor = solidColor_;
+            if (startupColor.r == 0 && startupColor.g == 0 && startupColor.b == 0) {
+                startupColor = CRGB::Red;
+            }
+            fillColor(startupColor);
         }
     }
 
-    FastLED.setBrightness(150); // Full brightness for OTA progress
-    FastLED.show();
+    fadeStart_ = millis();
+    fading_ = true;
+    update();
 }
 
 void LEDManager::fillColor(CRGB color) {
     if (!initialized_ || !leds_) {
         return;
     }
+
+    // Zoned strips belong to their zone's effect
+    if (zones_.getCount() > 0) {
+        for (uint8_t i = 0; i < zones_.getRunCount(); i++) {
+            const LedZones::Run& run = zones_.getRun(i);
+            fill_solid(leds_ + run.firstStrip * ledsPerStrip_, run.stripCount * ledsPerStrip_, color);
+        }
+        return;
+    }
     
     for (int i = 0; i < totalLeds_; i++) {
         leds_[i] = color;
@@ -270,6 +358,11 @@ int LEDManager::getVuForStrip(int strip) const {
     if (!isConfigValid() || strip < 0 || strip >= numStrips_) {
         return 0;
     }
+
+    // Zone mapped to a single band
+    if (viewAudioBand_ < 7) {
+        return vuLevels_[viewAudioBand_];
+    }
     
     // If we have 7 or fewer strips, distribute VU levels across strips WITHOUT overlaps
     if (numStrips_ <= 7) {
@@ -403,34 +496,73 @@ void LEDManager::loadConfiguration() {
 
 void LEDManager::loadState() {
     Preferences statePrefs;
-    statePrefs.begin("led-state", true); // Read-only
+    statePrefs.begin("led-state", false);
 
-    // Check if we have saved state
-    if (!statePrefs.isKey("brightness")) {
+    // One read for the whole state
+    StateBlob blob;
+    size_t length = statePrefs.getBytes("state", &blob, sizeof(blob));
+    if (length == sizeof(blob) && blob.version == STATE_BLOB_VERSION && blob.crc == stateBlobCrc(blob)) {
+        applyStateBlob(blob);
+        persisted_ = blob;
+        havePersisted_ = true;
+    } else if (length > 0) {
+        // Corrupt or from a newer firmware - keep the defaults, overwrite on next save
+        Serial.println("Saved LED state blob invalid, using defaults");
+        stateLoaded_ = false;
+        statePrefs.end();
+        return;
+    } else if (!loadLegacyState(statePrefs)) {
         Serial.println("No saved LED state found, using defaults (red fade-in)");
         stateLoaded_ = false;
         statePrefs.end();
         return;
     }
 
+    statePrefs.end();
+    stateLoaded_ = true;
+    persistStats_.lifetimeWrites = persisted_.writeCount;
+
+    Serial.printf("Loaded LED state: bright=%d, anim=%d, white=%d, vu=%d, animIdx=%d, color=#%02X%02X%02X\n",
+                 brightness_, showAnimation_, whiteMode_, vuMode_, currentAnimation_,
+                 solidColor_.r, solidColor_.g, solidColor_.b);
+}
+
+bool LEDManager::loadLegacyState(Preferences& statePrefs) {
+    // Per-key format used before the state blob
+    if (!statePrefs.isKey("brightness")) {
+        return false;
+    }
+
     brightness_ = statePrefs.getUChar("brightness", 128);
     showAnimation_ = statePrefs.getBool("animation", false);
     whiteMode_ = statePrefs.getBool("white", false);
     vuMode_ = statePrefs.getBool("vu", false);
     currentAnimation_ = static_cast<AnimationType>(statePrefs.getUChar("anim_idx", 0));
 
-    // Load solid color as packed RGB
     uint32_t packedColor = statePrefs.getUInt("color", 0xFF0000); // Default red
     solidColor_.r = (packedColor >> 16) & 0xFF;
     solidColor_.g = (packedColor >> 8) & 0xFF;
     solidColor_.b = packedColor & 0xFF;
 
-    statePrefs.end();
-    stateLoaded_ = true;
-
-    Serial.printf("Loaded LED state: bright=%d, anim=%d, white=%d, vu=%d, animIdx=%d, color=#%02X%02X%02X\n",
-                 brightness_, showAnimation_, whiteMode_, vuMode_, currentAnimation_,
-                 solidColor_.r, solidColor_.g, solidColor_.b);
+    // Migrate: write the blob first, only then drop the old keys
+    StateBlob blob;
+    buildStateBlob(blob);
+    blob.writeCount = 1;
+    blob.crc = stateBlobCrc(blob);
+    if (statePrefs.putBytes("state", &blob, sizeof(blob)) == sizeof(blob)) {
+        statePrefs.remove("brightness");
+        statePrefs.remove("animation");
+        statePrefs.remove("white");
+        statePrefs.remove("vu");
+        statePrefs.remove("anim_idx");
+        statePrefs.remove("color");
+        persisted_ = blob;
+        havePersisted_ = true;
+        persistStats_.writes++;
+        persistStats_.migrated = true;
+        Serial.println("Migrated LED state to a single blob");
+    }
+    return true;
 }
 
 void LEDManager::clearSavedState() {
@@ -439,26 +571,121 @@ void LEDManager::clearSavedState() {
     statePrefs.clear();
     statePrefs.end();
     stateLoaded_ = false;
+    havePersisted_ = false;
     Serial.println("LED state preferences cleared");
 }
 
+void LEDManager::prepareForRestart() {
+    if (!initialized_) {
+        return;
+    }
+
+    // NVS stays the source of truth should the snapshot be rejected
+    if (stateDirty_) {
+        saveState();
+        stateDirty_ = false;
+    }
+
+    RestartSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.magic = RESTART_SNAPSHOT_MAGIC;
+    snapshot.version = RESTART_SNAPSHOT_VERSION;
+    buildStateBlob(snapshot.state);
+    snapshot.animationPhase = mainEffect_.phase;
+    snapshot.crc = restartSnapshotCrc(snapshot);
+    restartSnapshot_ = snapshot;
+}
+
+bool LEDManager::restoreRestartSnapshot() {
+    RestartSnapshot snapshot = restartSnapshot_;
+
+    // One shot - a later crash or power cycle must not resume a stale one
+    restartSnapshot_.magic = 0;
+
+    // RTC memory is garbage after power-on and kept through panics and
+    // watchdog resets - only an intentional restart counts
+    if (esp_reset_reason() != ESP_RST_SW ||
+        snapshot.magic != RESTART_SNAPSHOT_MAGIC ||
+        snapshot.version != RESTART_SNAPSHOT_VERSION ||
+        snapshot.crc != restartSnapshotCrc(snapshot) ||
+        snapshot.state.version != STATE_BLOB_VERSION) {
+        return false;
+    }
+
+    applyStateBlob(snapshot.state);
+    mainEffect_.phase = snapshot.animationPhase;
+    stateLoaded_ = true;
+
+    // Changes made after the snapshot (OTA turns animations off) may have
+    // reached NVS - the snapshot wins, so store it again
+    if (!havePersisted_ || memcmp(&snapshot.state, &persisted_, offsetof(StateBlob, writeCount)) != 0) {
+        markStateDirty();
+    }
+    persistStats_.resumed = true;
+    Serial.printf("Resumed LED state from restart snapshot: anim=%d, animIdx=%d, phase=%u\n",
+                 showAnimation_, currentAnimation_, (unsigned)mainEffect_.phase);
+    return true;
+}
+
+uint32_t LEDManager::restartSnapshotCrc(const RestartSnapshot& snapshot) {
+    return esp_rom_crc32_le(0, (const uint8_t*)&snapshot, offsetof(RestartSnapshot, crc));
+}
+
+void LEDManager::buildStateBlob(StateBlob& blob) const {
+    memset(&blob, 0, sizeof(blob));
+    blob.version = STATE_BLOB_VERSION;
+    blob.brightness = brightness_;
+    if (showAnimation_) blob.flags |= STATE_FLAG_ANIMATION;
+    if (whiteMode_) blob.flags |= STATE_FLAG_WHITE;
+    if (vuMode_) blob.flags |= STATE_FLAG_VU;
+    blob.animation = static_cast<uint8_t>(currentAnimation_);
+    blob.colour[0] = solidColor_.r;
+    blob.colour[1] = solidColor_.g;
+    blob.colour[2] = solidColor_.b;
+}
+
+void LEDManager::applyStateBlob(const StateBlob& blob) {
+    brightness_ = blob.brightness;
+    showAnimation_ = (blob.flags & STATE_FLAG_ANIMATION) != 0;
+    whiteMode_ = (blob.flags & STATE_FLAG_WHITE) != 0;
+    vuMode_ = (blob.flags & STATE_FLAG_VU) != 0;
+    currentAnimation_ = static_cast<AnimationType>(blob.animation);
+    solidColor_ = CRGB(blob.colour[0], blob.colour[1], blob.colour[2]);
+}
+
+uint32_t LEDManager::stateBlobCrc(const StateBlob& blob) {
+    return esp_rom_crc32_le(0, (const uint8_t*)&blob, offsetof(StateBlob, crc));
+}
+
 void LEDManager::saveState() {
-    Preferences statePrefs;
-    statePrefs.begin("led-state", false); // Read-write
+    StateBlob blob;
+    buildStateBlob(blob);
 
-    statePrefs.putUChar("brightness", brightness_);
-    statePrefs.putBool("animation", showAnimation_);
-    statePrefs.putBool("white", whiteMode_);
-    statePrefs.putBool("vu", vuMode_);
-    statePrefs.putUChar("anim_idx", static_cast<uint8_t>(currentAnimation_));
+    // Settings that flip back and forth within the debounce end up
+    // identical to what is stored - don't spend a flash write on them
+    if (havePersisted_ && memcmp(&blob, &persisted_, offsetof(StateBlob, writeCount)) == 0) {
+        persistStats_.skipped++;
+        return;
+    }
 
-    // Pack color as RGB
-    uint32_t packedColor = ((uint32_t)solidColor_.r << 16) | ((uint32_t)solidColor_.g << 8) | solidColor_.b;
-    statePrefs.putUInt("color", packedColor);
+    blob.writeCount = (havePersisted_ ? persisted_.writeCount : 0) + 1;
+    blob.crc = stateBlobCrc(blob);
 
+    Preferences statePrefs;
+    statePrefs.begin("led-state", false); // Read-write
+    size_t written = statePrefs.putBytes("state", &blob, sizeof(blob));
     statePrefs.end();
 
-    Serial.println("LED state saved to preferences");
+    if (written != sizeof(blob)) {
+        Serial.println("Failed to save LED state");
+        return;
+    }
+
+    persisted_ = blob;
+    havePersisted_ = true;
+    persistStats_.writes++;
+    persistStats_.lifetimeWrites = blob.writeCount;
+    Serial.printf("LED state saved (write #%u)\n", blob.writeCount);
 }
 
 void LEDManager::saveStateIfNeeded() {
@@ -513,7 +740,80 @@ bool LEDManager::allocateLedArrays() {
     
     Serial.printf("Allocating memory for %d LEDs\n", totalLeds_);
     leds_ = new CRGB[totalLeds_];
-    return (leds_ != nullptr);
+    published_ = new CRGB[totalLeds_];
+    output_ = new CRGB[totalLeds_];
+    if (!leds_ || !published_ || !output_) {
+        deallocateLedArrays();
+        return false;
+    }
+    memset(published_, 0, sizeof(CRGB) * totalLeds_);
+    memset(output_, 0, sizeof(CRGB) * totalLeds_);
+    return true;
+}
+
+bool LEDManager::requestReconfigure(int numStrips, int ledsPerStrip) {
+    if (!initialized_ || !controller_ || numStrips <= 0 || ledsPerStrip <= 0 ||
+        numStrips * ledsPerStrip > ledCapacity_) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&reconfigureMux_);
+    pendingStrips_ = numStrips;
+    pendingLedsPerStrip_ = ledsPerStrip;
+    reconfigurePending_ = true;
+    portEXIT_CRITICAL(&reconfigureMux_);
+    return true;
+}
+
+void LEDManager::applyPendingReconfigure() {
+    portENTER_CRITICAL(&reconfigureMux_);
+    bool pending = reconfigurePending_;
+    int numStrips = pendingStrips_;
+    int ledsPerStrip = pendingLedsPerStrip_;
+    reconfigurePending_ = false;
+    portEXIT_CRITICAL(&reconfigureMux_);
+
+    if (!pending || (numStrips == numStrips_ && ledsPerStrip == ledsPerStrip_)) {
+        return;
+    }
+
+    int total = numStrips * ledsPerStrip;
+    CRGB* leds = new (std::nothrow) CRGB[total];
+    CRGB* published = new (std::nothrow) CRGB[total];
+    CRGB* output = new (std::nothrow) CRGB[total];
+    if (!leds || !published || !output) {
+        delete[] leds;
+        delete[] published;
+        delete[] output;
+        Serial.printf("Error: no memory to reconfigure to %d LEDs\n", total);
+        return;
+    }
+    memset(published, 0, sizeof(CRGB) * total);
+    memset(output, 0, sizeof(CRGB) * total);
+
+    // Blank the old layout first so LEDs past the new end don't stay lit
+    fill_solid(leds_, totalLeds_, CRGB::Black);
+    FastLED.show();
+
+    // Same controller, new buffer - registering another would drive the
+    // pin twice
+    controller_->setLeds(leds, total);
+    deallocateLedArrays();
+    leds_ = leds;
+    published_ = published;
+    output_ = output;
+    numStrips_ = numStrips;
+    ledsPerStrip_ = ledsPerStrip;
+    totalLeds_ = total;
+    geometryVersion_++;
+    compositor_.clearBuffers(total);
+    outputStage_.clearDither();
+
+    // Re-fits the zones and redraws the static modes on the new layout
+    applyZones(true);
+
+    Serial.printf("LEDs reconfigured in place: %d strips, %d LEDs/strip, %d total\n",
+                 numStrips_, ledsPerStrip_, totalLeds_);
 }
 
 void LEDManager::deallocateLedArrays() {
@@ -521,18 +821,36 @@ void LEDManager::deallocateLedArrays() {
         delete[] leds_;
         leds_ = nullptr;
     }
+    if (published_) {
+        delete[] published_;
+        published_ = nullptr;
+    }
+    if (output_) {
+        delete[] output_;
+        output_ = nullptr;
+    }
 }
 
 void LEDManager::updateBrightness() {
-    if (vuMode_) {
-        FastLED.setBrightness(audioLevel_);
-    } else {
-        FastLED.setBrightness(brightness_);
+    uint8_t level = vuMode_ ? audioLevel_ : brightness_;
+
+    // Startup fade-in scales whatever the current level is, so brightness
+    // changes made during the fade aren't lost
+    if (fading_) {
+        unsigned long elapsed = millis() - fadeStart_;
+        if (elapsed < fadeDurationMs_) {
+            level = (uint8_t)((uint32_t)level * elapsed / fadeDurationMs_);
+        } else {
+            fading_ = false;
+            g_bootProfiler.mark("fade-done");
+        }
     }
+
+    outputLevel_ = level;
 }
 
-int LEDManager::getAnimationInterval() const {
-    switch (currentAnimation_) {
+int LEDManager::getAnimationInterval(AnimationType animation) const {
+    switch (animation) {
         // Non-audio reactive
         case RAINBOW: return 10;
         case CYLON: return 30;
@@ -554,8 +872,8 @@ int LEDManager::getAnimationInterval() const {
     }
 }
 
-void LEDManager::runAnimation() {
-    switch (currentAnimation_) {
+void LEDManager::runAnimation(AnimationType animation) {
+    switch (animation) {
         // Non-audio reactive
         case RAINBOW: animationRainbow(); break;
         case CYLON: animationCylon(); break;
@@ -575,6 +893,122 @@ void LEDManager::runAnimation() {
         case CONFETTI: animationConfetti(); break;
         default: break;
     }
+    effect_->phase++;
+}
+
+void LEDManager::renderLayers(unsigned long now) {
+    compositor_.applyPending(totalLeds_);
+
+    // Effects draw into leds_ and step effect_ - point both at the layer's
+    // own for its turn
+    CRGB* effectLeds = leds_;
+
+    for (uint8_t i = 0; i < compositor_.getLayerCount(); i++) {
+        LayerCompositor::ActiveLayer& layer = compositor_.getLayer(i);
+        AnimationType animation = static_cast<AnimationType>(layer.layer.effect);
+        if (now - layer.lastUpdate < (unsigned long)getAnimationInterval(animation)) {
+            continue;
+        }
+        layer.lastUpdate = now;
+
+        unsigned long start = micros();
+        leds_ = layer.buffer;
+        effect_ = &layer.effect;
+        runAnimation(animation);
+        layer.stats.renderUs += micros() - start;
+        layer.stats.renders++;
+    }
+
+    leds_ = effectLeds;
+    effect_ = &mainEffect_;
+}
+
+LEDManager::RenderView LEDManager::applyView(const RenderView& view) {
+    RenderView previous = { leds_, numStrips_, totalLeds_, viewFirstStrip_, viewAudioBand_, audioLevel_ };
+    leds_ = view.leds;
+    numStrips_ = view.numStrips;
+    totalLeds_ = view.totalLeds;
+    viewFirstStrip_ = view.firstStrip;
+    viewAudioBand_ = view.audioBand;
+    audioLevel_ = view.audioLevel;
+    return previous;
+}
+
+LEDManager::RenderView LEDManager::stripView(int firstStrip, int stripCount, uint8_t audioBand) const {
+    RenderView view;
+    view.leds = leds_ + firstStrip * ledsPerStrip_;
+    view.numStrips = stripCount;
+    view.totalLeds = stripCount * ledsPerStrip_;
+    view.firstStrip = firstStrip;
+    view.audioBand = audioBand;
+    // Level-driven effects follow the zone's band too
+    view.audioLevel = audioBand < 7 ? vuLevels_[audioBand] : audioLevel_;
+    return view;
+}
+
+void LEDManager::applyZones(bool layoutChanged) {
+    if (!zones_.applyPending(numStrips_, layoutChanged)) {
+        return;
+    }
+
+    // Start from dark: idle zones stay that way, the rest draw themselves.
+    // Static main modes only draw on change - redraw them on their strips
+    fill_solid(leds_, totalLeds_, CRGB::Black);
+    if (!showAnimation_) {
+        if (whiteMode_) {
+            fillWhite();
+        } else {
+            fillColor(solidColor_);
+        }
+    }
+}
+
+void LEDManager::renderZones(unsigned long now) {
+    // Strips outside every zone: the main effect, one step for all of them.
+    // Each run has its own effect state, kept in step with the main phase
+    if (showAnimation_ && now - lastAnimationUpdate_ >= (unsigned long)getAnimationInterval(currentAnimation_)) {
+        lastAnimationUpdate_ = now;
+        for (uint8_t i = 0; i < zones_.getRunCount(); i++) {
+            const LedZones::Run& run = zones_.getRun(i);
+            EffectState& state = zones_.getRunState(i);
+            RenderView full = applyView(stripView(run.firstStrip, run.stripCount, LedZones::AUDIO_SPREAD));
+            state.phase = mainEffect_.phase;
+            effect_ = &state;
+            runAnimation(currentAnimation_);
+            applyView(full);
+        }
+        effect_ = &mainEffect_;
+        mainEffect_.phase++;
+    }
+
+    for (uint8_t i = 0; i < zones_.getCount(); i++) {
+        const LedZones::Zone& zone = zones_.getZone(i);
+        LedZones::ZoneState& state = zones_.getState(i);
+        if (zone.effect == LedZones::EFFECT_OFF) {
+            continue;
+        }
+
+        AnimationType animation = static_cast<AnimationType>(zone.effect);
+        if (now - state.lastUpdate < (unsigned long)getAnimationInterval(animation)) {
+            continue;
+        }
+        state.lastUpdate = now;
+
+        RenderView full = applyView(stripView(zone.firstStrip, zone.stripCount, zone.audioBand));
+        effect_ = &state.effect;
+        runAnimation(animation);
+        applyView(full);
+    }
+    effect_ = &mainEffect_;
+}
+
+void LEDManager::dimZones(CRGB* frame) const {
+    for (uint8_t i = 0; i < zones_.getCount(); i++) {
+        const LedZones::Zone& zone = zones_.getZone(i);
+        if (zone.brightness < 255) {
+            nscale8(frame + zone.firstStrip * ledsPerStrip_, zone.stripCount * ledsPerStrip_, zone.brightness);
+        }
+    }
 }
 
 // Animation implementations
@@ -620,16 +1054,20 @@ void LEDManager::fadeGreen(int amount) {
 }
 
 void LEDManager::animationRainbow() {
-    static uint8_t hue = 0;
+    uint8_t hue = effect_->phase;
     for (int i = 0; i < totalLeds_; i++) {
         leds_[i] = CHSV((i * 256 / totalLeds_) + hue, 255, 255);
     }
-    hue++;
 }
 
 void LEDManager::animationCylon() {
-    static bool goingLeft = true;
-    static uint8_t animationLed = 0;
+    // Sweeps 0 .. ledsPerStrip_ - 1 and back
+    int span = ledsPerStrip_ - 1;
+    int animationLed = 0;
+    if (span > 0) {
+        int step = effect_->phase % (2 * span);
+        animationLed = step <= span ? step : 2 * span - step;
+    }
 
     leds_[animationLed] = CRGB::Red;
     if (numStrips_ >= 2) {
@@ -646,39 +1084,13 @@ void LEDManager::animationCylon() {
     }
     
     fadeAll(35);
-
-    if (goingLeft) {
-        animationLed++;
-        if (animationLed == ledsPerStrip_ - 1) {
-            goingLeft = false;
-        }
-    } else {
-        animationLed--;
-        if (animationLed == 0) {
-            goingLeft = true;
-        }
-    }
 }
 
 void LEDManager::animationRgbChaser() {
-    static CRGB colour = CRGB::Red;
-    static int colourCount = 0;
-    static uint8_t animationLed = 0;
-    
-    leds_[animationLed] = colour;
-    animationLed++;
-    if (animationLed == totalLeds_) {
-        animationLed = 0;
-
-        colourCount++;
-        if (colourCount == 3) colourCount = 0;
-        switch (colourCount) {
-            case 0: colour = CRGB::Red; break;
-            case 1: colour = CRGB::Green; break;
-            case 2: colour = CRGB::Blue; break;
-            default: break;
-        }
-    }
+    // One pass over every LED per colour: red, green, blue
+    static const CRGB colours[3] = { CRGB::Red, CRGB::Green, CRGB::Blue };
+    uint32_t step = effect_->phase % (3 * (uint32_t)totalLeds_);
+    leds_[step % totalLeds_] = colours[step / totalLeds_];
 }
 
 void LEDManager::animationBeatSine() {
@@ -743,30 +1155,46 @@ int LEDManager::getCentreOfStrip(int strip) const {
     return (strip * ledsPerStrip_) + (ledsPerStrip_ / 2);
 }
 
+// Both centre helpers stay within [first, last] of the strip: the centre
+// is off by one on either side depending on the length's parity, and the
+// next pixel over belongs to another strip - or zone, or layer buffer
 void LEDManager::fillFromCentre(int strip, int vuValue, CRGB colour1, CRGB colour2, CRGB colour3) {
     int ledVu = map(vuValue, 0, 255, 0, (ledsPerStrip_ + 1) / 2);
+    int first = strip * ledsPerStrip_;
+    int last = first + ledsPerStrip_ - 1;
     int centre = getCentreOfStrip(strip);
     leds_[centre] = colour1;
     for (int i = 1; i <= ledVu; i++) {
-        leds_[centre + i] = pickColour(i, vuValue, colour1, colour2, colour3);
-        leds_[centre - i] = pickColour(i, vuValue, colour1, colour2, colour3);
+        if (centre + i <= last) {
+            leds_[centre + i] = pickColour(i, vuValue, colour1, colour2, colour3);
+        }
+        if (centre - i >= first) {
+            leds_[centre - i] = pickColour(i, vuValue, colour1, colour2, colour3);
+        }
     }
 }
 
 void LEDManager::moveFromCentre(int strip) {
+    int first = strip * ledsPerStrip_;
+    int last = first + ledsPerStrip_ - 1;
     int centre = getCentreOfStrip(strip);
     int ledsPerSide = ledsPerStrip_ / 2;
 
-    for (int i = ledsPerSide; i >= 0; i--) {
-        leds_[centre + i] = leds_[centre + i - 1];
-        leds_[centre - i] = leds_[centre - i + 1];
+    // Outermost first, so each pixel takes its inner neighbour's old value
+    for (int i = ledsPerSide; i >= 1; i--) {
+        if (centre + i <= last) {
+            leds_[centre + i] = leds_[centre + i - 1];
+        }
+        if (centre - i >= first) {
+            leds_[centre - i] = leds_[centre - i + 1];
+        }
     }
 }
 
 void LEDManager::moveDown() {
     for (int strip = numStrips_ - 1; strip > 0; strip--) {
         for (int led = 0; led < ledsPerStrip_; led++) {
-            if (strip % 2 == 1) {
+            if ((strip + viewFirstStrip_) % 2 == 1) {
                 leds_[(ledsPerStrip_ * strip) + (ledsPerStrip_ - led) - 1] = 
                     leds_[(ledsPerStrip_ * (strip - 1)) + led];
             } else {
@@ -802,8 +1230,9 @@ int LEDManager::xyToIndex(int x, int y) const {
         return -1;  // Out of bounds
     }
 
+    // Inside a zone view, parity follows the physical strip
     int index;
-    if (y % 2 == 0) {
+    if ((y + viewFirstStrip_) % 2 == 0) {
         // Even row - reversed (right to left)
         index = (y * ledsPerStrip_) + (ledsPerStrip_ - 1 - x);
     } else {
@@ -815,8 +1244,7 @@ int LEDManager::xyToIndex(int x, int y) const {
 
 // New animation: Plasma - colorful swirling sine wave patterns
 void LEDManager::animationPlasma() {
-    static uint16_t time = 0;
-    time += 1;
+    uint16_t time = effect_->phase;
 
     for (int y = 0; y < numStrips_; y++) {
         for (int x = 0; x < ledsPerStrip_; x++) {
@@ -839,7 +1267,7 @@ void LEDManager::animationPlasma() {
 
 // New animation: Sparkle - twinkling stars effect
 void LEDManager::animationSparkle() {
-    static uint8_t sparkleHue = 0;
+    uint8_t sparkleHue = effect_->phase * 3;  // Fast hue rotation for more color variety
 
     // Fade existing LEDs
     fadeAll(25);
@@ -858,13 +1286,11 @@ void LEDManager::animationSparkle() {
             }
         }
     }
-    sparkleHue += 3;  // Faster hue rotation for more color variety
 }
 
 // New animation: Wave - horizontal color waves traveling across rows
 void LEDManager::animationWave() {
-    static uint16_t offset = 0;
-    offset += 3;
+    uint16_t offset = effect_->phase * 3;
 
     for (int y = 0; y < numStrips_; y++) {
         // Each row has a phase offset for wave effect
@@ -888,13 +1314,7 @@ void LEDManager::animationWave() {
 
 // New animation: Ripple - audio-reactive ripples emanating from random points
 void LEDManager::animationRipple() {
-    static uint8_t rippleAge[8] = {0};    // Age of up to 8 ripples
-    static int8_t rippleX[8] = {0};        // Ripple center X
-    static int8_t rippleY[8] = {0};        // Ripple center Y
-    static uint8_t rippleHue[8] = {0};     // Ripple color
-    static uint8_t nextRipple = 0;
-    static uint8_t baseHue = 0;
-    static uint8_t spawnCooldown = 0;
+    EffectState::Ripple& ripple = effect_->ripple;
 
     // Slower fade to keep ripples visible longer
     fadeAll(12);
@@ -902,38 +1322,38 @@ void LEDManager::animationRipple() {
     // Ambient background glow that pulses with audio
     uint8_t ambientBright = 15 + (audioLevel_ / 10);
     for (int i = 0; i < totalLeds_; i++) {
-        leds_[i] += CHSV(baseHue + 128, 255, ambientBright);
+        leds_[i] += CHSV(ripple.baseHue + 128, 255, ambientBright);
     }
-    baseHue++;
+    ripple.baseHue++;
 
     // Decrease cooldown
-    if (spawnCooldown > 0) spawnCooldown--;
+    if (ripple.cooldown > 0) ripple.cooldown--;
 
     // Spawn new ripple on audio - lower threshold and faster spawning
-    if (audioLevel_ > 60 && spawnCooldown == 0) {
+    if (audioLevel_ > 60 && ripple.cooldown == 0) {
         // Spawn rate scales with audio intensity
         int spawnChance = map(audioLevel_, 60, 255, 30, 200);
         if (random8() < spawnChance) {
-            rippleX[nextRipple] = random8(ledsPerStrip_);
-            rippleY[nextRipple] = random8(numStrips_);
-            rippleHue[nextRipple] = baseHue + random8(64);
-            rippleAge[nextRipple] = 1;
-            nextRipple = (nextRipple + 1) % 8;
-            spawnCooldown = 3;  // Brief cooldown between spawns
+            ripple.x[ripple.next] = random8(ledsPerStrip_);
+            ripple.y[ripple.next] = random8(numStrips_);
+            ripple.hue[ripple.next] = ripple.baseHue + random8(64);
+            ripple.age[ripple.next] = 1;
+            ripple.next = (ripple.next + 1) % EffectState::RIPPLES;
+            ripple.cooldown = 3;  // Brief cooldown between spawns
         }
     }
 
     // Draw and age all active ripples
-    for (int r = 0; r < 8; r++) {
-        if (rippleAge[r] > 0 && rippleAge[r] < 60) {  // Longer lifespan
-            int radius = rippleAge[r];
-            uint8_t brightness = 255 - (rippleAge[r] * 4);  // Slower fade
+    for (int r = 0; r < EffectState::RIPPLES; r++) {
+        if (ripple.age[r] > 0 && ripple.age[r] < 60) {  // Longer lifespan
+            int radius = ripple.age[r];
+            uint8_t brightness = 255 - (ripple.age[r] * 4);  // Slower fade
 
             // Draw ripple ring with thicker edge
             for (int y = 0; y < numStrips_; y++) {
                 for (int x = 0; x < ledsPerStrip_; x++) {
-                    int dx = x - rippleX[r];
-                    int dy = (y - rippleY[r]) * 3;  // Scale Y since rows are fewer
+                    int dx = x - ripple.x[r];
+                    int dy = (y - ripple.y[r]) * 3;  // Scale Y since rows are fewer
                     int dist = sqrt16(dx * dx + dy * dy);
 
                     // Wider ring (radius -2 to +2)
@@ -941,64 +1361,61 @@ void LEDManager::animationRipple() {
                         int idx = xyToIndex(x, y);
                         if (idx >= 0) {
                             uint8_t fade = 255 - abs(dist - radius) * 50;
-                            leds_[idx] += CHSV(rippleHue[r], 255, scale8(brightness, fade));
+                            leds_[idx] += CHSV(ripple.hue[r], 255, scale8(brightness, fade));
                         }
                     }
                 }
             }
-            rippleAge[r]++;
+            ripple.age[r]++;
         }
     }
 }
 
 // New animation: Comet - shooting comets with trails
 void LEDManager::animationComet() {
-    static int16_t cometPos[3] = {0, 0, 0};          // Position along path
-    static int8_t cometRow[3] = {0, 2, 4};           // Which row each comet is on
-    static int8_t cometDir[3] = {1, -1, 1};          // Direction: 1 = right, -1 = left
-    static uint8_t cometHue[3] = {0, 85, 170};       // Color for each comet
+    EffectState::Comet& comet = effect_->comet;
 
     fadeAll(40);
 
-    for (int c = 0; c < min(3, numStrips_); c++) {
+    for (int c = 0; c < min((int)EffectState::COMETS, numStrips_); c++) {
         // Ensure comet row is valid
-        if (cometRow[c] >= numStrips_) {
-            cometRow[c] = c % numStrips_;
+        if (comet.row[c] >= numStrips_) {
+            comet.row[c] = c % numStrips_;
         }
 
         // Draw comet head and tail
         for (int t = 0; t < 12; t++) {
-            int x = cometPos[c] - (t * cometDir[c]);
+            int x = comet.pos[c] - (t * comet.dir[c]);
             if (x >= 0 && x < ledsPerStrip_) {
-                int idx = xyToIndex(x, cometRow[c]);
+                int idx = xyToIndex(x, comet.row[c]);
                 if (idx >= 0) {
                     uint8_t brightness = 255 - (t * 20);
-                    leds_[idx] += CHSV(cometHue[c], 200, brightness);
+                    leds_[idx] += CHSV(comet.hue[c], 200, brightness);
                 }
             }
         }
 
         // Move comet
-        cometPos[c] += cometDir[c] * 2;
+        comet.pos[c] += comet.dir[c] * 2;
 
         // Bounce or wrap to next row
-        if (cometPos[c] >= ledsPerStrip_ + 10) {
-            cometPos[c] = ledsPerStrip_ - 1;
-            cometDir[c] = -1;
-            cometRow[c] = (cometRow[c] + 1) % numStrips_;
-            cometHue[c] += 30;
-        } else if (cometPos[c] < -10) {
-            cometPos[c] = 0;
-            cometDir[c] = 1;
-            cometRow[c] = (cometRow[c] + 1) % numStrips_;
-            cometHue[c] += 30;
+        if (comet.pos[c] >= ledsPerStrip_ + 10) {
+            comet.pos[c] = ledsPerStrip_ - 1;
+            comet.dir[c] = -1;
+            comet.row[c] = (comet.row[c] + 1) % numStrips_;
+            comet.hue[c] += 30;
+        } else if (comet.pos[c] < -10) {
+            comet.pos[c] = 0;
+            comet.dir[c] = 1;
+            comet.row[c] = (comet.row[c] + 1) % numStrips_;
+            comet.hue[c] += 30;
         }
     }
 }
 
 // New animation: Confetti - audio-reactive colored dots with slow fade
 void LEDManager::animationConfetti() {
-    static uint8_t confettiHue = 0;
+    uint8_t confettiHue = effect_->phase;
 
     // Very gentle fade so dots linger and fade out smoothly
     fadeAll(3);
@@ -1027,7 +1444,6 @@ void LEDManager::animationConfetti() {
         leds_[pos] = CHSV(confettiHue + random8(96), sat, dotBright);
     }
 
-    confettiHue += 1;
 }
 
 // Legacy wrapper functions for backward compatibility
@@ -0,0 +1,183 @@
+#include "LayerCompositor.h"
+#include <new>
+
+static const char* const BLEND_NAMES[LayerCompositor::BLEND_COUNT] = {
+    "add", "screen", "multiply", "alpha", "max"
+};
+
+LayerCompositor::LayerCompositor()
+    : pool_(nullptr)
+    , capacity_(0)
+    , count_(0)
+    , pending_(false)
+    , pendingCount_(0)
+{
+    portMUX_INITIALIZE(&mux_);
+    memset(layers_, 0, sizeof(layers_));
+    memset(pendingLayers_, 0, sizeof(pendingLayers_));
+    for (uint8_t i = 0; i < MAX_LAYERS; i++) {
+        layers_[i].effect.reset();
+    }
+}
+
+LayerCompositor::~LayerCompositor() {
+    delete[] pool_;
+}
+
+bool LayerCompositor::begin(int capacity) {
+    if (pool_) {
+        return true;
+    }
+
+    pool_ = new (std::nothrow) CRGB[capacity * MAX_LAYERS];
+    if (!pool_) {
+        return false;
+    }
+    capacity_ = capacity;
+
+    for (uint8_t i = 0; i < MAX_LAYERS; i++) {
+        layers_[i].buffer = pool_ + i * capacity;
+    }
+    return true;
+}
+
+bool LayerCompositor::request(const Layer* layers, uint8_t count) {
+    if (count > MAX_LAYERS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (layers[i].blend >= BLEND_COUNT) {
+            return false;
+        }
+    }
+
+    portENTER_CRITICAL(&mux_);
+    memcpy(pendingLayers_, layers, sizeof(Layer) * count);
+    pendingCount_ = count;
+    pending_ = true;
+    portEXIT_CRITICAL(&mux_);
+    return true;
+}
+
+void LayerCompositor::applyPending(int pixels) {
+    if (!pending_) {
+        return;
+    }
+
+    Layer layers[MAX_LAYERS];
+    portENTER_CRITICAL(&mux_);
+    uint8_t count = pendingCount_;
+    memcpy(layers, pendingLayers_, sizeof(Layer) * count);
+    pending_ = false;
+    portEXIT_CRITICAL(&mux_);
+
+    if (!pool_ || pixels > capacity_) {
+        count_ = 0;
+        return;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        ActiveLayer& active = layers_[i];
+        // Same effect in the same slot keeps running (opacity/blend change)
+        bool keep = i < count_ && active.layer.effect == layers[i].effect;
+        active.layer = layers[i];
+        if (!keep) {
+            memset(active.buffer, 0, sizeof(CRGB) * pixels);
+            active.lastUpdate = 0;
+            active.effect.reset();
+        }
+        memset(&active.stats, 0, sizeof(active.stats));
+    }
+    count_ = count;
+}
+
+void LayerCompositor::clearBuffers(int pixels) {
+    if (!pool_ || pixels > capacity_) {
+        return;
+    }
+    for (uint8_t i = 0; i < count_; i++) {
+        memset(layers_[i].buffer, 0, sizeof(CRGB) * pixels);
+    }
+}
+
+void LayerCompositor::compose(CRGB* out, const CRGB* base, int pixels) {
+    memcpy(out, base, sizeof(CRGB) * pixels);
+
+    for (uint8_t i = 0; i < count_; i++) {
+        ActiveLayer& active = layers_[i];
+        unsigned long start = micros();
+        blend(out, active.buffer, pixels, (BlendMode)active.layer.blend, active.layer.opacity);
+        active.stats.blendUs += micros() - start;
+        active.stats.frames++;
+    }
+}
+
+// Kernels work on the frame as a flat byte array (CRGB is 3 packed bytes),
+// one tight loop per mode with the mode and opacity decisions hoisted out
+void LayerCompositor::blend(CRGB* dst, const CRGB* src, int pixels, BlendMode mode, uint8_t opacity) {
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+    const int bytes = pixels * 3;
+
+    if (opacity == 0) {
+        return;
+    }
+
+    switch (mode) {
+        case BLEND_ADD:
+            if (opacity == 255) {
+                for (int i = 0; i < bytes; i++) d[i] = qadd8(d[i], s[i]);
+            } else {
+                for (int i = 0; i < bytes; i++) d[i] = qadd8(d[i], scale8(s[i], opacity));
+            }
+            break;
+
+        case BLEND_SCREEN:
+            for (int i = 0; i < bytes; i++) {
+                uint8_t layer = scale8(s[i], opacity);
+                d[i] = 255 - scale8(255 - d[i], 255 - layer);
+            }
+            break;
+
+        case BLEND_MULTIPLY:
+            if (opacity == 255) {
+                for (int i = 0; i < bytes; i++) d[i] = scale8(d[i], s[i]);
+            } else {
+                for (int i = 0; i < bytes; i++) d[i] = blend8(d[i], scale8(d[i], s[i]), opacity);
+            }
+            break;
+
+        case BLEND_ALPHA:
+            if (opacity == 255) {
+                memcpy(d, s, bytes);
+            } else {
+                for (int i = 0; i < bytes; i++) d[i] = blend8(d[i], s[i], opacity);
+            }
+            break;
+
+        case BLEND_MAX:
+            for (int i = 0; i < bytes; i++) {
+                uint8_t layer = scale8(s[i], opacity);
+                if (layer > d[i]) d[i] = layer;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+const char* LayerCompositor::getBlendName(uint8_t mode) {
+    return mode < BLEND_COUNT ? BLEND_NAMES[mode] : "unknown";
+}
+
+LayerCompositor::BlendMode LayerCompositor::parseBlendName(const char* name) {
+    if (name) {
+        for (uint8_t i = 0; i < BLEND_COUNT; i++) {
+            if (strcmp(name, BLEND_NAMES[i]) == 0) {
+                return (BlendMode)i;
+            }
+        }
+    }
+    return BLEND_COUNT;
+}
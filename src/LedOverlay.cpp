@@ -0,0 +1,117 @@
+#include "LedOverlay.h"
+
+LedOverlay::LedOverlay()
+    : mode_(NONE)
+    , progress_(0)
+    , colour_(CRGB::Black)
+    , count_(0)
+    , periodMs_(0)
+    , startMs_(0)
+    , started_(false)
+    , generation_(0)
+    , covered_(0)
+{
+    portMUX_INITIALIZE(&mux_);
+}
+
+void LedOverlay::showProgress(uint8_t percent) {
+    portENTER_CRITICAL(&mux_);
+    progress_ = percent > 100 ? 100 : percent;
+    mode_ = PROGRESS;
+    generation_++;
+    portEXIT_CRITICAL(&mux_);
+}
+
+void LedOverlay::flash(CRGB colour, uint8_t count, uint16_t periodMs) {
+    portENTER_CRITICAL(&mux_);
+    colour_ = colour;
+    count_ = count;
+    periodMs_ = periodMs > 0 ? periodMs : 1;
+    started_ = false;
+    mode_ = FLASH;
+    generation_++;
+    portEXIT_CRITICAL(&mux_);
+}
+
+void LedOverlay::clear() {
+    portENTER_CRITICAL(&mux_);
+    mode_ = NONE;
+    generation_++;
+    portEXIT_CRITICAL(&mux_);
+}
+
+bool LedOverlay::render(CRGB* out, const CRGB* base, int numStrips, int ledsPerStrip) {
+    unsigned long now = millis();
+    covered_ = 0;
+
+    portENTER_CRITICAL(&mux_);
+    if (mode_ == FLASH && !started_) {
+        startMs_ = now;
+        started_ = true;
+    }
+    Mode mode = mode_;
+    uint8_t progress = progress_;
+    CRGB colour = colour_;
+    uint8_t count = count_;
+    uint16_t periodMs = periodMs_;
+    unsigned long startMs = startMs_;
+    uint32_t generation = generation_;
+    portEXIT_CRITICAL(&mux_);
+
+    bool lit = false;
+    if (mode == FLASH) {
+        unsigned long phase = (now - startMs) / periodMs;
+        if (phase >= 2UL * count) {
+            // Finished - unless another request came in meanwhile
+            portENTER_CRITICAL(&mux_);
+            if (generation_ == generation) {
+                mode_ = NONE;
+            }
+            portEXIT_CRITICAL(&mux_);
+            return false;
+        }
+        lit = (phase % 2) == 0;
+    } else if (mode == NONE) {
+        return false;
+    }
+
+    // Effect underneath as is - the output stage levels it with the rest
+    int total = numStrips * ledsPerStrip;
+    if (out != base) {
+        memcpy(out, base, sizeof(CRGB) * total);
+    }
+
+    if (mode == FLASH) {
+        if (lit) {
+            fill_solid(out, total, colour);
+            covered_ = ledsPerStrip;
+        }
+        return true;
+    }
+
+    // PROGRESS: every strip fills left to right in unison. Strips are
+    // snake-wired like LEDManager::xyToIndex() - even strips run reversed
+    if (progress >= 100) {
+        fill_solid(out, total, CRGB::Green);
+        covered_ = ledsPerStrip;
+        return true;
+    }
+
+    int length = (ledsPerStrip * progress) / 100;
+    for (int strip = 0; strip < numStrips; strip++) {
+        int stripStart = strip * ledsPerStrip;
+        bool reversed = (strip % 2 == 0);
+        for (int led = 0; led < length; led++) {
+            // Gradient from cyan (start) to green (end) along the strip
+            uint8_t ratio = (led * 255) / ledsPerStrip;
+            out[stripStart + (reversed ? ledsPerStrip - 1 - led : led)] = CHSV(96 + (ratio / 4), 255, 255);
+        }
+    }
+    covered_ = length;
+    return true;
+}
+
+void LedOverlay::getSpan(int strip, int ledsPerStrip, int& first, int& count) const {
+    count = min(covered_, ledsPerStrip);
+    first = (strip % 2 == 0) ? ledsPerStrip - count : 0;
+}
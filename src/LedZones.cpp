@@ -0,0 +1,184 @@
+#include "LedZones.h"
+#include <Preferences.h>
+
+LedZones::LedZones()
+    : definedCount_(0)
+    , pending_(false)
+    , count_(0)
+    , runCount_(0)
+    , dimmed_(false)
+{
+    portMUX_INITIALIZE(&mux_);
+    memset(defined_, 0, sizeof(defined_));
+    memset(zones_, 0, sizeof(zones_));
+    memset(states_, 0, sizeof(states_));
+    memset(runs_, 0, sizeof(runs_));
+    for (uint8_t i = 0; i < MAX_ZONES; i++) {
+        states_[i].effect.reset();
+    }
+    for (uint8_t i = 0; i <= MAX_ZONES; i++) {
+        runStates_[i].reset();
+    }
+}
+
+void LedZones::load() {
+    // Version, count, then count zones - nothing for unused slots
+    uint8_t stored[2 + sizeof(Zone) * MAX_ZONES];
+
+    Preferences prefs;
+    prefs.begin("led-config", true);
+    size_t length = prefs.isKey("zones") ? prefs.getBytes("zones", stored, sizeof(stored)) : 0;
+    prefs.end();
+
+    if (length < 2) {
+        return;
+    }
+
+    uint8_t count = stored[1];
+    const Zone* zones = (const Zone*)(stored + 2);
+    if (stored[0] != STORE_VERSION || count > MAX_ZONES ||
+        length != 2 + sizeof(Zone) * count || !validate(zones, count)) {
+        Serial.println("Saved LED zones invalid, ignoring");
+        return;
+    }
+
+    portENTER_CRITICAL(&mux_);
+    memcpy(defined_, zones, sizeof(Zone) * count);
+    definedCount_ = count;
+    pending_ = true;
+    portEXIT_CRITICAL(&mux_);
+    Serial.printf("Loaded %u LED zones\n", count);
+}
+
+bool LedZones::request(const Zone* zones, uint8_t count) {
+    if (count > MAX_ZONES || !validate(zones, count)) {
+        return false;
+    }
+
+    uint8_t stored[2 + sizeof(Zone) * MAX_ZONES];
+    stored[0] = STORE_VERSION;
+    stored[1] = count;
+    memcpy(stored + 2, zones, sizeof(Zone) * count);
+    size_t length = 2 + sizeof(Zone) * count;
+
+    Preferences prefs;
+    prefs.begin("led-config", false);
+    bool saved = count > 0 ? prefs.putBytes("zones", stored, length) == length
+                           : (!prefs.isKey("zones") || prefs.remove("zones"));
+    prefs.end();
+    if (!saved) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&mux_);
+    memcpy(defined_, zones, sizeof(Zone) * count);
+    definedCount_ = count;
+    pending_ = true;
+    portEXIT_CRITICAL(&mux_);
+    return true;
+}
+
+bool LedZones::applyPending(int numStrips, bool force) {
+    if (!pending_ && !force) {
+        return false;
+    }
+
+    Zone zones[MAX_ZONES];
+    portENTER_CRITICAL(&mux_);
+    uint8_t count = definedCount_;
+    memcpy(zones, defined_, sizeof(Zone) * count);
+    pending_ = false;
+    portEXIT_CRITICAL(&mux_);
+
+    // Keep the zones that fit this layout; a zone that keeps its effect on
+    // the same strips keeps running where it was
+    Zone previous[MAX_ZONES];
+    ZoneState previousStates[MAX_ZONES];
+    uint8_t previousCount = count_;
+    memcpy(previous, zones_, sizeof(previous));
+    memcpy(previousStates, states_, sizeof(previousStates));
+
+    count_ = 0;
+    dimmed_ = false;
+    for (uint8_t i = 0; i < count; i++) {
+        const Zone& zone = zones[i];
+        if (zone.firstStrip + zone.stripCount > numStrips) {
+            continue;
+        }
+
+        ZoneState state;
+        state.lastUpdate = 0;
+        state.effect.reset();
+        for (uint8_t j = 0; j < previousCount; j++) {
+            if (previous[j].firstStrip == zone.firstStrip && previous[j].stripCount == zone.stripCount &&
+                previous[j].effect == zone.effect) {
+                state = previousStates[j];
+                break;
+            }
+        }
+
+        zones_[count_] = zone;
+        states_[count_] = state;
+        count_++;
+        if (zone.brightness < 255) {
+            dimmed_ = true;
+        }
+    }
+
+    // Runs of strips outside every zone, in strip order. A run on the same
+    // strips as before keeps the main effect's state
+    Run previousRuns[MAX_ZONES + 1];
+    EffectState previousRunStates[MAX_ZONES + 1];
+    uint8_t previousRunCount = runCount_;
+    memcpy(previousRuns, runs_, sizeof(previousRuns));
+    memcpy(previousRunStates, runStates_, sizeof(previousRunStates));
+
+    runCount_ = 0;
+    for (int strip = 0; strip < numStrips; strip++) {
+        bool covered = false;
+        for (uint8_t i = 0; i < count_ && !covered; i++) {
+            covered = zones_[i].firstStrip <= strip && strip < zones_[i].firstStrip + zones_[i].stripCount;
+        }
+        if (covered) {
+            continue;
+        }
+
+        Run* last = runCount_ > 0 ? &runs_[runCount_ - 1] : nullptr;
+        if (last && last->firstStrip + last->stripCount == strip) {
+            last->stripCount++;
+        } else {
+            runs_[runCount_].firstStrip = strip;
+            runs_[runCount_].stripCount = 1;
+            runCount_++;
+        }
+    }
+
+    for (uint8_t i = 0; i < runCount_; i++) {
+        runStates_[i].reset();
+        for (uint8_t j = 0; j < previousRunCount; j++) {
+            if (previousRuns[j].firstStrip == runs_[i].firstStrip &&
+                previousRuns[j].stripCount == runs_[i].stripCount) {
+                runStates_[i] = previousRunStates[j];
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool LedZones::validate(const Zone* zones, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        const Zone& zone = zones[i];
+        if (zone.stripCount == 0 || memchr(zone.name, 0, NAME_LENGTH) == nullptr) {
+            return false;
+        }
+        for (uint8_t j = 0; j < i; j++) {
+            const Zone& other = zones[j];
+            if (zone.firstStrip < other.firstStrip + other.stripCount &&
+                other.firstStrip < zone.firstStrip + zone.stripCount) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#include "Metrics.h"
+
+#if METRICS_ENABLED
+
+#include <string.h>
+
+Metrics g_metrics;
+
+// Upper bounds (le) in microseconds - a 5 ms LED frame and a 30 ms LVGL
+// redraw land in the middle, a stalled loop at the top
+const uint32_t Metrics::BUCKET_BOUNDS_US[Metrics::BUCKET_COUNT - 1] = {
+    50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000
+};
+
+static const char* const HISTOGRAM_NAMES[Metrics::HISTOGRAM_COUNT] = {
+    "loop", "led_update", "led_render", "led_output", "led_show", "ui_update", "ui_render", "web_update"
+};
+
+static const char* const HISTOGRAM_HELP[Metrics::HISTOGRAM_COUNT] = {
+    "Main loop pass",
+    "LED update, render to show",
+    "Effects, zones and layers",
+    "Compositing, overlay, output LUT pass and power limit",
+    "FastLED.show()",
+    "UI update",
+    "LVGL timer handler (draw and input)",
+    "Web UI update (controls and streams)"
+};
+
+static const char* const GAUGE_NAMES[Metrics::GAUGE_COUNT] = {
+    "ws_queue_depth"
+};
+
+static const char* const GAUGE_HELP[Metrics::GAUGE_COUNT] = {
+    "Messages queued across state WebSocket clients"
+};
+
+Metrics::Metrics()
+#ifdef ARDUINO
+    : cyclesPerUs_(ESP.getCpuFreqMHz())
+#else
+    : cyclesPerUs_(1000)
+#endif
+{
+    memset(histograms_, 0, sizeof(histograms_));
+    memset(gauges_, 0, sizeof(gauges_));
+}
+
+void Metrics::observe(Histogram id, uint32_t cycles) {
+    uint32_t us = cycles / cyclesPerUs_;
+    HistogramData& histogram = histograms_[id];
+
+    uint8_t bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && us > BUCKET_BOUNDS_US[bucket]) {
+        bucket++;
+    }
+    histogram.buckets[bucket]++;
+    histogram.count++;
+    histogram.sumUs += us;
+}
+
+void Metrics::setGauge(Gauge id, uint32_t value) {
+    GaugeData& gauge = gauges_[id];
+    gauge.value = value;
+    if (value > gauge.peak) {
+        gauge.peak = value;
+    }
+}
+
+const char* Metrics::getHistogramName(uint8_t id) {
+    return id < HISTOGRAM_COUNT ? HISTOGRAM_NAMES[id] : "unknown";
+}
+
+const char* Metrics::getHistogramHelp(uint8_t id) {
+    return id < HISTOGRAM_COUNT ? HISTOGRAM_HELP[id] : "";
+}
+
+const char* Metrics::getGaugeName(uint8_t id) {
+    return id < GAUGE_COUNT ? GAUGE_NAMES[id] : "unknown";
+}
+
+const char* Metrics::getGaugeHelp(uint8_t id) {
+    return id < GAUGE_COUNT ? GAUGE_HELP[id] : "";
+}
+
+#endif
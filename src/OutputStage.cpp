@@ -0,0 +1,335 @@
+#include "OutputStage.h"
+#include "LedOverlay.h"
+#include "PowerLimiter.h"
+#include <Preferences.h>
+#include <math.h>
+#include <new>
+
+static const char* const ORDER_NAMES[OutputStage::ORDER_COUNT] = {
+    "RGB", "RBG", "GRB", "GBR", "BRG", "BGR"
+};
+
+// Logical channel (0 red, 1 green, 2 blue) sent in each wire slot
+static const uint8_t ORDER_CHANNELS[OutputStage::ORDER_COUNT][3] = {
+    {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+};
+
+OutputStage::OutputStage()
+    : pending_(false)
+    , gammaBuilt_(0)
+    , level_(0)
+    , stale_(true)
+    , error_(nullptr)
+    , capacity_(0)
+    , lastFrameUs_(0)
+    , frameIntervalUs_(0)
+{
+    portMUX_INITIALIZE(&mux_);
+    defined_ = defaults();
+    settings_ = defined_;
+    memset(gammaTable_, 0, sizeof(gammaTable_));
+    memset(luts_, 0, sizeof(luts_));
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+OutputStage::~OutputStage() {
+    delete[] error_;
+}
+
+bool OutputStage::begin(int capacity) {
+    if (error_) {
+        return true;
+    }
+
+    error_ = new (std::nothrow) uint8_t[capacity * 3];
+    if (!error_) {
+        return false;
+    }
+    capacity_ = capacity;
+    clearDither();
+    return true;
+}
+
+void OutputStage::clearDither() {
+    if (error_) {
+        memset(error_, 0, capacity_ * 3);
+    }
+}
+
+OutputStage::Settings OutputStage::defaults() {
+    Settings settings;
+    memset(&settings, 0, sizeof(settings));
+    settings.gamma = GAMMA_LINEAR;
+    settings.order = ORDER_GRB;
+    memset(settings.correction, 255, sizeof(settings.correction));
+    return settings;
+}
+
+void OutputStage::load() {
+    uint8_t stored[1 + sizeof(Settings)];
+
+    Preferences prefs;
+    prefs.begin("led-config", true);
+    size_t length = prefs.isKey("output") ? prefs.getBytes("output", stored, sizeof(stored)) : 0;
+    prefs.end();
+
+    if (length == 0) {
+        return;
+    }
+
+    Settings settings;
+    memcpy(&settings, stored + 1, sizeof(settings));
+    if (stored[0] != STORE_VERSION || length != sizeof(stored) || !validate(settings)) {
+        Serial.println("Saved output settings invalid, ignoring");
+        return;
+    }
+
+    portENTER_CRITICAL(&mux_);
+    defined_ = settings;
+    pending_ = true;
+    portEXIT_CRITICAL(&mux_);
+}
+
+bool OutputStage::request(const Settings& settings) {
+    if (!validate(settings)) {
+        return false;
+    }
+
+    uint8_t stored[1 + sizeof(Settings)];
+    stored[0] = STORE_VERSION;
+    memcpy(stored + 1, &settings, sizeof(settings));
+
+    Preferences prefs;
+    prefs.begin("led-config", false);
+    bool saved = prefs.putBytes("output", stored, sizeof(stored)) == sizeof(stored);
+    prefs.end();
+    if (!saved) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&mux_);
+    defined_ = settings;
+    pending_ = true;
+    portEXIT_CRITICAL(&mux_);
+    return true;
+}
+
+OutputStage::Settings OutputStage::getSettings() const {
+    portENTER_CRITICAL(&mux_);
+    Settings settings = defined_;
+    portEXIT_CRITICAL(&mux_);
+    return settings;
+}
+
+void OutputStage::prepare(uint8_t level) {
+    if (pending_) {
+        portENTER_CRITICAL(&mux_);
+        settings_ = defined_;
+        pending_ = false;
+        portEXIT_CRITICAL(&mux_);
+        stale_ = true;
+    }
+
+    if (stale_ || level != level_) {
+        rebuild(level);
+    }
+    updateFrameRate();
+}
+
+void OutputStage::updateFrameRate() {
+    unsigned long now = micros();
+    if (lastFrameUs_ != 0) {
+        uint32_t interval = now - lastFrameUs_;
+        frameIntervalUs_ = frameIntervalUs_ ? frameIntervalUs_ - frameIntervalUs_ / 8 + interval / 8 : interval;
+    }
+    lastFrameUs_ = now;
+
+    stats_.fps = frameIntervalUs_ ? (uint16_t)min(1000000UL / frameIntervalUs_, 65535UL) : 0;
+
+    // Hysteresis so a frame rate near the threshold doesn't toggle it; the
+    // error restarts from zero so a stale one doesn't flash on resume
+    bool dither = error_ && (stats_.dithering ? stats_.fps >= DITHER_OFF_FPS : stats_.fps >= DITHER_ON_FPS);
+    if (dither && !stats_.dithering) {
+        clearDither();
+    }
+    stats_.dithering = dither;
+}
+
+void OutputStage::rebuild(uint8_t level) {
+    unsigned long start = micros();
+
+    if (gammaBuilt_ != settings_.gamma) {
+        float gamma = settings_.gamma / 10.0f;
+        for (int v = 0; v < 256; v++) {
+            gammaTable_[v] = settings_.gamma == GAMMA_LINEAR
+                ? (uint16_t)(v << 8)
+                : (uint16_t)(powf(v / 255.0f, gamma) * 65280.0f + 0.5f);
+        }
+        gammaBuilt_ = settings_.gamma;
+    }
+
+    // Level and gains combine into one 16-bit factor per channel, kept wide
+    // so low levels don't lose the fraction. (level + 1) * 256 at full gain
+    // makes the integer part exactly FastLED's scale8(), so the defaults
+    // match its own brightness scaling
+    const uint8_t* order = ORDER_CHANNELS[settings_.order];
+    for (uint8_t i = 0; i <= settings_.calibrationCount; i++) {
+        Lut& lut = luts_[i];
+        for (uint8_t slot = 0; slot < 3; slot++) {
+            uint8_t channel = order[slot];
+            uint8_t gain = settings_.correction[channel];
+            if (i > 0) {
+                gain = scale8(gain, settings_.calibrations[i - 1].balance[channel]);
+            }
+            uint32_t factor = (level == 0 || gain == 0) ? 0 : (uint32_t)(level + 1) * (gain + 1);
+            lut.overlay[slot] = gain == 0 ? 0 : (uint32_t)(LedOverlay::LEVEL + 1) * (gain + 1);
+            for (int v = 0; v < 256; v++) {
+                lut.slot[slot][v] = (uint16_t)(((uint32_t)gammaTable_[v] * factor) >> 16);
+            }
+        }
+    }
+
+    level_ = level;
+    stale_ = false;
+    stats_.rebuilds++;
+    stats_.rebuildUs += micros() - start;
+}
+
+uint8_t OutputStage::findLut(int strip) const {
+    for (uint8_t i = 0; i < settings_.calibrationCount; i++) {
+        const Calibration& calibration = settings_.calibrations[i];
+        if (calibration.firstStrip <= strip && strip < calibration.firstStrip + calibration.stripCount) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// A strip at a time: each strip has one table set and at most one supply,
+// and its publish copy is made while it is still in cache. Channel sums are
+// cheap next to the table reads, so every strip is summed
+void OutputStage::render(CRGB* out, const CRGB* frame, CRGB* publish, int numStrips, int ledsPerStrip,
+                         PowerLimiter* limiter, const LedOverlay* overlay) {
+    unsigned long start = micros();
+    const uint8_t* order = ORDER_CHANNELS[settings_.order];
+    const uint8_t in0 = order[0], in1 = order[1], in2 = order[2];
+    const bool dither = stats_.dithering && numStrips * ledsPerStrip <= capacity_;
+
+    for (int strip = 0; strip < numStrips; strip++) {
+        const Lut& lut = luts_[findLut(strip)];
+        const uint16_t* slot0 = lut.slot[0];
+        const uint16_t* slot1 = lut.slot[1];
+        const uint16_t* slot2 = lut.slot[2];
+        const uint8_t* src = (const uint8_t*)(frame + strip * ledsPerStrip);
+        uint8_t* dst = (uint8_t*)(out + strip * ledsPerStrip);
+        uint32_t sums[3] = {0, 0, 0};
+
+        if (dither) {
+            // Send the integer part, carry the fraction to the next frame
+            uint8_t* error = error_ + strip * ledsPerStrip * 3;
+            for (int i = 0; i < ledsPerStrip; i++, src += 3, dst += 3, error += 3) {
+                uint16_t a = slot0[src[in0]] + error[0];
+                uint16_t b = slot1[src[in1]] + error[1];
+                uint16_t c = slot2[src[in2]] + error[2];
+                dst[0] = a >> 8;
+                dst[1] = b >> 8;
+                dst[2] = c >> 8;
+                error[0] = (uint8_t)a;
+                error[1] = (uint8_t)b;
+                error[2] = (uint8_t)c;
+                sums[0] += dst[0];
+                sums[1] += dst[1];
+                sums[2] += dst[2];
+            }
+        } else {
+            for (int i = 0; i < ledsPerStrip; i++, src += 3, dst += 3) {
+                dst[0] = slot0[src[in0]] >> 8;
+                dst[1] = slot1[src[in1]] >> 8;
+                dst[2] = slot2[src[in2]] >> 8;
+                sums[0] += dst[0];
+                sums[1] += dst[1];
+                sums[2] += dst[2];
+            }
+        }
+
+        if (overlay) {
+            // Rarely more than a progress bar: redo its pixels rather than
+            // split the loops above
+            int first, count;
+            overlay->getSpan(strip, ledsPerStrip, first, count);
+            src = (const uint8_t*)(frame + strip * ledsPerStrip + first);
+            dst = (uint8_t*)(out + strip * ledsPerStrip + first);
+            for (int i = 0; i < count; i++, src += 3, dst += 3) {
+                sums[0] -= dst[0];
+                sums[1] -= dst[1];
+                sums[2] -= dst[2];
+                dst[0] = ((uint32_t)gammaTable_[src[in0]] * lut.overlay[0]) >> 24;
+                dst[1] = ((uint32_t)gammaTable_[src[in1]] * lut.overlay[1]) >> 24;
+                dst[2] = ((uint32_t)gammaTable_[src[in2]] * lut.overlay[2]) >> 24;
+                sums[0] += dst[0];
+                sums[1] += dst[1];
+                sums[2] += dst[2];
+            }
+        }
+
+        int supply = limiter ? limiter->findSupply(strip) : -1;
+        if (supply >= 0) {
+            // Back to red, green, blue
+            uint32_t channels[3];
+            channels[in0] = sums[0];
+            channels[in1] = sums[1];
+            channels[in2] = sums[2];
+            limiter->addStrip(supply, channels[0], channels[1], channels[2], ledsPerStrip);
+        }
+
+        if (publish) {
+            memcpy(publish + strip * ledsPerStrip, frame + strip * ledsPerStrip, sizeof(CRGB) * ledsPerStrip);
+        }
+    }
+
+    uint32_t elapsed = micros() - start;
+    if (dither) {
+        stats_.ditherUs += elapsed;
+        stats_.ditherFrames++;
+    } else {
+        stats_.passUs += elapsed;
+        stats_.frames++;
+    }
+    stats_.pixels = numStrips * ledsPerStrip;
+}
+
+const char* OutputStage::getOrderName(uint8_t order) {
+    return order < ORDER_COUNT ? ORDER_NAMES[order] : "unknown";
+}
+
+OutputStage::ColourOrder OutputStage::parseOrderName(const char* name) {
+    if (name) {
+        for (uint8_t i = 0; i < ORDER_COUNT; i++) {
+            if (strcmp(name, ORDER_NAMES[i]) == 0) {
+                return (ColourOrder)i;
+            }
+        }
+    }
+    return ORDER_COUNT;
+}
+
+bool OutputStage::validate(const Settings& settings) {
+    if (settings.gamma < GAMMA_LINEAR || settings.gamma > 30 || settings.order >= ORDER_COUNT ||
+        settings.calibrationCount > MAX_CALIBRATIONS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < settings.calibrationCount; i++) {
+        const Calibration& calibration = settings.calibrations[i];
+        if (calibration.stripCount == 0) {
+            return false;
+        }
+        for (uint8_t j = 0; j < i; j++) {
+            const Calibration& other = settings.calibrations[j];
+            if (calibration.firstStrip < other.firstStrip + other.stripCount &&
+                other.firstStrip < calibration.firstStrip + calibration.stripCount) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,184 @@
+#include "PowerLimiter.h"
+#include <Preferences.h>
+
+PowerLimiter::PowerLimiter()
+    : definedCount_(0)
+    , pending_(false)
+    , count_(0)
+    , frames_(0)
+    , totalUs_(0)
+{
+    portMUX_INITIALIZE(&mux_);
+    memset(defined_, 0, sizeof(defined_));
+    memset(supplies_, 0, sizeof(supplies_));
+    memset(stats_, 0, sizeof(stats_));
+    memset(sums_, 0, sizeof(sums_));
+}
+
+void PowerLimiter::load() {
+    // Version, count, then count supplies
+    uint8_t stored[2 + sizeof(Supply) * MAX_SUPPLIES];
+
+    Preferences prefs;
+    prefs.begin("led-config", true);
+    size_t length = prefs.isKey("power") ? prefs.getBytes("power", stored, sizeof(stored)) : 0;
+    prefs.end();
+
+    if (length < 2) {
+        return;
+    }
+
+    uint8_t count = stored[1];
+    Supply supplies[MAX_SUPPLIES];
+    if (stored[0] != STORE_VERSION || count > MAX_SUPPLIES || length != 2 + sizeof(Supply) * count) {
+        Serial.println("Saved power budget invalid, ignoring");
+        return;
+    }
+    memcpy(supplies, stored + 2, sizeof(Supply) * count);
+    if (!validate(supplies, count)) {
+        Serial.println("Saved power budget invalid, ignoring");
+        return;
+    }
+
+    portENTER_CRITICAL(&mux_);
+    memcpy(defined_, supplies, sizeof(Supply) * count);
+    definedCount_ = count;
+    pending_ = true;
+    portEXIT_CRITICAL(&mux_);
+    Serial.printf("Loaded power budget for %u supplies\n", count);
+}
+
+bool PowerLimiter::request(const Supply* supplies, uint8_t count) {
+    if (count > MAX_SUPPLIES || !validate(supplies, count)) {
+        return false;
+    }
+
+    uint8_t stored[2 + sizeof(Supply) * MAX_SUPPLIES];
+    stored[0] = STORE_VERSION;
+    stored[1] = count;
+    memcpy(stored + 2, supplies, sizeof(Supply) * count);
+    size_t length = 2 + sizeof(Supply) * count;
+
+    Preferences prefs;
+    prefs.begin("led-config", false);
+    bool saved = count > 0 ? prefs.putBytes("power", stored, length) == length
+                           : (!prefs.isKey("power") || prefs.remove("power"));
+    prefs.end();
+    if (!saved) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&mux_);
+    memcpy(defined_, supplies, sizeof(Supply) * count);
+    definedCount_ = count;
+    pending_ = true;
+    portEXIT_CRITICAL(&mux_);
+    return true;
+}
+
+void PowerLimiter::applyPending() {
+    if (!pending_) {
+        return;
+    }
+
+    portENTER_CRITICAL(&mux_);
+    count_ = definedCount_;
+    memcpy(supplies_, defined_, sizeof(Supply) * count_);
+    pending_ = false;
+    portEXIT_CRITICAL(&mux_);
+
+    memset(stats_, 0, sizeof(stats_));
+    for (uint8_t i = 0; i < count_; i++) {
+        stats_[i].scale = 255;
+    }
+    frames_ = 0;
+    totalUs_ = 0;
+}
+
+void PowerLimiter::beginFrame() {
+    memset(sums_, 0, sizeof(sums_));
+}
+
+int PowerLimiter::findSupply(int strip) const {
+    for (uint8_t i = 0; i < count_; i++) {
+        if (supplies_[i].firstStrip <= strip && strip < supplies_[i].firstStrip + supplies_[i].stripCount) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void PowerLimiter::addStrip(int supply, uint32_t red, uint32_t green, uint32_t blue, uint32_t pixels) {
+    Sums& sums = sums_[supply];
+    sums.red += red;
+    sums.green += green;
+    sums.blue += blue;
+    sums.pixels += pixels;
+}
+
+uint8_t PowerLimiter::limit(CRGB* frame, int numStrips, int ledsPerStrip, uint8_t level) {
+    unsigned long start = micros();
+    uint8_t shownLevel = level;
+
+    for (uint8_t i = 0; i < count_; i++) {
+        const Supply& supply = supplies_[i];
+        const Sums& sums = sums_[i];
+        SupplyStats& stats = stats_[i];
+
+        // Channel sums are 0-255 per pixel; level scales them again on show()
+        uint64_t weighted = (uint64_t)sums.red * RED_MA + (uint64_t)sums.green * GREEN_MA +
+                            (uint64_t)sums.blue * BLUE_MA;
+        uint32_t driveMa = (uint32_t)(weighted * level / (255 * 255));
+        uint32_t idleMa = sums.pixels * IDLE_MA;
+        uint32_t estimatedMa = idleMa + driveMa;
+
+        stats.estimatedMa = estimatedMa;
+        if (estimatedMa > stats.peakMa) {
+            stats.peakMa = estimatedMa;
+        }
+
+        if (estimatedMa <= supply.budgetMa) {
+            stats.scale = 255;
+            continue;
+        }
+
+        uint32_t scale = supply.budgetMa > idleMa ? (supply.budgetMa - idleMa) * 255 / driveMa : 0;
+        if (scale > 254) {
+            scale = 254;
+        }
+        if (stats.scale == 255) {
+            stats.throttleEvents++;
+        }
+        stats.scale = (uint8_t)scale;
+        stats.throttledFrames++;
+
+        if (count_ == 1 && supply.firstStrip == 0 && supply.stripCount >= numStrips) {
+            shownLevel = scale8(level, (uint8_t)scale);
+        } else {
+            int firstStrip = supply.firstStrip;
+            int strips = min((int)supply.stripCount, numStrips - firstStrip);
+            nscale8(frame + firstStrip * ledsPerStrip, strips * ledsPerStrip, (uint8_t)scale);
+        }
+    }
+
+    totalUs_ += micros() - start;
+    frames_++;
+    return shownLevel;
+}
+
+bool PowerLimiter::validate(const Supply* supplies, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        const Supply& supply = supplies[i];
+        if (supply.stripCount == 0 || supply.budgetMa == 0) {
+            return false;
+        }
+        for (uint8_t j = 0; j < i; j++) {
+            const Supply& other = supplies[j];
+            if (supply.firstStrip < other.firstStrip + other.stripCount &&
+                other.firstStrip < supply.firstStrip + supply.stripCount) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,166 @@
+#include "SpectrumStreamer.h"
+
+SpectrumStreamer::SpectrumStreamer(AsyncWebSocket* webSocket)
+    : webSocket_(webSocket)
+    , stats_()
+{
+    portMUX_INITIALIZE(&mux_);
+    memset(subscribers_, 0, sizeof(subscribers_));
+}
+
+bool SpectrumStreamer::subscribe(uint32_t clientId, uint8_t hz) {
+    if (hz > MAX_HZ) {
+        hz = MAX_HZ;
+    }
+
+    bool found = false;
+    portENTER_CRITICAL(&mux_);
+    Subscriber* slot = nullptr;
+    for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        if (subscribers_[i].id == clientId) {
+            slot = &subscribers_[i];
+            break;
+        }
+        if (!slot && subscribers_[i].id == 0) {
+            slot = &subscribers_[i];
+        }
+    }
+    if (slot && (slot->id == clientId || hz > 0)) {
+        slot->id = clientId;
+        slot->hz = hz;
+        slot->changed = true;
+        found = true;
+    }
+    portEXIT_CRITICAL(&mux_);
+
+    return found || hz == 0;
+}
+
+void SpectrumStreamer::removeClient(uint32_t clientId) {
+    subscribe(clientId, 0);
+}
+
+void SpectrumStreamer::applySubscriptionChanges() {
+    for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        Subscriber& sub = subscribers_[i];
+
+        portENTER_CRITICAL(&mux_);
+        bool changed = sub.changed;
+        uint8_t hz = sub.hz;
+        sub.changed = false;
+        if (changed && hz == 0) {
+            sub.id = 0;     // Slot is free again
+        }
+        portEXIT_CRITICAL(&mux_);
+
+        if (!changed) {
+            continue;
+        }
+
+        sub.minIntervalMs = hz > 0 ? 1000 / hz : 0;
+        sub.intervalMs = sub.minIntervalMs;
+        sub.cleanSends = 0;
+        sub.lastSeq = 0;
+        sub.lastSent = 0;
+    }
+}
+
+void SpectrumStreamer::update() {
+    if (!webSocket_) {
+        return;
+    }
+
+    applySubscriptionChanges();
+
+    uint8_t active = 0;
+    uint8_t throttled = 0;
+    for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        if (subscribers_[i].minIntervalMs > 0) {
+            active++;
+            if (subscribers_[i].intervalMs > subscribers_[i].minIntervalMs) {
+                throttled++;
+            }
+        }
+    }
+    stats_.subscribers = active;
+    stats_.throttled = throttled;
+
+    if (active == 0) {
+        return;
+    }
+
+    uint32_t seq = g_audioSnapshot.getSequence();
+    unsigned long now = millis();
+
+    uint8_t message[MESSAGE_SIZE];
+    size_t length = 0;
+
+    for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        Subscriber& sub = subscribers_[i];
+        if (sub.minIntervalMs == 0 || sub.lastSeq == seq) {
+            continue;
+        }
+        if (now - sub.lastSent < sub.intervalMs) {
+            continue;
+        }
+
+        AsyncWebSocketClient* client = webSocket_->client(sub.id);
+        if (!client || client->status() != WS_CONNECTED) {
+            continue;
+        }
+        if (client->queueIsFull()) {
+            // Halve this client's rate; the readings are simply dropped
+            stats_.skipped++;
+            sub.lastSent = now;
+            sub.cleanSends = 0;
+            if (sub.intervalMs < MAX_INTERVAL_MS) {
+                uint16_t interval = sub.intervalMs * 2;
+                sub.intervalMs = interval < MAX_INTERVAL_MS ? interval : (uint16_t)MAX_INTERVAL_MS;
+                stats_.backoffs++;
+            }
+            continue;
+        }
+
+        if (length == 0) {
+            // Built once, shared by every client due this pass
+            AudioSnapshot::Levels levels;
+            if (!g_audioSnapshot.read(levels)) {
+                return;
+            }
+            seq = levels.seq;
+            length = encode(levels, message);
+        }
+
+        client->binary((const char*)message, length);
+        sub.lastSeq = seq;
+        sub.lastSent = now;
+        stats_.messagesSent++;
+        stats_.bytesSent += length;
+
+        // Step back towards the requested rate once the client keeps up
+        if (sub.intervalMs > sub.minIntervalMs && ++sub.cleanSends >= RECOVER_AFTER) {
+            uint16_t interval = sub.intervalMs - sub.intervalMs / 4;
+            sub.intervalMs = interval > sub.minIntervalMs ? interval : sub.minIntervalMs;
+            sub.cleanSends = 0;
+        }
+    }
+}
+
+size_t SpectrumStreamer::encode(const AudioSnapshot::Levels& levels, uint8_t* message) {
+    const uint8_t bands = AudioSnapshot::NUM_BANDS;
+
+    message[0] = ControlProtocol::MSG_SPECTRUM;
+    message[1] = bands;
+    message[2] = levels.seq & 0xFF;
+    message[3] = (levels.seq >> 8) & 0xFF;
+    message[4] = (levels.seq >> 16) & 0xFF;
+    message[5] = levels.seq >> 24;
+    message[6] = levels.level;
+    memcpy(message + ControlProtocol::SPECTRUM_HEADER_SIZE, levels.bands, bands);
+    memcpy(message + ControlProtocol::SPECTRUM_HEADER_SIZE + bands, levels.peaks, bands);
+    return ControlProtocol::SPECTRUM_HEADER_SIZE + bands * 2;
+}
+
+SpectrumStreamer::Stats SpectrumStreamer::getStats() const {
+    return stats_;
+}
@@ -0,0 +1,352 @@
+#include "StateBroadcaster.h"
+#include "LEDManager.h"
+#include "ColourWheel.h"
+#include <Logger.h>
+#include <Preferences.h>
+
+extern ColourWheel* g_colourWheel;
+
+StateBroadcaster::StateBroadcaster(AsyncWebSocket* webSocket)
+    : webSocket_(webSocket)
+    , intervalMs_(DEFAULT_INTERVAL_MS)
+    , lastFlush_(0)
+    , pending_(false)
+    , pendingNotifications_(0)
+    , lastSent_()
+    , haveLastSent_(false)
+    , fullMessageBytes_(0)
+    , clientCount_(0)
+    , stats_()
+    , fullState_()
+    , fullStateSnapshot_()
+{
+    portMUX_INITIALIZE(&mux_);
+}
+
+void StateBroadcaster::begin() {
+    Preferences prefs;
+    prefs.begin("web-config", true); // Read-only
+    intervalMs_ = prefs.getUInt("ws_interval", DEFAULT_INTERVAL_MS);
+    prefs.end();
+
+    Snapshot current;
+    captureSnapshot(current);
+    getFullState(current);
+    Logger.info("State broadcast interval: %lu ms", (unsigned long)intervalMs_);
+}
+
+void StateBroadcaster::setInterval(uint32_t intervalMs) {
+    if (intervalMs > 1000) {
+        intervalMs = 1000;  // Keep the web UI responsive
+    }
+    intervalMs_ = intervalMs;
+
+    Preferences prefs;
+    prefs.begin("web-config", false);
+    prefs.putUInt("ws_interval", intervalMs);
+    prefs.end();
+}
+
+void StateBroadcaster::markDirty() {
+    portENTER_CRITICAL(&mux_);
+    pending_ = true;
+    pendingNotifications_++;
+    portEXIT_CRITICAL(&mux_);
+}
+
+void StateBroadcaster::addClient(uint32_t clientId) {
+    portENTER_CRITICAL(&mux_);
+    if (clientCount_ < DEFAULT_MAX_WS_CLIENTS) {
+        clients_[clientCount_].id = clientId;
+        clients_[clientCount_].needsResync = false;
+        clientCount_++;
+    }
+    portEXIT_CRITICAL(&mux_);
+}
+
+void StateBroadcaster::removeClient(uint32_t clientId) {
+    portENTER_CRITICAL(&mux_);
+    for (uint8_t i = 0; i < clientCount_; i++) {
+        if (clients_[i].id == clientId) {
+            clients_[i] = clients_[clientCount_ - 1];
+            clientCount_--;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&mux_);
+}
+
+void StateBroadcaster::requestFullState(uint32_t clientId) {
+    setNeedsResync(clientId, true);
+}
+
+void StateBroadcaster::setNeedsResync(uint32_t clientId, bool needsResync) {
+    portENTER_CRITICAL(&mux_);
+    for (uint8_t i = 0; i < clientCount_; i++) {
+        if (clients_[i].id == clientId) {
+            clients_[i].needsResync = needsResync;
+        }
+    }
+    portEXIT_CRITICAL(&mux_);
+}
+
+void StateBroadcaster::update() {
+    if (!webSocket_) {
+        return;
+    }
+
+    sendResyncs();
+
+    if (!pending_) {
+        return;
+    }
+
+    unsigned long now = millis();
+    if (now - lastFlush_ < intervalMs_) {
+        return;  // Coalesce with whatever else changes before the interval ends
+    }
+    lastFlush_ = now;
+
+    portENTER_CRITICAL(&mux_);
+    uint32_t notifications = pendingNotifications_;
+    pendingNotifications_ = 0;
+    pending_ = false;
+    portEXIT_CRITICAL(&mux_);
+
+    stats_.notifications += notifications;
+
+    if (clientCount_ == 0) {
+        // Nobody subscribed to state - skip snapshot and serialization, and
+        // diff against the real state once someone subscribes
+        stats_.coalesced += notifications;
+        haveLastSent_ = false;
+        return;
+    }
+
+    Snapshot current;
+    captureSnapshot(current);
+    uint8_t changed = haveLastSent_ ? diff(lastSent_, current) : (uint8_t)FIELD_ALL;
+    lastSent_ = current;
+    haveLastSent_ = true;
+
+    if (changed == 0) {
+        stats_.unchanged++;
+        stats_.coalesced += notifications;
+        return;
+    }
+    stats_.coalesced += notifications - 1;
+
+    AsyncWebSocketSharedBuffer message = (changed == FIELD_ALL) ? getFullState(current)
+                                                                : serializeState(current, changed);
+    if (!message) {
+        return;
+    }
+
+    // Copy the client list so the lock isn't held while queueing
+    ClientSlot clients[DEFAULT_MAX_WS_CLIENTS];
+    portENTER_CRITICAL(&mux_);
+    uint8_t clientCount = clientCount_;
+    memcpy(clients, clients_, sizeof(ClientSlot) * clientCount);
+    portEXIT_CRITICAL(&mux_);
+
+    for (uint8_t i = 0; i < clientCount; i++) {
+        if (clients[i].needsResync) {
+            continue;  // Gets a full state once its queue drains
+        }
+
+        AsyncWebSocketClient* client = webSocket_->client(clients[i].id);
+        if (!client || client->status() != WS_CONNECTED) {
+            continue;
+        }
+
+        if (client->queueIsFull()) {
+            // Drop the superseded delta - a full state replaces it later
+            stats_.dropped++;
+            setNeedsResync(clients[i].id, true);
+            continue;
+        }
+
+        sendBuffer(client, message);
+
+        uint32_t fullBytes = notifications * fullMessageBytes_;
+        if (fullBytes > message->size()) {
+            stats_.bytesSaved += fullBytes - message->size();
+        }
+    }
+}
+
+uint32_t StateBroadcaster::getQueueDepth() {
+    ClientSlot clients[DEFAULT_MAX_WS_CLIENTS];
+    portENTER_CRITICAL(&mux_);
+    uint8_t clientCount = clientCount_;
+    memcpy(clients, clients_, sizeof(ClientSlot) * clientCount);
+    portEXIT_CRITICAL(&mux_);
+
+    uint32_t depth = 0;
+    for (uint8_t i = 0; i < clientCount; i++) {
+        AsyncWebSocketClient* client = webSocket_->client(clients[i].id);
+        if (client) {
+            depth += client->queueLen();
+        }
+    }
+    return depth;
+}
+
+void StateBroadcaster::sendResyncs() {
+    ClientSlot clients[DEFAULT_MAX_WS_CLIENTS];
+    portENTER_CRITICAL(&mux_);
+    uint8_t clientCount = clientCount_;
+    memcpy(clients, clients_, sizeof(ClientSlot) * clientCount);
+    portEXIT_CRITICAL(&mux_);
+
+    AsyncWebSocketSharedBuffer fullState;
+
+    for (uint8_t i = 0; i < clientCount; i++) {
+        if (!clients[i].needsResync) {
+            continue;
+        }
+
+        AsyncWebSocketClient* client = webSocket_->client(clients[i].id);
+        if (!client) {
+            continue;  // Removed on disconnect
+        }
+        if (client->queueIsFull()) {
+            continue;  // Still backed up
+        }
+
+        if (!fullState) {
+            // One full state shared by every client resyncing this pass
+            Snapshot current;
+            captureSnapshot(current);
+            fullState = getFullState(current);
+            if (!fullState) {
+                return;
+            }
+        }
+
+        if (sendBuffer(client, fullState)) {
+            stats_.resyncs++;
+            setNeedsResync(clients[i].id, false);
+        }
+    }
+}
+
+AsyncWebSocketSharedBuffer StateBroadcaster::getFullState(const Snapshot& current) {
+    if (fullState_ && diff(fullStateSnapshot_, current) == 0) {
+        return fullState_;
+    }
+
+    fullState_ = serializeState(current, FIELD_ALL);
+    fullStateSnapshot_ = current;
+    if (fullState_) {
+        fullMessageBytes_ = fullState_->size();
+    }
+    return fullState_;
+}
+
+bool StateBroadcaster::sendBuffer(AsyncWebSocketClient* client, const AsyncWebSocketSharedBuffer& message) {
+    if (!client || client->status() != WS_CONNECTED) {
+        return false;
+    }
+
+    // The client's queue references the shared buffer - no copy per client
+    if (!client->text(message)) {
+        return false;
+    }
+    stats_.messagesSent++;
+    stats_.bytesSent += message->size();
+    return true;
+}
+
+AsyncWebSocketSharedBuffer StateBroadcaster::serialize(const JsonDocument& doc) {
+    size_t length = measureJson(doc);
+    AsyncWebSocketSharedBuffer buffer;
+    try {
+        // One allocation for the control block and vector, one for the data
+        buffer = std::make_shared<std::vector<uint8_t>>(length + 1);
+    } catch (...) {
+        return nullptr;
+    }
+    serializeJson(doc, buffer->data(), buffer->size());
+    buffer->resize(length);  // Drop the terminator - shrinking never reallocates
+    return buffer;
+}
+
+AsyncWebSocketSharedBuffer StateBroadcaster::serializeState(const Snapshot& snapshot, uint8_t fields) {
+    JsonDocument doc(&arena_);
+    doc["message"] = "states";
+    appendControls(doc["controls"].to<JsonArray>(), snapshot, fields);
+
+    AsyncWebSocketSharedBuffer buffer = serialize(doc);
+    if (!buffer) {
+        stats_.serializeFailures++;
+        Logger.warning("State message dropped - out of memory");
+        return nullptr;
+    }
+    stats_.serialized++;
+    return buffer;
+}
+
+void StateBroadcaster::captureSnapshot(Snapshot& snapshot) const {
+    snapshot.vu = vu;
+    snapshot.white = white;
+    snapshot.animation = showAnimation;
+    snapshot.animationIndex = currentAnimation;
+    snapshot.brightness = brightness;
+
+    uint8_t r = 0, g = 0, b = 0;
+    if (g_colourWheel) {
+        g_colourWheel->getColorRGB(r, g, b);
+    }
+    snprintf(snapshot.colour, sizeof(snapshot.colour), "#%02x%02x%02x", r, g, b);
+}
+
+uint8_t StateBroadcaster::diff(const Snapshot& a, const Snapshot& b) const {
+    uint8_t changed = 0;
+    if (a.vu != b.vu) changed |= FIELD_VU;
+    if (a.white != b.white) changed |= FIELD_WHITE;
+    if (a.animation != b.animation || a.animationIndex != b.animationIndex) changed |= FIELD_ANIMATION;
+    if (strcmp(a.colour, b.colour) != 0) changed |= FIELD_COLOUR;
+    if (a.brightness != b.brightness) changed |= FIELD_BRIGHTNESS;
+    return changed;
+}
+
+void StateBroadcaster::appendControls(JsonArray controls, const Snapshot& snapshot, uint8_t fields) const {
+    if (fields & FIELD_VU) {
+        JsonObject vu_ctrl = controls.add<JsonObject>();
+        vu_ctrl["name"] = "vu";
+        vu_ctrl["state"] = snapshot.vu;
+    }
+
+    if (fields & FIELD_WHITE) {
+        JsonObject white_ctrl = controls.add<JsonObject>();
+        white_ctrl["name"] = "white";
+        white_ctrl["state"] = snapshot.white;
+    }
+
+    if (fields & FIELD_ANIMATION) {
+        JsonObject anim_ctrl = controls.add<JsonObject>();
+        anim_ctrl["name"] = "animation";
+        anim_ctrl["state"] = snapshot.animation;
+        anim_ctrl["animation"] = snapshot.animationIndex;
+    }
+
+    if (fields & FIELD_COLOUR) {
+        JsonObject color_ctrl = controls.add<JsonObject>();
+        color_ctrl["name"] = "colour";
+        color_ctrl["state"] = snapshot.colour;   // Copied into the document
+    }
+
+    if (fields & FIELD_BRIGHTNESS) {
+        JsonObject brightness_ctrl = controls.add<JsonObject>();
+        brightness_ctrl["name"] = "brightness";
+        brightness_ctrl["state"] = snapshot.brightness;
+    }
+}
+
+StateBroadcaster::Stats StateBroadcaster::getStats() const {
+    Stats stats = stats_;
+    stats.intervalMs = intervalMs_;
+    stats.clients = clientCount_;
+    return stats;
+}
@@ -0,0 +1,221 @@
+#include "StaticAssets.h"
+#include <ArduinoJson.h>
+#include <Logger.h>
+
+const char StaticAssets::MANIFEST_PATH[] = "/assets.json";
+const char StaticAssets::PARTITION_LABEL[] = "assets";
+
+static const char CACHE_IMMUTABLE[] = "public, max-age=31536000, immutable";
+static const char CACHE_REVALIDATE[] = "no-cache";
+
+StaticAssets::StaticAssets()
+    : fs_(nullptr)
+    , mapHandle_(0)
+    , mapped_(false)
+    , count_(0)
+    , stats_()
+{
+    memset(assets_, 0, sizeof(assets_));
+}
+
+StaticAssets::~StaticAssets() {
+    if (mapped_) {
+        spi_flash_munmap(mapHandle_);
+    }
+}
+
+bool StaticAssets::begin(fs::FS& fs) {
+    fs_ = &fs;
+    count_ = 0;
+
+    uint32_t build = 0;
+    bool loaded = loadManifest(build);
+    if (loaded) {
+        mapPartition(build);
+    }
+    stats_.assets = count_;
+    stats_.mapped = mapped_;
+    return loaded;
+}
+
+bool StaticAssets::mapPartition(uint32_t build) {
+    const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                                ESP_PARTITION_SUBTYPE_ANY,
+                                                                PARTITION_LABEL);
+    if (!partition) {
+        return false;
+    }
+
+    const void* base = nullptr;
+    if (esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &base, &mapHandle_) != ESP_OK) {
+        Logger.warning("Could not map the %s partition", PARTITION_LABEL);
+        return false;
+    }
+
+    if (!bundle_.open((const uint8_t*)base, partition->size)) {
+        // Erased (never uploaded) or corrupt - fall back to LittleFS
+        Logger.warning("No valid asset bundle in the %s partition", PARTITION_LABEL);
+        spi_flash_munmap(mapHandle_);
+        return false;
+    }
+
+    if (build == 0 || bundle_.build() != build) {
+        // Left over from an earlier uploadassets - the UI on LittleFS is newer
+        Logger.warning("Asset bundle is build %08x, the file system has %08x - serving from LittleFS",
+                       (unsigned)bundle_.build(), (unsigned)build);
+        spi_flash_munmap(mapHandle_);
+        return false;
+    }
+
+    // Same files as the manifest - serve them from flash instead
+    count_ = 0;
+    for (uint16_t i = 0; i < bundle_.count() && count_ < MAX_ASSETS; i++) {
+        const AssetBundle::Entry* entry = bundle_.entry(i);
+        Asset& asset = assets_[count_++];
+        strlcpy(asset.path, entry->path, sizeof(asset.path));
+        strlcpy(asset.type, entry->type, sizeof(asset.type));
+        snprintf(asset.etag, sizeof(asset.etag), "\"%.*s\"", (int)sizeof(entry->etag), entry->etag);
+        asset.size = entry->size;
+        asset.gzSize = entry->gzSize;
+        asset.immutable = (entry->flags & AssetBundle::FLAG_IMMUTABLE) != 0;
+        asset.data = bundle_.data(*entry);
+    }
+
+    mapped_ = true;
+    Logger.info("Serving %u web assets from the %s partition", count_, PARTITION_LABEL);
+    return count_ > 0;
+}
+
+bool StaticAssets::loadManifest(uint32_t& build) {
+    File file = fs_->open(MANIFEST_PATH, "r");
+    if (!file) {
+        Logger.warning("No %s - serving web files uncompressed", MANIFEST_PATH);
+        return false;
+    }
+
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+    if (error) {
+        Logger.error("Failed to parse %s: %s", MANIFEST_PATH, error.c_str());
+        return false;
+    }
+
+    const char* buildId = doc["build"];
+    build = buildId ? strtoul(buildId, nullptr, 16) : 0;
+
+    for (JsonObjectConst entry : doc["assets"].as<JsonArrayConst>()) {
+        const char* path = entry["path"];
+        const char* type = entry["type"];
+        const char* etag = entry["etag"];
+        if (!path || !type || !etag) {
+            continue;
+        }
+        if (count_ >= MAX_ASSETS) {
+            Logger.warning("%s: more than %u assets, ignoring %s", MANIFEST_PATH, (unsigned)MAX_ASSETS, path);
+            continue;
+        }
+
+        Asset& asset = assets_[count_++];
+        strlcpy(asset.path, path, sizeof(asset.path));
+        strlcpy(asset.type, type, sizeof(asset.type));
+        snprintf(asset.etag, sizeof(asset.etag), "\"%s\"", etag);
+        asset.size = entry["size"] | 0;
+        asset.gzSize = entry["gz"] | 0;
+        asset.immutable = entry["immutable"] | false;
+        asset.data = nullptr;
+    }
+
+    Logger.info("Serving %u pre-compressed web assets", count_);
+    return count_ > 0;
+}
+
+void StaticAssets::registerRoutes(AsyncWebServer* server) {
+    for (uint8_t i = 0; i < count_; i++) {
+        const Asset* asset = &assets_[i];
+        server->on(asset->path, HTTP_GET, [this, asset](AsyncWebServerRequest* request) {
+            sendAsset(request, *asset);
+        });
+    }
+
+    const Asset* index = find("/index.html");
+    if (index) {
+        server->on("/", HTTP_GET, [this, index](AsyncWebServerRequest* request) {
+            sendAsset(request, *index);
+        });
+    }
+}
+
+bool StaticAssets::send(AsyncWebServerRequest* request, const char* path) {
+    const Asset* asset = find(path);
+    if (!asset) {
+        return false;
+    }
+    sendAsset(request, *asset);
+    return true;
+}
+
+const StaticAssets::Asset* StaticAssets::find(const char* path) const {
+    for (uint8_t i = 0; i < count_; i++) {
+        if (strcmp(assets_[i].path, path) == 0) {
+            return &assets_[i];
+        }
+    }
+    return nullptr;
+}
+
+void StaticAssets::sendAsset(AsyncWebServerRequest* request, const Asset& asset) {
+    unsigned long start = micros();
+    stats_.requests++;
+    const char* cacheControl = asset.immutable ? CACHE_IMMUTABLE : CACHE_REVALIDATE;
+
+    // Revalidation: the ETag is the content hash, so a match means the
+    // browser's copy is current - answer without opening the file
+    if (request->hasHeader("If-None-Match") &&
+        request->getHeader("If-None-Match")->value() == asset.etag) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", asset.etag);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
+        stats_.notModified++;
+        stats_.handlerUs += micros() - start;
+        return;
+    }
+
+    if (asset.data) {
+        // Straight from mapped flash - the TCP stack copies out of it as it sends
+        AsyncWebServerResponse* response = request->beginResponse_P(200, asset.type, asset.data, asset.gzSize);
+        response->addHeader("Content-Encoding", "gzip");
+        response->addHeader("ETag", asset.etag);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
+
+        stats_.bytesSent += asset.gzSize;
+        stats_.bytesRaw += asset.size;
+        stats_.handlerUs += micros() - start;
+        return;
+    }
+
+    char gzPath[sizeof(asset.path) + 3];
+    snprintf(gzPath, sizeof(gzPath), "%s.gz", asset.path);
+    File file = fs_->open(gzPath, "r");
+    if (!file) {
+        request->send(404, "text/plain", "Not found");
+        return;
+    }
+
+    // AsyncFileResponse adds Content-Encoding: gzip for a .gz file served
+    // under the original path
+    AsyncWebServerResponse* response = request->beginResponse(file, asset.path, asset.type);
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+
+    stats_.bytesSent += asset.gzSize;
+    stats_.bytesRaw += asset.size;
+    stats_.handlerUs += micros() - start;
+}
+
+StaticAssets::Stats StaticAssets::getStats() const {
+    return stats_;
+}
@@ -7,8 +7,12 @@
 #include <Logger.h>
 #include "LEDManager.h"
 #include "ColourWheel.h"
+#include "BootProfiler.h"
+#include "Metrics.h"
 #include <FastLED.h>  // For CRGB color constants
 
+using ControlJson::hashMessageType;
+
 // Legacy global variables for backward compatibility
 extern uint8_t brightness;
 extern bool showAnimation;
@@ -31,10 +35,50 @@ WebUIManager* g_webUIManager = nullptr;
 // Global OTA manager instance
 OTAManager* g_otaManager = nullptr;
 
+// Background LittleFS mount (see WebUIManager::startFilesystemMount()).
+// The task only mounts and times it - logging happens on the main loop
+static SemaphoreHandle_t s_fsMountDone = nullptr;
+static bool s_fsMounted = false;
+static bool s_fsFormatted = false;
+static uint32_t s_fsMountStartUs = 0;
+static uint32_t s_fsMountUs = 0;
+
+static void mountFilesystem() {
+    s_fsMountStartUs = micros();
+
+    // Try to mount without auto-format first so a bad image is reported
+    s_fsMounted = LittleFS.begin(false);
+    if (!s_fsMounted) {
+        s_fsFormatted = true;
+        s_fsMounted = LittleFS.begin(true);
+    }
+
+    s_fsMountUs = micros() - s_fsMountStartUs;
+}
+
+static void filesystemMountTask(void*) {
+    mountFilesystem();
+    xSemaphoreGive(s_fsMountDone);
+    vTaskDelete(nullptr);
+}
+
 WebUIManager::WebUIManager(AsyncWebServer* webServer)
     : initialized_(false)
     , server_(webServer)
     , webSocket_("/ws")
+    , logSocket_("/ws")
+    , logClients_(0)
+    , broadcaster_(&webSocket_)
+    , frameStreamer_(&webSocket_)
+    , spectrumStreamer_(&webSocket_)
+    , animationsMessage_()
+    , controlStats_()
+    , stateApiStats_()
+    , topicStats_()
+    , topicWindowStart_(0)
+    , stateBytesAtWindow_(0)
+    , frameBytesAtWindow_(0)
+    , spectrumBytesAtWindow_(0)
 {
 }
 
@@ -43,6 +87,23 @@ WebUIManager::~WebUIManager() {
     // Note: server_ is NOT owned by us, so we don't delete it
 }
 
+void WebUIManager::startFilesystemMount() {
+    if (s_fsMountDone) {
+        return;
+    }
+
+    s_fsMountDone = xSemaphoreCreateBinary();
+    if (!s_fsMountDone) {
+        return;
+    }
+
+    // Core 0, below the Wi-Fi and AsyncTCP tasks; the loop task is on core 1
+    if (xTaskCreatePinnedToCore(filesystemMountTask, "fs-mount", 4096, nullptr, 1, nullptr, 0) != pdPASS) {
+        vSemaphoreDelete(s_fsMountDone);
+        s_fsMountDone = nullptr;
+    }
+}
+
 bool WebUIManager::initialize() {
     if (initialized_) {
         return true;
@@ -58,7 +119,11 @@ bool WebUIManager::initialize() {
         return false;
     }
 
+    assets_.begin(LittleFS);
+
     initializeWebSocket();
+    broadcaster_.begin();
+    animationsMessage_ = buildAnimationsMessage();
     setupRoutes();
     setupAPIEndpoints();
     setupStaticFiles();
@@ -69,18 +134,11 @@ bool WebUIManager::initialize() {
     }
 
     if (g_otaManager) {
-        // Set start callback
-        g_otaManager->setStartCallback([]() {
-            // Turn off animations during OTA
-            if (g_ledManager) {
-                g_ledManager->setAnimationEnabled(false);
-            }
-        });
-
-        // Set LED progress callback
+        // LED progress is drawn by the overlay - the effect keeps running
+        // underneath and carries on if the update fails
         g_otaManager->setLEDProgressCallback([](uint8_t progress) {
             if (g_ledManager) {
-                g_ledManager->showOTAProgress(progress);
+                g_ledManager->getOverlay().showProgress(progress);
             }
         });
 
@@ -97,18 +155,18 @@ bool WebUIManager::initialize() {
             }
         });
 
-        // Set end callback for failure handling
+        // Set end callback: resume the scene after the restart, or flash
+        // red three times over it on failure. Runs on the AsyncTCP task,
+        // so the snapshot is left to the main loop
         g_otaManager->setEndCallback([](bool success) {
-            if (!success) {
-                // Flash red on failure
-                if (g_ledManager) {
-                    for (int i = 0; i < 3; i++) {
-                        g_ledManager->fillColor(CRGB::Red);
-                        delay(200);
-                        g_ledManager->fillColor(CRGB::Black);
-                        delay(200);
-                    }
-                }
+            if (!g_ledManager) {
+                return;
+            }
+            if (success) {
+                extern volatile bool g_restartSnapshotRequested;
+                g_restartSnapshotRequested = true;
+            } else {
+                g_ledManager->getOverlay().flash(CRGB::Red, 3, 200);
             }
         });
 
@@ -127,9 +185,50 @@ void WebUIManager::update() {
     if (!initialized_) {
         return;
     }
+    METRICS_SCOPE(WEB_UPDATE);
     
     // Clean up disconnected WebSocket clients
     webSocket_.cleanupClients();
+    logSocket_.cleanupClients();
+
+    // Apply the latest value of each control received since the last pass
+    applyPendingControls();
+
+    // Flush coalesced state changes
+    broadcaster_.update();
+
+    // Stream the frame just published by the LED update
+    frameStreamer_.update();
+
+    // Latest audio levels (published by VuGraph in the UI update)
+    spectrumStreamer_.update();
+
+    updateTopicStats(millis());
+    METRICS_GAUGE(WS_QUEUE_DEPTH, broadcaster_.getQueueDepth());
+}
+
+void WebUIManager::updateTopicStats(unsigned long now) {
+    if (now - topicWindowStart_ < 1000) {
+        return;
+    }
+    unsigned long elapsed = now - topicWindowStart_;
+    topicWindowStart_ = now;
+
+    StateBroadcaster::Stats state = broadcaster_.getStats();
+    FrameStreamer::Stats frames = frameStreamer_.getStats();
+    SpectrumStreamer::Stats spectrum = spectrumStreamer_.getStats();
+
+    topicStats_.stateClients = state.clients;
+    topicStats_.stateBytesPerSec = (uint64_t)(state.bytesSent - stateBytesAtWindow_) * 1000 / elapsed;
+    topicStats_.frameClients = frames.subscribers;
+    topicStats_.frameBytesPerSec = (uint64_t)(frames.bytesSent - frameBytesAtWindow_) * 1000 / elapsed;
+    topicStats_.spectrumClients = spectrum.subscribers;
+    topicStats_.spectrumBytesPerSec = (uint64_t)(spectrum.bytesSent - spectrumBytesAtWindow_) * 1000 / elapsed;
+    topicStats_.logClients = logClients_;
+
+    stateBytesAtWindow_ = state.bytesSent;
+    frameBytesAtWindow_ = frames.bytesSent;
+    spectrumBytesAtWindow_ = spectrum.bytesSent;
 }
 
 void WebUIManager::notifyClients() {
@@ -137,49 +236,44 @@ void WebUIManager::notifyClients() {
         return;
     }
     
-    String stateResponse = generateStateResponse();
-    webSocket_.textAll(stateResponse);
+    broadcaster_.markDirty();
 }
 
 bool WebUIManager::initializeLittleFS() {
     Logger.info("=== Initializing LittleFS ===");
 
-    // Try to mount without auto-format first to see actual errors
-    if (!LittleFS.begin(false)) {
+    if (s_fsMountDone) {
+        uint32_t waitStart = micros();
+        xSemaphoreTake(s_fsMountDone, portMAX_DELAY);
+        vSemaphoreDelete(s_fsMountDone);
+        s_fsMountDone = nullptr;
+        g_bootProfiler.record("fs-mount", s_fsMountStartUs, s_fsMountUs);
+        Logger.debug("LittleFS mounted in background (%lu ms, waited %lu ms)",
+                     (unsigned long)(s_fsMountUs / 1000),
+                     (unsigned long)((micros() - waitStart) / 1000));
+    } else if (!s_fsMounted) {
+        mountFilesystem();
+        g_bootProfiler.record("fs-mount", s_fsMountStartUs, s_fsMountUs);
+    }
+
+    if (!s_fsMounted) {
+        Logger.error("LittleFS Mount Failed even with format!");
+        return false;
+    }
+    if (s_fsFormatted) {
         Logger.warning("LittleFS Mount Failed - uploaded image cannot be mounted!");
         Logger.warning("This means the uploaded filesystem has wrong block/page parameters.");
-        Logger.info("Trying to mount with format-on-fail as fallback...");
-
-        // As fallback, allow formatting
-        if (!LittleFS.begin(true)) {
-            Logger.error("LittleFS Mount Failed even with format!");
-            return false;
-        }
         Logger.warning("WARNING: LittleFS was formatted blank. Files were NOT loaded from uploaded image.");
     } else {
         Logger.info("LittleFS mounted successfully from uploaded image!");
     }
 
-    // List files to verify filesystem contents
-    File root = LittleFS.open("/");
-    if (!root) {
-        Logger.error("ERROR: Failed to open root directory");
-        return false;
-    }
-
     // Check if files exist, write from PROGMEM if missing
     // NOTE: This now just logs that files are loaded from LittleFS image
     writeEmbeddedFilesToFS();
 
-    Logger.debug("Files in LittleFS:");
-    File file = root.openNextFile();
-    int fileCount = 0;
-    while (file) {
-        Logger.debug("  - %s (%d bytes)", file.name(), file.size());
-        file = root.openNextFile();
-        fileCount++;
-    }
-    Logger.debug("Total files found: %d", fileCount);
+    // No directory walk here - the asset manifest (StaticAssets) says what's
+    // on the filesystem, and listing every file cost boot time
     Logger.info("=== LittleFS initialization complete ===");
 
     return true;
@@ -258,25 +352,30 @@ void WebUIManager::writeEmbeddedFilesToFS() {
 }
 
 void WebUIManager::initializeWebSocket() {
+    // Both sockets live at /ws: the web UI connects with ?control=1, anything
+    // else (Logger's /logs page) falls through to the log socket. Keeps log
+    // lines off the control clients without changing the Logger page.
+    webSocket_.setFilter([](AsyncWebServerRequest* request) {
+        return request->hasParam("control");
+    });
     webSocket_.onEvent(staticWebSocketEventHandler);
     server_->addHandler(&webSocket_);
+
+    logSocket_.onEvent(staticLogSocketEventHandler);
+    server_->addHandler(&logSocket_);
 }
 
 void WebUIManager::setupRoutes() {
     Logger.debug("=== WebUIManager: Setting up routes ===");
 
-    // Route for root / web page
-    server_->on("/", HTTP_GET, [](AsyncWebServerRequest* request) {
-        Logger.debug("Route called: GET /");
-        if (LittleFS.exists("/index.html")) {
-            File file = LittleFS.open("/index.html", "r");
-            Logger.debug("  /index.html exists, size: %d bytes", file.size());
-            file.close();
-        } else {
-            Logger.error("  /index.html NOT FOUND!");
-        }
-        request->send(LittleFS, "/index.html", "text/html", false);
-    });
+    // Pre-compressed assets (and / for index.html) when the image has a manifest
+    if (assets_.isLoaded()) {
+        assets_.registerRoutes(server_);
+    } else {
+        server_->on("/", HTTP_GET, [](AsyncWebServerRequest* request) {
+            request->send(LittleFS, "/index.html", "text/html", false);
+        });
+    }
 
     // Debug route to test connectivity
     server_->on("/test", HTTP_GET, [](AsyncWebServerRequest* request) {
@@ -294,8 +393,8 @@ void WebUIManager::setupAPIEndpoints() {
     // are handled by WiFiSetupManager library
 
     // LED Configuration endpoints
-    server_->on("/led-config", HTTP_GET, [](AsyncWebServerRequest* request) {
-        request->send(LittleFS, "/led-config.html", "text/html");
+    server_->on("/led-config", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        sendPage(request, "/led-config.html");
     });
 
     server_->on("/get-led-config", HTTP_GET, [](AsyncWebServerRequest* request) {
@@ -319,7 +418,7 @@ void WebUIManager::setupAPIEndpoints() {
         request->send(200, "application/json", json);
     });
 
-    server_->on("/save-led-config", HTTP_POST, [](AsyncWebServerRequest* request) {
+    server_->on("/save-led-config", HTTP_POST, [this](AsyncWebServerRequest* request) {
         int numStrips = 0;
         int ledsPerStrip = 0;
 
@@ -339,25 +438,176 @@ void WebUIManager::setupAPIEndpoints() {
 
             Logger.info("Saved LED config: %d strips, %d LEDs per strip", numStrips, ledsPerStrip);
 
-            request->send(LittleFS, "/led-config-saved.html", "text/html");
+            sendPage(request, "/led-config-saved.html");
 
-            // Schedule restart
-            extern bool g_restartRequested;
-            g_restartRequested = true;
+            // Applied in place by the LED update when possible, otherwise
+            // the new layout takes effect after a restart
+            if (!g_ledManager || !g_ledManager->requestReconfigure(numStrips, ledsPerStrip)) {
+                Logger.info("LED layout needs a restart to apply");
+                extern bool g_restartRequested;
+                g_restartRequested = true;
+            }
         } else {
             request->send(400, "text/plain", "Invalid LED configuration");
         }
     });
 
     // Clear saved LED state (for testing first-boot experience)
-    server_->on("/clear-led-state", HTTP_POST, [](AsyncWebServerRequest* request) {
+    server_->on("/clear-led-state", HTTP_POST, [this](AsyncWebServerRequest* request) {
         extern LEDManager* g_ledManager;
         if (g_ledManager) {
             g_ledManager->clearSavedState();
         }
 
         Logger.info("LED state preferences cleared via web UI");
-        request->send(LittleFS, "/led-state-cleared.html", "text/html");
+        sendPage(request, "/led-state-cleared.html");
+    });
+
+    // Control state for integrations: GET reads it, PATCH applies any subset
+    // of fields in one main loop pass (see handleStatePatch)
+    server_->on("/api/state", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        request->send(200, "application/json", generateStateResponse());
+    });
+
+    server_->on("/api/state", HTTP_PATCH,
+        [](AsyncWebServerRequest* request) {
+            if (request->contentLength() == 0) {
+                request->send(400, "text/plain", "Missing JSON body");
+            }
+            // Otherwise answered from the body handler
+        },
+        nullptr,
+        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            handleStatePatch(request, data, len, index, total);
+        });
+
+    // Effect layers over the current animation: GET lists them, PUT
+    // replaces the whole set ({"layers":[{"effect":4,"blend":"add","opacity":200}]})
+    server_->on("/api/layers", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        request->send(200, "application/json", generateLayersResponse());
+    });
+
+    server_->on("/api/layers", HTTP_PUT,
+        [](AsyncWebServerRequest* request) {
+            if (request->contentLength() == 0) {
+                request->send(400, "text/plain", "Missing JSON body");
+            }
+            // Otherwise answered from the body handler
+        },
+        nullptr,
+        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            handleLayersPut(request, data, len, index, total);
+        });
+
+    // Zones: named strip ranges with their own effect. GET lists the saved
+    // definitions, PUT replaces and saves them (see LedZones)
+    server_->on("/api/zones", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        request->send(200, "application/json", generateZonesResponse());
+    });
+
+    server_->on("/api/zones", HTTP_PUT,
+        [](AsyncWebServerRequest* request) {
+            if (request->contentLength() == 0) {
+                request->send(400, "text/plain", "Missing JSON body");
+            }
+            // Otherwise answered from the body handler
+        },
+        nullptr,
+        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            handleZonesPut(request, data, len, index, total);
+        });
+
+    // Power budget: supplies feeding strip ranges, each with an mA limit.
+    // GET adds the live estimates, PUT replaces and saves the supplies
+    // ({"supplies":[{"firstStrip":0,"strips":10,"budgetMa":8000}]})
+    server_->on("/api/power", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        request->send(200, "application/json", generatePowerResponse());
+    });
+
+    server_->on("/api/power", HTTP_PUT,
+        [](AsyncWebServerRequest* request) {
+            if (request->contentLength() == 0) {
+                request->send(400, "text/plain", "Missing JSON body");
+            }
+            // Otherwise answered from the body handler
+        },
+        nullptr,
+        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            handlePowerPut(request, data, len, index, total);
+        });
+
+    // Output stage: gamma, colour correction, per-strip white balance and
+    // colour order, folded into the output LUTs (see OutputStage). PUT
+    // replaces and saves them ({"gamma":2.2,"order":"GRB","correction":[255,255,255],
+    // "calibrations":[{"firstStrip":0,"strips":2,"balance":[255,220,200]}]})
+    server_->on("/api/output", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        request->send(200, "application/json", generateOutputResponse());
+    });
+
+    server_->on("/api/output", HTTP_PUT,
+        [](AsyncWebServerRequest* request) {
+            if (request->contentLength() == 0) {
+                request->send(400, "text/plain", "Missing JSON body");
+            }
+            // Otherwise answered from the body handler
+        },
+        nullptr,
+        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            handleOutputPut(request, data, len, index, total);
+        });
+
+#if METRICS_ENABLED
+    // Prometheus text exposition: loop/LED/UI/web timing histograms and a
+    // few gauges, for scraping a fleet of controllers
+    server_->on("/metrics", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        request->send(200, "text/plain; version=0.0.4", generateMetricsResponse());
+    });
+#endif
+
+    // Runtime telemetry (display policy, CPU handed back to the LED path, ...)
+    server_->on("/api/telemetry", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        request->send(200, "application/json", generateTelemetryResponse());
+    });
+
+    // Boot phase timestamps - also part of /api/telemetry, this is the cheap one
+    server_->on("/api/boot", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        request->send(200, "application/json", generateBootResponse());
+    });
+
+    // Display idle policy: dim_ms / suspend_ms (0 disables the stage)
+    server_->on("/api/display", HTTP_POST, [](AsyncWebServerRequest* request) {
+        if (!g_uiManager || !g_uiManager->isInitialized()) {
+            request->send(503, "text/plain", "UI not initialized");
+            return;
+        }
+
+        UIManager::DisplayStats stats = g_uiManager->getDisplayStats();
+        uint32_t dimMs = stats.dimTimeoutMs;
+        uint32_t suspendMs = stats.suspendTimeoutMs;
+        if (request->hasParam("dim_ms", true)) {
+            dimMs = request->getParam("dim_ms", true)->value().toInt();
+        }
+        if (request->hasParam("suspend_ms", true)) {
+            suspendMs = request->getParam("suspend_ms", true)->value().toInt();
+        }
+
+        g_uiManager->setIdleTimeouts(dimMs, suspendMs);
+        Logger.info("Display idle policy updated: dim %lu ms, suspend %lu ms",
+                    (unsigned long)dimMs, (unsigned long)suspendMs);
+        request->send(200, "application/json", "{\"ok\":true}");
+    });
+
+    // WebSocket state broadcast: interval_ms = minimum time between state messages
+    server_->on("/api/websocket", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        if (!request->hasParam("interval_ms", true)) {
+            request->send(400, "text/plain", "Missing interval_ms");
+            return;
+        }
+
+        uint32_t intervalMs = request->getParam("interval_ms", true)->value().toInt();
+        broadcaster_.setInterval(intervalMs);
+        Logger.info("State broadcast interval updated: %lu ms", (unsigned long)broadcaster_.getStats().intervalMs);
+        request->send(200, "application/json", "{\"ok\":true}");
     });
 
     // Legacy get-message endpoint (mostly unused)
@@ -368,12 +618,18 @@ void WebUIManager::setupAPIEndpoints() {
 }
 
 void WebUIManager::setupStaticFiles() {
-    // Serve static files from LittleFS
+    // Anything not in the asset manifest is served from LittleFS as is
     server_->serveStatic("/", LittleFS, "/");
 }
 
-String WebUIManager::generateAnimationsResponse() {
-    JsonDocument doc;
+void WebUIManager::sendPage(AsyncWebServerRequest* request, const char* path) {
+    if (!assets_.send(request, path)) {
+        request->send(LittleFS, path, "text/html");
+    }
+}
+
+AsyncWebSocketSharedBuffer WebUIManager::buildAnimationsMessage() {
+    JsonDocument doc(&arena_);
     doc["message"] = "animations";
     JsonArray animations = doc["animations"].to<JsonArray>();
 
@@ -384,65 +640,865 @@ String WebUIManager::generateAnimationsResponse() {
         anim["value"] = i;
     }
 
+    AsyncWebSocketSharedBuffer buffer = StateBroadcaster::serialize(doc);
+    if (!buffer) {
+        Logger.error("No memory for the animation list message");
+    }
+    return buffer;
+}
+
+String WebUIManager::generateTelemetryResponse() {
+    JsonDocument doc;
+    doc["uptime"] = millis();
+    doc["heapFree"] = ESP.getFreeHeap();
+
+    if (g_uiManager && g_uiManager->isInitialized()) {
+        UIManager::DisplayStats stats = g_uiManager->getDisplayStats();
+        JsonObject display = doc["display"].to<JsonObject>();
+        display["state"] = UIManager::getDisplayStateName(stats.state);
+        display["refreshMs"] = stats.refreshPeriodMs;
+        display["uiBusyUsPerSec"] = stats.uiBusyUs;
+        display["baselineBusyUsPerSec"] = stats.baselineBusyUs;
+        display["freedUsPerSec"] = stats.freedUs;
+        display["suspendedMs"] = stats.suspendedMs;
+        display["wakeCount"] = stats.wakeCount;
+        display["dimTimeoutMs"] = stats.dimTimeoutMs;
+        display["suspendTimeoutMs"] = stats.suspendTimeoutMs;
+        display["styleToggleUs"] = stats.styleToggleUs;
+    }
+
+    if (g_ledManager) {
+        LEDManager::PersistStats persist = g_ledManager->getPersistStats();
+        JsonObject ledState = doc["ledState"].to<JsonObject>();
+        ledState["lifetimeWrites"] = persist.lifetimeWrites;
+        ledState["writes"] = persist.writes;
+        ledState["skipped"] = persist.skipped;
+        ledState["migrated"] = persist.migrated;
+        ledState["resumed"] = persist.resumed;
+
+        JsonObject layout = doc["layout"].to<JsonObject>();
+        layout["strips"] = g_ledManager->getNumStrips();
+        layout["ledsPerStrip"] = g_ledManager->getLedsPerStrip();
+        layout["version"] = g_ledManager->getGeometryVersion();
+    }
+
+    StateBroadcaster::Stats broadcast = broadcaster_.getStats();
+    JsonObject broadcastObj = doc["broadcast"].to<JsonObject>();
+    broadcastObj["intervalMs"] = broadcast.intervalMs;
+    broadcastObj["clients"] = broadcast.clients;
+    broadcastObj["notifications"] = broadcast.notifications;
+    broadcastObj["coalesced"] = broadcast.coalesced;
+    broadcastObj["unchanged"] = broadcast.unchanged;
+    broadcastObj["messagesSent"] = broadcast.messagesSent;
+    broadcastObj["bytesSent"] = broadcast.bytesSent;
+    broadcastObj["bytesSaved"] = broadcast.bytesSaved;
+    broadcastObj["dropped"] = broadcast.dropped;
+    broadcastObj["resyncs"] = broadcast.resyncs;
+
+    JsonObject topics = doc["topics"].to<JsonObject>();
+    JsonObject stateTopic = topics["state"].to<JsonObject>();
+    stateTopic["clients"] = topicStats_.stateClients;
+    stateTopic["bytesPerSec"] = topicStats_.stateBytesPerSec;
+    JsonObject framesTopic = topics["frames"].to<JsonObject>();
+    framesTopic["clients"] = topicStats_.frameClients;
+    framesTopic["bytesPerSec"] = topicStats_.frameBytesPerSec;
+    JsonObject spectrumTopic = topics["spectrum"].to<JsonObject>();
+    spectrumTopic["clients"] = topicStats_.spectrumClients;
+    spectrumTopic["bytesPerSec"] = topicStats_.spectrumBytesPerSec;
+    JsonObject logsTopic = topics["logs"].to<JsonObject>();
+    logsTopic["clients"] = topicStats_.logClients;
+
+    StaticAssets::Stats assetStats = assets_.getStats();
+    JsonObject assetsObj = doc["assets"].to<JsonObject>();
+    assetsObj["assets"] = assetStats.assets;
+    assetsObj["source"] = assetStats.mapped ? "partition" : "littlefs";
+    assetsObj["requests"] = assetStats.requests;
+    assetsObj["notModified"] = assetStats.notModified;
+    assetsObj["bytesSent"] = assetStats.bytesSent;
+    assetsObj["bytesRaw"] = assetStats.bytesRaw;
+    assetsObj["handlerUs"] = assetStats.handlerUs;
+
+    FrameStreamer::Stats frames = frameStreamer_.getStats();
+    JsonObject framesObj = doc["frames"].to<JsonObject>();
+    framesObj["subscribers"] = frames.subscribers;
+    framesObj["framesSent"] = frames.framesSent;
+    framesObj["keyframes"] = frames.keyframes;
+    framesObj["bytesSent"] = frames.bytesSent;
+    framesObj["bytesRaw"] = frames.bytesRaw;
+    framesObj["skipped"] = frames.skipped;
+    framesObj["encodeUs"] = frames.encodeUs;
+
+    SpectrumStreamer::Stats spectrum = spectrumStreamer_.getStats();
+    JsonObject spectrumObj = doc["spectrum"].to<JsonObject>();
+    spectrumObj["subscribers"] = spectrum.subscribers;
+    spectrumObj["throttled"] = spectrum.throttled;
+    spectrumObj["messagesSent"] = spectrum.messagesSent;
+    spectrumObj["bytesSent"] = spectrum.bytesSent;
+    spectrumObj["skipped"] = spectrum.skipped;
+    spectrumObj["backoffs"] = spectrum.backoffs;
+
+    addLayers(doc["layers"].to<JsonArray>());
+    addPower(doc["power"].to<JsonObject>());
+    addOutputStats(doc["output"].to<JsonObject>());
+
+    JsonObject stateApi = doc["stateApi"].to<JsonObject>();
+    stateApi["gets"] = stateApiStats_.gets;
+    stateApi["patches"] = stateApiStats_.patches;
+    stateApi["rejected"] = stateApiStats_.rejected;
+    stateApi["handlerUs"] = stateApiStats_.handlerUs;
+
+    JsonObject control = doc["control"].to<JsonObject>();
+    control["protocolVersion"] = ControlProtocol::VERSION;
+    control["jsonMessages"] = controlStats_.jsonMessages;
+    control["binaryMessages"] = controlStats_.binaryMessages;
+    control["jsonDecodeUs"] = controlStats_.jsonDecodeUs;
+    control["binaryDecodeUs"] = controlStats_.binaryDecodeUs;
+    control["rejected"] = controlStats_.rejected;
+    control["batches"] = controlStats_.batches;
+
+    ControlQueue::Stats queue = controlQueue_.getStats();
+    control["posted"] = queue.posted;
+    control["applied"] = queue.applied;
+    control["superseded"] = queue.superseded;
+
+    JsonArena::Stats inbound = arena_.getStats();
+    JsonArena::Stats outbound = broadcaster_.getArenaStats();
+    JsonObject wsMemory = doc["wsMemory"].to<JsonObject>();
+    wsMemory["arenaCapacity"] = inbound.capacity;
+    wsMemory["inboundPeakBytes"] = inbound.peakBytes;
+    wsMemory["inboundHeapFallbacks"] = inbound.fallbacks;
+    wsMemory["outboundPeakBytes"] = outbound.peakBytes;
+    wsMemory["outboundHeapFallbacks"] = outbound.fallbacks;
+    wsMemory["messagesSerialized"] = broadcast.serialized;
+    wsMemory["serializeFailures"] = broadcast.serializeFailures;
+
+    LedPreview* preview = (g_uiManager && g_uiManager->isInitialized()) ? g_uiManager->getLedPreview() : nullptr;
+    if (preview) {
+        LedPreview::Stats stats = preview->getStats();
+        JsonObject previewObj = doc["preview"].to<JsonObject>();
+        previewObj["cols"] = stats.cols;
+        previewObj["rows"] = stats.rows;
+        previewObj["cellPx"] = stats.cellPx;
+        previewObj["samplesPerSec"] = stats.samplesPerSec;
+        previewObj["sampleUsPerSec"] = stats.sampleUsPerSec;
+        previewObj["maxSampleUs"] = stats.maxSampleUs;
+        previewObj["drawUsPerSec"] = stats.drawUsPerSec;
+        previewObj["changedCellsPerSec"] = stats.changedCellsPerSec;
+    }
+
+    if (lv_is_initialized()) {
+        lv_mem_monitor_t mon;
+        lv_mem_monitor(&mon);
+        JsonObject lvgl = doc["lvgl"].to<JsonObject>();
+        lvgl["heapTotal"] = mon.total_size;
+        lvgl["heapUsed"] = mon.total_size - mon.free_size;
+        lvgl["heapMaxUsed"] = mon.max_used;
+        lvgl["fragPct"] = mon.frag_pct;
+    }
+
+    addBootProfile(doc["boot"].to<JsonObject>());
+
     String output;
     serializeJson(doc, output);
     return output;
 }
 
-String WebUIManager::generateStateResponse() {
+#if METRICS_ENABLED
+// Microseconds as seconds, the unit Prometheus expects
+static void appendSeconds(String& out, uint64_t us) {
+    char value[24];
+    snprintf(value, sizeof(value), "%lu.%06lu", (unsigned long)(us / 1000000), (unsigned long)(us % 1000000));
+    out += value;
+}
+
+static void appendGauge(String& out, const char* name, const char* help, uint32_t value) {
+    char line[160];
+    snprintf(line, sizeof(line), "# HELP modui_%s %s\n# TYPE modui_%s gauge\nmodui_%s %lu\n",
+             name, help, name, name, (unsigned long)value);
+    out += line;
+}
+
+String WebUIManager::generateMetricsResponse() {
+    String out;
+    out.reserve(6144);
+    char line[96];
+
+    // Buckets are stored per range; the exposition format wants them cumulative
+    for (uint8_t id = 0; id < Metrics::HISTOGRAM_COUNT; id++) {
+        const Metrics::HistogramData& histogram = g_metrics.getHistogram(id);
+        const char* name = Metrics::getHistogramName(id);
+        snprintf(line, sizeof(line), "# HELP modui_%s_seconds ", name);
+        out += line;
+        out += Metrics::getHistogramHelp(id);
+        snprintf(line, sizeof(line), "\n# TYPE modui_%s_seconds histogram\n", name);
+        out += line;
+
+        uint32_t cumulative = 0;
+        for (uint8_t bucket = 0; bucket < Metrics::BUCKET_COUNT; bucket++) {
+            cumulative += histogram.buckets[bucket];
+            snprintf(line, sizeof(line), "modui_%s_seconds_bucket{le=\"", name);
+            out += line;
+            if (bucket < Metrics::BUCKET_COUNT - 1) {
+                appendSeconds(out, Metrics::BUCKET_BOUNDS_US[bucket]);
+            } else {
+                out += "+Inf";
+            }
+            snprintf(line, sizeof(line), "\"} %lu\n", (unsigned long)cumulative);
+            out += line;
+        }
+
+        snprintf(line, sizeof(line), "modui_%s_seconds_sum ", name);
+        out += line;
+        appendSeconds(out, histogram.sumUs);
+        snprintf(line, sizeof(line), "\nmodui_%s_seconds_count %lu\n", name, (unsigned long)cumulative);
+        out += line;
+    }
+
+    for (uint8_t id = 0; id < Metrics::GAUGE_COUNT; id++) {
+        const Metrics::GaugeData& gauge = g_metrics.getGauge(id);
+        char peakName[48];
+        snprintf(peakName, sizeof(peakName), "%s_peak", Metrics::getGaugeName(id));
+        appendGauge(out, Metrics::getGaugeName(id), Metrics::getGaugeHelp(id), gauge.value);
+        appendGauge(out, peakName, "Highest value since boot", gauge.peak);
+    }
+
+    appendGauge(out, "heap_free_bytes", "Free internal heap", ESP.getFreeHeap());
+    appendGauge(out, "heap_min_free_bytes", "Lowest free internal heap since boot", ESP.getMinFreeHeap());
+    appendGauge(out, "heap_max_alloc_bytes", "Largest allocatable internal block", ESP.getMaxAllocHeap());
+    appendGauge(out, "psram_free_bytes", "Free PSRAM", ESP.getFreePsram());
+    appendGauge(out, "uptime_seconds", "Seconds since boot", (uint32_t)(millis() / 1000));
+    if (g_ledManager) {
+        appendGauge(out, "led_fps", "Achieved LED frame rate", g_ledManager->getOutputStage().getStats().fps);
+    }
+
+    return out;
+}
+#endif
+
+String WebUIManager::generateBootResponse() {
     JsonDocument doc;
-    doc["message"] = "states";
-    JsonArray controls = doc["controls"].to<JsonArray>();
-    
-    JsonObject vu_ctrl = controls.add<JsonObject>();
-    vu_ctrl["name"] = "vu";
-    vu_ctrl["state"] = vu;
-    
-    JsonObject white_ctrl = controls.add<JsonObject>();
-    white_ctrl["name"] = "white";
-    white_ctrl["state"] = white;
-    
-    JsonObject anim_ctrl = controls.add<JsonObject>();
-    anim_ctrl["name"] = "animation";
-    anim_ctrl["state"] = showAnimation;
-    anim_ctrl["animation"] = currentAnimation;
-    
-    JsonObject color_ctrl = controls.add<JsonObject>();
-    color_ctrl["name"] = "colour";
-    color_ctrl["state"] = g_colourWheel ? g_colourWheel->getColorHex() : "#000000";
-    
-    JsonObject brightness_ctrl = controls.add<JsonObject>();
-    brightness_ctrl["name"] = "brightness";
-    brightness_ctrl["state"] = brightness;
+    addBootProfile(doc.to<JsonObject>());
 
     String output;
     serializeJson(doc, output);
     return output;
 }
 
-void WebUIManager::handleWebSocketMessage(void* arg, uint8_t* data, size_t len) {
+void WebUIManager::addBootProfile(JsonObject boot) {
+    boot["totalMs"] = g_bootProfiler.getTotalUs() / 1000;
+    JsonArray phases = boot["phases"].to<JsonArray>();
+    for (int i = 0; i < g_bootProfiler.getPhaseCount(); i++) {
+        const BootProfiler::Phase& phase = g_bootProfiler.getPhase(i);
+        JsonObject entry = phases.add<JsonObject>();
+        entry["name"] = phase.name;
+        entry["startMs"] = phase.startUs / 1000;
+        entry["durationUs"] = phase.durationUs;
+        entry["heapFree"] = phase.heapFree;
+        entry["lvglUsed"] = phase.lvglUsed;
+    }
+}
+
+void WebUIManager::handleWebSocketMessage(AsyncWebSocketClient* client, void* arg, uint8_t* data, size_t len) {
     AwsFrameInfo* info = (AwsFrameInfo*)arg;
-    if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
-        data[len] = 0;
-        String message = (char*)data;
-        JsonDocument request;
-        deserializeJson(request, message);
-
-        String messageType = (const char*)request["message"];
-
-        if (messageType == "connect") {
-            handleConnectMessage();
-        } else if (messageType == "vu") {
-            handleVuMessage(request);
-        } else if (messageType == "white") {
-            handleWhiteMessage(request);
-        } else if (messageType == "brightness") {
-            handleBrightnessMessage(request);
-        } else if (messageType == "animation") {
-            handleAnimationMessage(request);
-        } else if (messageType == "colour") {
-            handleColorMessage(request);
+    if (!info->final || info->index != 0 || info->len != len) {
+        return;  // Fragmented frames aren't used by the web UI
+    }
+
+    if (info->opcode == WS_TEXT) {
+        handleJsonMessage(client, data, len);
+    } else if (info->opcode == WS_BINARY) {
+        handleBinaryMessage(data, len);
+    }
+}
+
+void WebUIManager::handleJsonMessage(AsyncWebSocketClient* client, const uint8_t* data, size_t len) {
+    unsigned long start = micros();
+
+    // Parse straight from the frame buffer (length-bounded, no terminator
+    // written) into a document backed by the arena
+    JsonDocument request(&arena_);
+    DeserializationError error = deserializeJson(request, (const char*)data, len);
+    if (error) {
+        controlStats_.rejected++;
+        Logger.warning("WebSocket message ignored: %s", error.c_str());
+        return;
+    }
+
+    const char* messageType = request["message"];
+    if (!messageType) {
+        controlStats_.rejected++;
+        return;
+    }
+
+    uint32_t typeHash = hashMessageType(messageType);
+    if (typeHash == hashMessageType("connect")) {
+        handleConnectMessage(client, request);
+        return;
+    }
+    if (typeHash == hashMessageType("subscribe")) {
+        handleSubscribeMessage(client, request);
+        return;
+    }
+    if (typeHash == hashMessageType("frames")) {
+        handleFramesMessage(client, request);
+        return;
+    }
+    if (typeHash == hashMessageType("batch")) {
+        handleBatchMessage(request);
+        controlStats_.jsonMessages++;
+        controlStats_.jsonDecodeUs += micros() - start;
+        return;
+    }
+
+    ControlProtocol::Control control;
+    if (!ControlJson::decodeControl(typeHash, request, control)) {
+        controlStats_.rejected++;
+        return;
+    }
+    controlStats_.jsonMessages++;
+    controlStats_.jsonDecodeUs += micros() - start;
+
+    controlQueue_.post(control);
+}
+
+void WebUIManager::handleBatchMessage(const JsonDocument& request) {
+    // {"message":"batch","commands":[{"message":"brightness","value":80},...]}
+    JsonArrayConst commands = request["commands"].as<JsonArrayConst>();
+    if (commands.size() > 1) {
+        controlStats_.batches++;
+    }
+
+    for (JsonVariantConst command : commands) {
+        const char* messageType = command["message"];
+        ControlProtocol::Control control;
+        if (!messageType || !ControlJson::decodeControl(hashMessageType(messageType), command, control)) {
+            controlStats_.rejected++;
+            continue;
+        }
+        controlQueue_.post(control);
+    }
+}
+
+void WebUIManager::handleBinaryMessage(const uint8_t* data, size_t len) {
+    unsigned long start = micros();
+
+    // One or more back-to-back control frames
+    if (len == 0 || len % ControlProtocol::FRAME_SIZE != 0) {
+        controlStats_.rejected++;
+        return;
+    }
+    if (len > ControlProtocol::FRAME_SIZE) {
+        controlStats_.batches++;
+    }
+
+    for (size_t pos = 0; pos < len; pos += ControlProtocol::FRAME_SIZE) {
+        ControlProtocol::Control control;
+        if (!ControlProtocol::decode(data + pos, ControlProtocol::FRAME_SIZE, control)) {
+            controlStats_.rejected++;
+            continue;
         }
+        controlQueue_.post(control);
+    }
+    controlStats_.binaryMessages++;
+    controlStats_.binaryDecodeUs += micros() - start;
+}
+
+String WebUIManager::generateStateResponse() {
+    unsigned long start = micros();
+
+    JsonDocument doc(&arena_);
+    doc["brightness"] = brightness;
+    doc["vu"] = vu;
+    doc["white"] = white;
+    JsonObject animation = doc["animation"].to<JsonObject>();
+    animation["state"] = showAnimation;
+    animation["index"] = (int)currentAnimation;
+
+    uint8_t r = 0, g = 0, b = 0;
+    if (g_colourWheel) {
+        g_colourWheel->getColorRGB(r, g, b);
+    }
+    char colour[8];
+    snprintf(colour, sizeof(colour), "#%02x%02x%02x", r, g, b);
+    doc["colour"] = colour;
+
+    String response;
+    serializeJson(doc, response);
+
+    stateApiStats_.gets++;
+    stateApiStats_.handlerUs += micros() - start;
+    return response;
+}
+
+bool WebUIManager::collectBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                               size_t index, size_t total, size_t maxBody) {
+    // Collect the body if it arrives in more than one chunk; the library
+    // frees _tempObject with the request
+    if (index == 0) {
+        if (total > maxBody) {
+            request->send(413, "text/plain", "Body too large");
+            return false;
+        }
+        request->_tempObject = malloc(total);
+        if (!request->_tempObject) {
+            request->send(503, "text/plain", "Out of memory");
+            return false;
+        }
+    }
+    uint8_t* body = (uint8_t*)request->_tempObject;
+    if (!body) {
+        return false;   // Rejected above, or out of memory
+    }
+    memcpy(body + index, data, len);
+    return index + len >= total;
+}
+
+void WebUIManager::handleStatePatch(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                                    size_t index, size_t total) {
+    static const size_t MAX_BODY = 512;
+
+    if (index == 0 && total > MAX_BODY) {
+        stateApiStats_.rejected++;
+    }
+    if (!collectBody(request, data, len, index, total, MAX_BODY)) {
+        return;
+    }
+    const uint8_t* body = (const uint8_t*)request->_tempObject;
+
+    unsigned long start = micros();
+    JsonDocument state(&arena_);
+    DeserializationError error = deserializeJson(state, (const char*)body, total);
+
+    ControlProtocol::Control controls[ControlQueue::SLOT_COUNT];
+    uint8_t count = 0;
+    if (error || !state.is<JsonObjectConst>() ||
+        !ControlJson::decodeState(state, (uint8_t)currentAnimation, controls, count)) {
+        stateApiStats_.rejected++;
+        stateApiStats_.handlerUs += micros() - start;
+        request->send(400, "application/json", "{\"ok\":false,\"error\":\"invalid state\"}");
+        return;
+    }
+
+    // All or nothing: the fields are queued together and applied in the
+    // same main loop pass, so the LEDs, the saved state (debounced) and the
+    // WebSocket broadcast (coalesced) each see one change
+    controlQueue_.post(controls, count);
+    stateApiStats_.patches++;
+    stateApiStats_.handlerUs += micros() - start;
+
+    char response[32];
+    snprintf(response, sizeof(response), "{\"ok\":true,\"fields\":%u}", count);
+    request->send(200, "application/json", response);
+}
+
+void WebUIManager::handleLayersPut(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                                   size_t index, size_t total) {
+    static const size_t MAX_BODY = 512;
+
+    if (!collectBody(request, data, len, index, total, MAX_BODY)) {
+        return;
+    }
+    const char* body = (const char*)request->_tempObject;
+
+    JsonDocument doc(&arena_);
+    DeserializationError error = deserializeJson(doc, body, total);
+    JsonArrayConst entries = doc["layers"];
+    if (error || entries.isNull() || entries.size() > LayerCompositor::MAX_LAYERS) {
+        request->send(400, "application/json", "{\"ok\":false,\"error\":\"invalid layers\"}");
+        return;
+    }
+
+    LayerCompositor::Layer layers[LayerCompositor::MAX_LAYERS];
+    uint8_t count = 0;
+    for (JsonObjectConst entry : entries) {
+        LayerCompositor::Layer& layer = layers[count++];
+        int effect = entry["effect"] | -1;
+        int opacity = entry["opacity"] | 255;
+        layer.blend = LayerCompositor::parseBlendName(entry["blend"] | "add");
+        if (effect < 0 || effect > 255 || opacity < 0 || opacity > 255) {
+            layer.blend = LayerCompositor::BLEND_COUNT;     // Rejected below
+        }
+        layer.effect = (uint8_t)effect;
+        layer.opacity = (uint8_t)opacity;
+    }
+
+    if (!g_ledManager || !g_ledManager->setLayers(layers, count)) {
+        request->send(400, "application/json", "{\"ok\":false,\"error\":\"invalid layers\"}");
+        return;
+    }
+
+    char response[32];
+    snprintf(response, sizeof(response), "{\"ok\":true,\"layers\":%u}", count);
+    request->send(200, "application/json", response);
+}
+
+String WebUIManager::generateLayersResponse() {
+    JsonDocument doc;
+    addLayers(doc["layers"].to<JsonArray>());
+    JsonArray modes = doc["blendModes"].to<JsonArray>();
+    for (uint8_t i = 0; i < LayerCompositor::BLEND_COUNT; i++) {
+        modes.add(LayerCompositor::getBlendName(i));
+    }
+
+    String output;
+    serializeJson(doc, output);
+    return output;
+}
+
+void WebUIManager::addLayers(JsonArray layers) {
+    if (!g_ledManager) {
+        return;
+    }
+
+    // Read on the AsyncTCP task while the main loop renders - a torn read
+    // only skews one sample of the cost figures
+    const LayerCompositor& compositor = g_ledManager->getCompositor();
+    for (uint8_t i = 0; i < compositor.getLayerCount(); i++) {
+        const LayerCompositor::ActiveLayer& active = compositor.getLayer(i);
+        JsonObject entry = layers.add<JsonObject>();
+        entry["effect"] = active.layer.effect;
+        entry["name"] = LEDManager::getAnimationDescription(static_cast<LEDManager::AnimationType>(active.layer.effect));
+        entry["blend"] = LayerCompositor::getBlendName(active.layer.blend);
+        entry["opacity"] = active.layer.opacity;
+
+        // Average cost per effect step and per blended frame
+        const LayerCompositor::LayerStats& stats = active.stats;
+        entry["renderUs"] = stats.renders ? stats.renderUs / stats.renders : 0;
+        entry["blendUs"] = stats.frames ? stats.blendUs / stats.frames : 0;
+        entry["frames"] = stats.frames;
+    }
+}
+
+void WebUIManager::handleZonesPut(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                                  size_t index, size_t total) {
+    static const size_t MAX_BODY = 1024;
+
+    if (!collectBody(request, data, len, index, total, MAX_BODY)) {
+        return;
+    }
+    const char* body = (const char*)request->_tempObject;
+
+    JsonDocument doc(&arena_);
+    DeserializationError error = deserializeJson(doc, body, total);
+    JsonArrayConst entries = doc["zones"];
+    if (error || entries.isNull() || entries.size() > LedZones::MAX_ZONES) {
+        request->send(400, "application/json", "{\"ok\":false,\"error\":\"invalid zones\"}");
+        return;
+    }
+
+    // {"name":"bar","firstStrip":0,"strips":2,"effect":12,"brightness":255,"audio":"spread"}
+    // effect -1 leaves the zone dark; audio is "spread" or a band 0-6
+    LedZones::Zone zones[LedZones::MAX_ZONES];
+    uint8_t count = 0;
+    bool valid = true;
+    for (JsonObjectConst entry : entries) {
+        LedZones::Zone& zone = zones[count++];
+        memset(&zone, 0, sizeof(zone));
+
+        const char* name = entry["name"] | "";
+        int firstStrip = entry["firstStrip"] | -1;
+        int strips = entry["strips"] | 0;
+        int effect = entry["effect"] | -1;
+        int brightness = entry["brightness"] | 255;
+        JsonVariantConst audio = entry["audio"];
+        int band = audio.is<int>() ? audio.as<int>() : (int)LedZones::AUDIO_SPREAD;
+
+        valid = valid && strlen(name) < LedZones::NAME_LENGTH &&
+                firstStrip >= 0 && firstStrip <= 255 && strips > 0 && strips <= 255 &&
+                effect >= -1 && effect < 255 && brightness >= 0 && brightness <= 255 &&
+                band >= 0 && band <= 255 && (audio.isNull() || audio.is<int>() || audio == "spread");
+        strncpy(zone.name, name, LedZones::NAME_LENGTH - 1);
+        zone.firstStrip = (uint8_t)firstStrip;
+        zone.stripCount = (uint8_t)strips;
+        zone.effect = effect < 0 ? (uint8_t)LedZones::EFFECT_OFF : (uint8_t)effect;
+        zone.brightness = (uint8_t)brightness;
+        zone.audioBand = (uint8_t)band;
+    }
+
+    if (!valid || !g_ledManager || !g_ledManager->setZones(zones, count)) {
+        request->send(400, "application/json", "{\"ok\":false,\"error\":\"invalid zones\"}");
+        return;
+    }
+
+    Logger.info("Saved %u LED zones", count);
+    char response[32];
+    snprintf(response, sizeof(response), "{\"ok\":true,\"zones\":%u}", count);
+    request->send(200, "application/json", response);
+}
+
+String WebUIManager::generateZonesResponse() {
+    JsonDocument doc;
+    JsonArray zones = doc["zones"].to<JsonArray>();
+    if (g_ledManager) {
+        const LedZones& ledZones = g_ledManager->getZones();
+        for (uint8_t i = 0; i < ledZones.getDefinedCount(); i++) {
+            const LedZones::Zone& zone = ledZones.getDefined(i);
+            JsonObject entry = zones.add<JsonObject>();
+            entry["name"] = zone.name;
+            entry["firstStrip"] = zone.firstStrip;
+            entry["strips"] = zone.stripCount;
+            if (zone.effect == LedZones::EFFECT_OFF) {
+                entry["effect"] = -1;
+            } else {
+                entry["effect"] = zone.effect;
+            }
+            entry["brightness"] = zone.brightness;
+            if (zone.audioBand == LedZones::AUDIO_SPREAD) {
+                entry["audio"] = "spread";
+            } else {
+                entry["audio"] = zone.audioBand;
+            }
+        }
+        doc["numStrips"] = g_ledManager->getNumStrips();
+        doc["active"] = ledZones.getCount();
+    }
+
+    JsonArray effects = doc["effects"].to<JsonArray>();
+    for (int i = LEDManager::RAINBOW; i <= LEDManager::CONFETTI; i++) {
+        effects.add(LEDManager::getAnimationDescription(static_cast<LEDManager::AnimationType>(i)));
+    }
+
+    String output;
+    serializeJson(doc, output);
+    return output;
+}
+
+void WebUIManager::handlePowerPut(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                                  size_t index, size_t total) {
+    static const size_t MAX_BODY = 512;
+
+    if (!collectBody(request, data, len, index, total, MAX_BODY)) {
+        return;
+    }
+    const char* body = (const char*)request->_tempObject;
+
+    JsonDocument doc(&arena_);
+    DeserializationError error = deserializeJson(doc, body, total);
+    JsonArrayConst entries = doc["supplies"];
+    if (error || entries.isNull() || entries.size() > PowerLimiter::MAX_SUPPLIES) {
+        request->send(400, "application/json", "{\"ok\":false,\"error\":\"invalid supplies\"}");
+        return;
+    }
+
+    PowerLimiter::Supply supplies[PowerLimiter::MAX_SUPPLIES];
+    uint8_t count = 0;
+    bool valid = true;
+    for (JsonObjectConst entry : entries) {
+        PowerLimiter::Supply& supply = supplies[count++];
+        int firstStrip = entry["firstStrip"] | -1;
+        int strips = entry["strips"] | 0;
+        long budgetMa = entry["budgetMa"] | 0L;
+
+        valid = valid && firstStrip >= 0 && firstStrip <= 255 && strips > 0 && strips <= 255 &&
+                budgetMa > 0 && budgetMa <= 65535;
+        supply.firstStrip = (uint8_t)firstStrip;
+        supply.stripCount = (uint8_t)strips;
+        supply.budgetMa = (uint16_t)budgetMa;
+    }
+
+    if (!valid || !g_ledManager || !g_ledManager->setPowerSupplies(supplies, count)) {
+        request->send(400, "application/json", "{\"ok\":false,\"error\":\"invalid supplies\"}");
+        return;
+    }
+
+    Logger.info("Saved power budget for %u supplies", count);
+    char response[32];
+    snprintf(response, sizeof(response), "{\"ok\":true,\"supplies\":%u}", count);
+    request->send(200, "application/json", response);
+}
+
+String WebUIManager::generatePowerResponse() {
+    JsonDocument doc;
+    JsonArray defined = doc["defined"].to<JsonArray>();
+    if (g_ledManager) {
+        const PowerLimiter& limiter = g_ledManager->getPowerLimiter();
+        for (uint8_t i = 0; i < limiter.getDefinedCount(); i++) {
+            const PowerLimiter::Supply& supply = limiter.getDefined(i);
+            JsonObject entry = defined.add<JsonObject>();
+            entry["firstStrip"] = supply.firstStrip;
+            entry["strips"] = supply.stripCount;
+            entry["budgetMa"] = supply.budgetMa;
+        }
+    }
+    addPower(doc["power"].to<JsonObject>());
+
+    String output;
+    serializeJson(doc, output);
+    return output;
+}
+
+void WebUIManager::addPower(JsonObject power) {
+    if (!g_ledManager) {
+        return;
+    }
+
+    // Same torn-read caveat as addLayers()
+    const PowerLimiter& limiter = g_ledManager->getPowerLimiter();
+    power["enabled"] = limiter.isEnabled();
+    power["limitUs"] = limiter.getAverageUs();
+
+    uint32_t estimatedMa = 0;
+    uint32_t throttleEvents = 0;
+    JsonArray supplies = power["supplies"].to<JsonArray>();
+    for (uint8_t i = 0; i < limiter.getCount(); i++) {
+        const PowerLimiter::Supply& supply = limiter.getSupply(i);
+        const PowerLimiter::SupplyStats& stats = limiter.getStats(i);
+        JsonObject entry = supplies.add<JsonObject>();
+        entry["firstStrip"] = supply.firstStrip;
+        entry["strips"] = supply.stripCount;
+        entry["budgetMa"] = supply.budgetMa;
+        entry["estimatedMa"] = stats.estimatedMa;
+        entry["peakMa"] = stats.peakMa;
+        entry["scale"] = stats.scale;
+        entry["throttledFrames"] = stats.throttledFrames;
+        entry["throttleEvents"] = stats.throttleEvents;
+        estimatedMa += stats.estimatedMa;
+        throttleEvents += stats.throttleEvents;
+    }
+    power["estimatedMa"] = estimatedMa;
+    power["throttleEvents"] = throttleEvents;
+}
+
+// Three gains, 0-255 each, in red, green, blue order
+static bool decodeGains(JsonVariantConst value, uint8_t* gains) {
+    JsonArrayConst array = value;
+    if (array.isNull() || array.size() != 3) {
+        return false;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        int gain = array[i] | -1;
+        if (gain < 0 || gain > 255) {
+            return false;
+        }
+        gains[i] = (uint8_t)gain;
+    }
+    return true;
+}
+
+void WebUIManager::handleOutputPut(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                                   size_t index, size_t total) {
+    static const size_t MAX_BODY = 1024;
+
+    if (!collectBody(request, data, len, index, total, MAX_BODY)) {
+        return;
+    }
+    const char* body = (const char*)request->_tempObject;
+
+    JsonDocument doc(&arena_);
+    DeserializationError error = deserializeJson(doc, body, total);
+    JsonArrayConst entries = doc["calibrations"];
+    if (error || entries.size() > OutputStage::MAX_CALIBRATIONS) {
+        request->send(400, "application/json", "{\"ok\":false,\"error\":\"invalid output settings\"}");
+        return;
+    }
+
+    // Missing fields fall back to the defaults, not the current settings -
+    // a PUT describes the whole output stage
+    OutputStage::Settings settings = OutputStage::defaults();
+    float gamma = doc["gamma"] | 1.0f;
+    settings.gamma = (uint8_t)constrain((int)(gamma * 10.0f + 0.5f), 0, 255);
+    settings.order = OutputStage::parseOrderName(doc["order"] | "GRB");
+    bool valid = doc["correction"].isNull() || decodeGains(doc["correction"], settings.correction);
+
+    for (JsonObjectConst entry : entries) {
+        OutputStage::Calibration& calibration = settings.calibrations[settings.calibrationCount++];
+        int firstStrip = entry["firstStrip"] | -1;
+        int strips = entry["strips"] | 0;
+        valid = valid && firstStrip >= 0 && firstStrip <= 255 && strips > 0 && strips <= 255 &&
+                decodeGains(entry["balance"], calibration.balance);
+        calibration.firstStrip = (uint8_t)firstStrip;
+        calibration.stripCount = (uint8_t)strips;
+    }
+
+    if (!valid || !g_ledManager || !g_ledManager->setOutputSettings(settings)) {
+        request->send(400, "application/json", "{\"ok\":false,\"error\":\"invalid output settings\"}");
+        return;
+    }
+
+    Logger.info("Saved output settings: gamma %u.%u, %s, %u calibrations", settings.gamma / 10,
+                settings.gamma % 10, OutputStage::getOrderName(settings.order), settings.calibrationCount);
+    request->send(200, "application/json", "{\"ok\":true}");
+}
+
+String WebUIManager::generateOutputResponse() {
+    JsonDocument doc;
+    if (g_ledManager) {
+        OutputStage::Settings settings = g_ledManager->getOutputStage().getSettings();
+        doc["gamma"] = settings.gamma / 10.0f;
+        doc["order"] = OutputStage::getOrderName(settings.order);
+        JsonArray correction = doc["correction"].to<JsonArray>();
+        for (uint8_t i = 0; i < 3; i++) {
+            correction.add(settings.correction[i]);
+        }
+
+        JsonArray calibrations = doc["calibrations"].to<JsonArray>();
+        for (uint8_t i = 0; i < settings.calibrationCount; i++) {
+            const OutputStage::Calibration& calibration = settings.calibrations[i];
+            JsonObject entry = calibrations.add<JsonObject>();
+            entry["firstStrip"] = calibration.firstStrip;
+            entry["strips"] = calibration.stripCount;
+            JsonArray balance = entry["balance"].to<JsonArray>();
+            for (uint8_t c = 0; c < 3; c++) {
+                balance.add(calibration.balance[c]);
+            }
+        }
+    }
+    addOutputStats(doc["stats"].to<JsonObject>());
+
+    String output;
+    serializeJson(doc, output);
+    return output;
+}
+
+void WebUIManager::addOutputStats(JsonObject output) {
+    if (!g_ledManager) {
+        return;
+    }
+
+    // Average cost of the LUT pass per frame and per pixel, plain and
+    // dithered, and of a table rebuild
+    OutputStage::Stats stats = g_ledManager->getOutputStage().getStats();
+    output["fps"] = stats.fps;
+    output["dithering"] = stats.dithering;
+    output["frames"] = stats.frames;
+    output["passUs"] = stats.frames ? stats.passUs / stats.frames : 0;
+    output["passNsPerPixel"] = stats.frames && stats.pixels
+        ? (uint32_t)((uint64_t)stats.passUs * 1000 / stats.frames / stats.pixels) : 0;
+    output["ditherFrames"] = stats.ditherFrames;
+    output["ditherUs"] = stats.ditherFrames ? stats.ditherUs / stats.ditherFrames : 0;
+    output["ditherNsPerPixel"] = stats.ditherFrames && stats.pixels
+        ? (uint32_t)((uint64_t)stats.ditherUs * 1000 / stats.ditherFrames / stats.pixels) : 0;
+    output["rebuilds"] = stats.rebuilds;
+    output["rebuildUs"] = stats.rebuilds ? stats.rebuildUs / stats.rebuilds : 0;
+}
+
+void WebUIManager::applyControl(const ControlProtocol::Control& control) {
+    switch (control.opcode) {
+        case ControlProtocol::OP_VU:
+            handleVu(control.payload[0] != 0);
+            break;
+        case ControlProtocol::OP_WHITE:
+            handleWhite(control.payload[0] != 0);
+            break;
+        case ControlProtocol::OP_BRIGHTNESS:
+            handleBrightness(control.payload[0]);
+            break;
+        case ControlProtocol::OP_ANIMATION:
+            handleAnimation(control.payload[0] != 0, control.payload[1]);
+            break;
+        case ControlProtocol::OP_COLOUR:
+            handleColour(control.payload[0], control.payload[1], control.payload[2]);
+            break;
+        default:
+            break;
+    }
+}
+
+void WebUIManager::applyPendingControls() {
+    ControlProtocol::Control pending[ControlQueue::SLOT_COUNT];
+    uint8_t count = controlQueue_.drain(pending);
+    for (uint8_t i = 0; i < count; i++) {
+        applyControl(pending[i]);
     }
 }
 
@@ -451,12 +1507,16 @@ void WebUIManager::onWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient
     switch (type) {
         case WS_EVT_CONNECT:
             Logger.debug("WebSocket client #%u connected from %s", client->id(), client->remoteIP().toString().c_str());
+            broadcaster_.addClient(client->id());
             break;
         case WS_EVT_DISCONNECT:
             Logger.debug("WebSocket client #%u disconnected", client->id());
+            broadcaster_.removeClient(client->id());
+            frameStreamer_.removeClient(client->id());
+            spectrumStreamer_.removeClient(client->id());
             break;
         case WS_EVT_DATA:
-            handleWebSocketMessage(arg, data, len);
+            handleWebSocketMessage(client, arg, data, len);
             break;
         case WS_EVT_PONG:
         case WS_EVT_ERROR:
@@ -464,55 +1524,132 @@ void WebUIManager::onWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient
     }
 }
 
-void WebUIManager::handleConnectMessage() {
-    webSocket_.textAll(generateAnimationsResponse());
-    webSocket_.textAll(generateStateResponse());
+void WebUIManager::onLogSocketEvent(AsyncWebSocketClient* client, AwsEventType type) {
+    if (type == WS_EVT_CONNECT) {
+        if (logClients_++ == 0) {
+            Logger.attachWebSocket(&logSocket_);
+        }
+    } else if (type == WS_EVT_DISCONNECT) {
+        if (logClients_ > 0 && --logClients_ == 0) {
+            // Nobody is watching - stop the Logger serializing lines for the socket
+            Logger.attachWebSocket(nullptr);
+        }
+    }
+}
+
+void WebUIManager::handleConnectMessage(AsyncWebSocketClient* client, const JsonDocument& request) {
+    // Only the connecting client needs the animation list and full state
+    if (animationsMessage_) {
+        client->text(animationsMessage_);
+    }
+
+    // Binary controls: confirm if the client asked for a version we speak
+    if ((int)request["binary"] == ControlProtocol::VERSION) {
+        static const char PROTOCOL_REPLY[] = "{\"message\":\"protocol\",\"binary\":1}";
+        client->text(PROTOCOL_REPLY, sizeof(PROTOCOL_REPLY) - 1);
+    }
+
+    broadcaster_.requestFullState(client->id());
+}
+
+void WebUIManager::handleFramesMessage(AsyncWebSocketClient* client, const JsonDocument& request) {
+    int fps = constrain(request["fps"] | 15, 0, (int)FrameStreamer::MAX_FPS);
+    int scale = request["scale"] | 1;
+    if (!frameStreamer_.subscribe(client->id(), fps, constrain(scale, 1, (int)FrameStreamer::MAX_SCALE))) {
+        Logger.warning("Frame stream: no free subscriber slot for client #%u", client->id());
+        return;
+    }
+    Logger.debug("Frame stream: client #%u at %d fps, scale %d", client->id(), fps, scale);
 }
 
-void WebUIManager::handleVuMessage(const JsonDocument& request) {
+void WebUIManager::handleSubscribeMessage(AsyncWebSocketClient* client, const JsonDocument& request) {
+    // {"message":"subscribe","topics":["state","frames","spectrum"],"fps":15,"scale":1,"hz":30}
+    // replaces the client's topic set
+    uint8_t topics = 0;
+    for (JsonVariantConst topic : request["topics"].as<JsonArrayConst>()) {
+        const char* name = topic;
+        if (!name) {
+            continue;
+        }
+        switch (hashMessageType(name)) {
+            case hashMessageType("state"):
+                topics |= TOPIC_STATE;
+                break;
+            case hashMessageType("frames"):
+                topics |= TOPIC_FRAMES;
+                break;
+            case hashMessageType("spectrum"):
+                topics |= TOPIC_SPECTRUM;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Remove first so the client is never listed twice
+    broadcaster_.removeClient(client->id());
+    if (topics & TOPIC_STATE) {
+        broadcaster_.addClient(client->id());
+        broadcaster_.requestFullState(client->id());
+    }
+
+    if (topics & TOPIC_FRAMES) {
+        handleFramesMessage(client, request);
+    } else {
+        frameStreamer_.removeClient(client->id());
+    }
+
+    if (topics & TOPIC_SPECTRUM) {
+        int hz = constrain(request["hz"] | (int)SpectrumStreamer::DEFAULT_HZ, 1, (int)SpectrumStreamer::MAX_HZ);
+        if (!spectrumStreamer_.subscribe(client->id(), hz)) {
+            Logger.warning("Spectrum stream: no free subscriber slot for client #%u", client->id());
+        }
+    } else {
+        spectrumStreamer_.removeClient(client->id());
+    }
+}
+
+void WebUIManager::handleVu(bool state) {
     if (g_uiManager) {
-        g_uiManager->setVuState((bool)request["value"]);
+        g_uiManager->setVuState(state);
     }
     notifyClients();
 }
 
-void WebUIManager::handleWhiteMessage(const JsonDocument& request) {
+void WebUIManager::handleWhite(bool state) {
     if (g_uiManager) {
-        g_uiManager->setWhiteState((bool)request["value"]);
+        g_uiManager->setWhiteState(state);
     }
     notifyClients();
 }
 
-void WebUIManager::handleBrightnessMessage(const JsonDocument& request) {
-    int newBrightness = (int)request["value"];
+void WebUIManager::handleBrightness(uint8_t value) {
     if (g_brightnessSlider) {
         // Trigger callback to update global state and notify other clients
-        g_brightnessSlider->setBrightness(newBrightness, true, true);
+        g_brightnessSlider->setBrightness(value, true, true);
     } else {
-        brightness = newBrightness;
+        brightness = value;
         if (g_ledManager) {
-            g_ledManager->setBrightness(newBrightness);
+            g_ledManager->setBrightness(value);
         }
         notifyClients();
     }
 }
 
-void WebUIManager::handleAnimationMessage(const JsonDocument& request) {
-    bool runAnimation = (bool)request["value"];
+void WebUIManager::handleAnimation(bool runAnimation, int animation) {
     if (g_uiManager) {
         if (runAnimation) {
-            g_uiManager->setAnimation((int)request["animation"]);
+            g_uiManager->setAnimation(animation);
         }
         g_uiManager->setAnimationState(runAnimation);
     }
     notifyClients();
 }
 
-void WebUIManager::handleColorMessage(const JsonDocument& request) {
+void WebUIManager::handleColour(uint8_t r, uint8_t g, uint8_t b) {
     if (g_colourWheel) {
-        String hexValue = (const char*)request["value"];
-        Logger.debug("Hex value: %s", hexValue.c_str());
-        g_colourWheel->setColor(hexValue);
+        Logger.debug("Colour: %02x%02x%02x", r, g, b);
+        g_colourWheel->setColor(r, g, b);
     }
 }
 
@@ -524,6 +1661,13 @@ void WebUIManager::staticWebSocketEventHandler(AsyncWebSocket* server, AsyncWebS
     }
 }
 
+void WebUIManager::staticLogSocketEventHandler(AsyncWebSocket* server, AsyncWebSocketClient* client,
+                                               AwsEventType type, void* arg, uint8_t* data, size_t len) {
+    if (g_webUIManager) {
+        g_webUIManager->onLogSocketEvent(client, type);
+    }
+}
+
 // Legacy function compatibility
 void setupWebUi() {
     // NOTE: This legacy function is deprecated
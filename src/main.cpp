@@ -10,6 +10,8 @@
 #include <Preferences.h>
 #include "LEDManager.h"
 #include "WebUIManager.h"
+#include "BootProfiler.h"
+#include "Metrics.h"
 #include <memory>
 
 // Global UI manager and component instances
@@ -41,14 +43,22 @@ WiFiSetupBootUI* g_bootUI = nullptr;
 bool g_restartRequested = false;
 unsigned long g_restartTime = 0;
 
+// Set by the OTA end callback (AsyncTCP task); the LED state snapshot is
+// taken here on the main loop, which owns the LED state
+volatile bool g_restartSnapshotRequested = false;
+
 void setup(void)
 {
   Serial.begin(115200);
-  delay(1000);
 
   // Initialize logger early (before WiFi so we can log WiFi setup)
   Logger.begin(200, true, true);  // 200 log entries, Serial enabled, WebSocket enabled
   Logger.info("ModularUI Controller Starting...");
+  g_bootProfiler.mark("logger");
+
+  // LittleFS is only needed by the web UI - mount it on a background task
+  // while the display and Wi-Fi come up
+  WebUIManager::startFilesystemMount();
 
   // Initialize UI Manager
   if (!g_uiManager) {
@@ -57,7 +67,9 @@ void setup(void)
 
   if (g_uiManager) {
     // Always initialize the basic screen for LVGL
+    int screenPhase = g_bootProfiler.beginPhase("screen");
     g_uiManager->initializeScreen();
+    g_bootProfiler.endPhase(screenPhase);
 
     // OLD: Initialize BootUI (built-in version)
     // g_bootUI = new BootUI();
@@ -117,6 +129,7 @@ void setup(void)
     // }
 
     // Start WiFi setup
+    int wifiPhase = g_bootProfiler.beginPhase("wifi");
     if (g_wifiManager) {
       // Pre-load device name from Preferences before begin() so it's available for callbacks
       if (g_bootUI) {
@@ -131,11 +144,27 @@ void setup(void)
       g_wifiManager->begin();
       Logger.info("Logger web interface available at /logs");
     }
+    g_bootProfiler.endPhase(wifiPhase);
 
     // Only initialize full UI components and LED manager if not in setup mode
     if (g_wifiManager && !g_wifiManager->isInSetupMode()) {
+      // LEDs first - the fade-in starts now and runs from loop(), so the
+      // strips light up while the UI and web server are still being built
+      int ledPhase = g_bootProfiler.beginPhase("leds");
+      if (!g_ledManager) {
+        g_ledManager = new LEDManager();
+      }
+      if (g_ledManager) {
+        g_ledManager->initialize();
+        g_ledManager->startFadeIn();
+      }
+      g_bootProfiler.endPhase(ledPhase);
+
       // Initialize full UI components
-      if (g_uiManager->initializeUI()) {
+      int uiPhase = g_bootProfiler.beginPhase("ui");
+      bool uiReady = g_uiManager->initializeUI();
+      g_bootProfiler.endPhase(uiPhase);
+      if (uiReady) {
         // Update global pointers for components that still need them
         g_brightnessSlider = g_uiManager->getBrightnessSlider();
         g_colourWheel = g_uiManager->getColourWheel();
@@ -143,14 +172,11 @@ void setup(void)
         g_whiteButton = g_uiManager->getWhiteButton();
         g_vuButton = g_uiManager->getVuButton();
         g_vuGraph = g_uiManager->getVuGraph();
-      }
-      
-      // Initialize LED Manager
-      if (!g_ledManager) {
-        g_ledManager = new LEDManager();
-      }
-      if (g_ledManager) {
-        g_ledManager->initialize();
+
+        // Sync UI components with loaded LED state
+        if (g_ledManager) {
+          g_uiManager->syncWithLEDState();
+        }
       }
     }
     // If in setup mode, the WiFi manager will show the AP setup screen
@@ -161,25 +187,22 @@ void setup(void)
     g_webUIManager = new WebUIManager(g_wifiManager->getWebServer());
   }
   if (g_webUIManager) {
+    int webPhase = g_bootProfiler.beginPhase("webui");
     g_webUIManager->initialize();
 
-    // Attach WebSocket to Logger for real-time log broadcasting
-    Logger.attachWebSocket(g_webUIManager->getWebSocket());
+    // Logger is attached to its own WebSocket by WebUIManager while a /logs
+    // page is connected, so log lines never reach the control clients
+    g_bootProfiler.endPhase(webPhase);
   }
-  
-  // Perform startup fade-in after all initialization is complete (only if not in setup mode)
-  if (g_ledManager && g_wifiManager && !g_wifiManager->isInSetupMode()) {
-    g_ledManager->performStartupFadeIn();
 
-    // Sync UI components with loaded LED state
-    if (g_uiManager) {
-      g_uiManager->syncWithLEDState();
-    }
-  }
+  // "first-led" and "fade-done" are recorded later, from the main loop
+  g_bootProfiler.finish();
 }
 
 void loop()
 {
+  METRICS_SCOPE(LOOP);
+
   // LVGL 9 requires tick updates for proper timing
   static uint32_t lastTick = 0;
   uint32_t currentMillis = millis();
@@ -198,6 +221,13 @@ void loop()
   } else {
     lv_timer_handler(); /* let the GUI do its work */
   }
+
+  // First LVGL pass - the screen is drawn and touch input is read from here on
+  static bool firstFrame = true;
+  if (firstFrame) {
+    firstFrame = false;
+    g_bootProfiler.mark("first-frame");
+  }
   
   // Update WiFi manager (handles DNS in AP mode)
   if (g_wifiManager) {
@@ -214,6 +244,15 @@ void loop()
     g_webUIManager->update();
   }
 
+  // Snapshot the LED state for a finished OTA update before the OTA
+  // manager gets to restart
+  if (g_restartSnapshotRequested) {
+    g_restartSnapshotRequested = false;
+    if (g_ledManager) {
+      g_ledManager->prepareForRestart();
+    }
+  }
+
   // Update OTA manager
   if (g_otaManager) {
     g_otaManager->loop();
@@ -224,6 +263,10 @@ void loop()
     g_restartTime = millis();
   }
   if (g_restartTime > 0 && millis() - g_restartTime > 2000) {
+    // Hand the LED state over so the lights resume instead of fading in again
+    if (g_ledManager) {
+      g_ledManager->prepareForRestart();
+    }
     ESP.restart();
   }
 }
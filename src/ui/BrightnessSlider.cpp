@@ -2,11 +2,7 @@
 #include "BrightnessSlider.h"
 #include "ui.h"
 #include "modular-ui.h"
-
-// Static member definitions
-lv_style_t BrightnessSlider::indicatorStyle_;
-lv_style_t BrightnessSlider::knobStyle_;
-bool BrightnessSlider::stylesInitialized_ = false;
+#include "UIStyles.h"
 
 BrightnessSlider::BrightnessSlider(int maxBrightness)
     : slider_(nullptr)
@@ -66,33 +62,6 @@ BrightnessSlider& BrightnessSlider::operator=(BrightnessSlider&& other) noexcept
     return *this;
 }
 
-void BrightnessSlider::initializeStyles() {
-    if (stylesInitialized_) {
-        return;
-    }
-
-    // === INDICATOR STYLE - Bright cyan fill ===
-    lv_style_init(&indicatorStyle_);
-    lv_style_set_bg_opa(&indicatorStyle_, LV_OPA_COVER);
-    lv_style_set_bg_color(&indicatorStyle_, lv_color_hex(UI_COLOR_PRIMARY));
-    lv_style_set_bg_grad_color(&indicatorStyle_, lv_color_hex(UI_COLOR_PRIMARY_DARK));
-    lv_style_set_bg_grad_dir(&indicatorStyle_, LV_GRAD_DIR_VER);
-    lv_style_set_radius(&indicatorStyle_, UI_RADIUS_SMALL);
-
-    // === KNOB STYLE - High contrast, visible knob ===
-    lv_style_init(&knobStyle_);
-    lv_style_set_bg_color(&knobStyle_, lv_color_hex(UI_COLOR_WHITE));
-    lv_style_set_bg_grad_color(&knobStyle_, lv_color_hex(UI_COLOR_TEXT));
-    lv_style_set_bg_grad_dir(&knobStyle_, LV_GRAD_DIR_VER);
-    lv_style_set_radius(&knobStyle_, UI_RADIUS_SMALL);
-    lv_style_set_width(&knobStyle_, 44);
-    lv_style_set_height(&knobStyle_, 16);
-    lv_style_set_border_color(&knobStyle_, lv_color_hex(UI_COLOR_PRIMARY));
-    lv_style_set_border_width(&knobStyle_, UI_BORDER_NORMAL);
-
-    stylesInitialized_ = true;
-}
-
 void BrightnessSlider::createLabel() {
     // Label created separately - parent container handles it for vertical layout
     label_ = nullptr;
@@ -123,21 +92,12 @@ void BrightnessSlider::createSlider() {
 void BrightnessSlider::applySliderStyling() {
     if (!slider_) return;
 
-    // Initialize styles if not done yet
-    initializeStyles();
-
     // === TRACK STYLE - Metallic recessed look ===
-    lv_obj_set_style_bg_color(slider_, lv_color_hex(UI_COLOR_SURFACE_DARK), 0);
-    lv_obj_set_style_bg_grad_color(slider_, lv_color_hex(UI_COLOR_TRACK), 0);
-    lv_obj_set_style_bg_grad_dir(slider_, LV_GRAD_DIR_HOR, 0);
-    lv_obj_set_style_radius(slider_, UI_RADIUS_SMALL, 0);
-    lv_obj_set_style_border_color(slider_, lv_color_hex(UI_COLOR_BORDER), 0);
-    lv_obj_set_style_border_width(slider_, UI_BORDER_THIN, 0);
-    lv_obj_set_style_border_side(slider_, LV_BORDER_SIDE_FULL, 0);
+    lv_obj_add_style(slider_, &ui_style_slider_track, 0);
 
     // Apply indicator and knob styles
-    lv_obj_add_style(slider_, &indicatorStyle_, LV_PART_INDICATOR);
-    lv_obj_add_style(slider_, &knobStyle_, LV_PART_KNOB);
+    lv_obj_add_style(slider_, &ui_style_slider_indicator, LV_PART_INDICATOR);
+    lv_obj_add_style(slider_, &ui_style_slider_knob, LV_PART_KNOB);
 }
 
 void BrightnessSlider::eventHandlerWrapper(lv_event_t* e) {
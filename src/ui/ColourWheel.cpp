@@ -80,14 +80,17 @@ void ColourWheel::setCallback(ColorChangeCallback callback) {
 }
 
 void ColourWheel::setColor(const String& hexString) {
-    if (!initialized_ || !colorWheel_) return;
+    setColor(hexString.c_str());
+}
+
+void ColourWheel::setColor(const char* hexString) {
+    if (!initialized_ || !colorWheel_ || !hexString) return;
 
-    String clean = hexString;
-    if (clean.startsWith("#")) {
-        clean = clean.substring(1);
+    if (*hexString == '#') {
+        hexString++;
     }
 
-    int number = (int)strtol(clean.c_str(), nullptr, 16);
+    int number = (int)strtol(hexString, nullptr, 16);
     uint8_t r = (number >> 16) & 0xFF;
     uint8_t g = (number >> 8)  & 0xFF;
     uint8_t b =  number        & 0xFF;
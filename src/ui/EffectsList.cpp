@@ -2,6 +2,7 @@
 #include "modular-ui.h"
 #include "ui.h"
 #include "WhiteButton.h"
+#include "UIStyles.h"
 
 EffectsList::EffectsList()
     : dropdown_(nullptr)
@@ -70,19 +71,17 @@ bool EffectsList::initialize(lv_obj_t* parent) {
         // Dropdown opens upward (drop-up) since button is at bottom
         lv_dropdown_set_dir(dropdown_, LV_DIR_TOP);
 
-        // === Style the main button part ===
-        lv_obj_set_style_bg_color(dropdown_, lv_color_hex(UI_COLOR_SURFACE_LIGHT), 0);
-        lv_obj_set_style_bg_grad_color(dropdown_, lv_color_hex(UI_COLOR_SURFACE_DARK), 0);
-        lv_obj_set_style_bg_grad_dir(dropdown_, LV_GRAD_DIR_VER, 0);
-        lv_obj_set_style_border_color(dropdown_, lv_color_hex(UI_COLOR_BORDER), 0);
-        lv_obj_set_style_border_width(dropdown_, UI_BORDER_NORMAL, 0);
-        lv_obj_set_style_radius(dropdown_, UI_RADIUS_MEDIUM, 0);
-        lv_obj_set_style_text_color(dropdown_, lv_color_hex(UI_COLOR_TEXT), 0);
-        lv_obj_set_style_pad_all(dropdown_, UI_PADDING_SMALL, 0);
+        // === Style the main button part - same hardware look as VU/White ===
+        lv_obj_add_style(dropdown_, &ui_style_button, 0);
+        lv_obj_add_style(dropdown_, &ui_style_dropdown, 0);
 
-        // Pressed state
-        lv_obj_set_style_bg_color(dropdown_, lv_color_hex(UI_COLOR_SURFACE), LV_STATE_PRESSED);
-        lv_obj_set_style_border_color(dropdown_, lv_color_hex(UI_COLOR_PRIMARY), LV_STATE_PRESSED);
+        // Active (animation running) - same cyan look as VU/White when on.
+        // UI_STATE_ACTIVE rather than CHECKED: the dropdown sets CHECKED itself while open
+        lv_obj_add_style(dropdown_, &ui_style_button_checked, UI_STATE_ACTIVE);
+
+        // Pressed state (also while active)
+        lv_obj_add_style(dropdown_, &ui_style_dropdown_pressed, LV_STATE_PRESSED);
+        lv_obj_add_style(dropdown_, &ui_style_dropdown_pressed, UI_STATE_ACTIVE | LV_STATE_PRESSED);
 
         // Disable scrolling/drag on the dropdown itself
         lv_obj_clear_flag(dropdown_, LV_OBJ_FLAG_SCROLLABLE);
@@ -119,22 +118,17 @@ void EffectsList::setActiveState(bool active) {
         return;
     }
 
+    if (active == activeState_ && lv_obj_has_state(dropdown_, UI_STATE_ACTIVE) == active) {
+        return;  // Nothing to restyle
+    }
+
     activeState_ = active;
 
+    // Active/inactive looks are both attached in initialize() - just switch state
     if (active) {
-        // Active state - bright cyan border, like VU/White buttons when on
-        lv_obj_set_style_bg_color(dropdown_, lv_color_hex(UI_COLOR_PRIMARY), 0);
-        lv_obj_set_style_bg_grad_color(dropdown_, lv_color_hex(UI_COLOR_PRIMARY_DARK), 0);
-        lv_obj_set_style_border_color(dropdown_, lv_color_hex(UI_COLOR_WHITE), 0);
-        lv_obj_set_style_border_width(dropdown_, UI_BORDER_THICK, 0);
-        lv_obj_set_style_text_color(dropdown_, lv_color_hex(UI_COLOR_BLACK), 0);
+        lv_obj_add_state(dropdown_, UI_STATE_ACTIVE);
     } else {
-        // Inactive state - dark hardware button look
-        lv_obj_set_style_bg_color(dropdown_, lv_color_hex(UI_COLOR_SURFACE_LIGHT), 0);
-        lv_obj_set_style_bg_grad_color(dropdown_, lv_color_hex(UI_COLOR_SURFACE_DARK), 0);
-        lv_obj_set_style_border_color(dropdown_, lv_color_hex(UI_COLOR_BORDER), 0);
-        lv_obj_set_style_border_width(dropdown_, UI_BORDER_NORMAL, 0);
-        lv_obj_set_style_text_color(dropdown_, lv_color_hex(UI_COLOR_TEXT), 0);
+        lv_obj_remove_state(dropdown_, UI_STATE_ACTIVE);
     }
 }
 
@@ -158,17 +152,15 @@ void EffectsList::eventHandler(lv_event_t* event) {
 void EffectsList::openHandler(lv_event_t* event) {
     lv_obj_t* dropdown = static_cast<lv_obj_t*>(lv_event_get_target(event));
     lv_obj_t* list = lv_dropdown_get_list(dropdown);
-    if (list) {
+    if (list && !lv_obj_has_flag(list, LV_OBJ_FLAG_USER_1)) {
+        // The list object is kept between openings - style it once
+        lv_obj_add_flag(list, LV_OBJ_FLAG_USER_1);
+
         // Style the dropdown list
-        lv_obj_set_style_bg_color(list, lv_color_hex(UI_COLOR_SURFACE), 0);
-        lv_obj_set_style_border_color(list, lv_color_hex(UI_COLOR_PRIMARY), 0);
-        lv_obj_set_style_border_width(list, UI_BORDER_NORMAL, 0);
-        lv_obj_set_style_radius(list, UI_RADIUS_MEDIUM, 0);
-        lv_obj_set_style_text_color(list, lv_color_hex(UI_COLOR_TEXT), 0);
+        lv_obj_add_style(list, &ui_style_dropdown_list, 0);
 
         // Selected item style
-        lv_obj_set_style_bg_color(list, lv_color_hex(UI_COLOR_PRIMARY), LV_PART_SELECTED);
-        lv_obj_set_style_text_color(list, lv_color_hex(UI_COLOR_BLACK), LV_PART_SELECTED);
+        lv_obj_add_style(list, &ui_style_dropdown_list_selected, LV_PART_SELECTED);
 
         // Allow vertical scroll only, disable horizontal drag/scroll
         lv_obj_add_flag(list, LV_OBJ_FLAG_SCROLLABLE);
@@ -0,0 +1,421 @@
+#include "LedPreview.h"
+#include "LEDManager.h"
+#include "UIStyles.h"
+
+// Above this many changed rows a single bounding box is invalidated instead of
+// one area per row (LVGL falls back to a full-screen redraw when its
+// invalidation buffer overflows)
+static const int MAX_ROW_INVALIDATIONS = 16;
+
+static inline uint16_t toRgb565(const CRGB& c) {
+    return ((c.r & 0xF8) << 8) | ((c.g & 0xFC) << 3) | (c.b >> 3);
+}
+
+static inline lv_color_t fromRgb565(uint16_t c) {
+    return lv_color_make(((c >> 11) & 0x1F) << 3, ((c >> 5) & 0x3F) << 2, (c & 0x1F) << 3);
+}
+
+LedPreview::LedPreview()
+    : obj_(nullptr)
+    , initialized_(false)
+    , ledCols_(0)
+    , ledRows_(0)
+    , cols_(0)
+    , rows_(0)
+    , cellPx_(0)
+    , offsetX_(0)
+    , offsetY_(0)
+    , cells_(nullptr)
+    , lastFrameSeq_(0)
+    , lastUpdate_(0)
+    , windowStart_(0)
+    , samples_(0)
+    , sampleUs_(0)
+    , drawUs_(0)
+    , changedCells_(0)
+    , maxSampleUs_(0)
+    , lastStats_()
+{
+}
+
+LedPreview::~LedPreview() {
+    cleanup();
+}
+
+LedPreview::LedPreview(LedPreview&& other) noexcept
+    : obj_(other.obj_)
+    , initialized_(other.initialized_)
+    , ledCols_(other.ledCols_)
+    , ledRows_(other.ledRows_)
+    , cols_(other.cols_)
+    , rows_(other.rows_)
+    , cellPx_(other.cellPx_)
+    , offsetX_(other.offsetX_)
+    , offsetY_(other.offsetY_)
+    , cells_(other.cells_)
+    , lastFrameSeq_(other.lastFrameSeq_)
+    , lastUpdate_(other.lastUpdate_)
+    , windowStart_(other.windowStart_)
+    , samples_(other.samples_)
+    , sampleUs_(other.sampleUs_)
+    , drawUs_(other.drawUs_)
+    , changedCells_(other.changedCells_)
+    , maxSampleUs_(other.maxSampleUs_)
+    , lastStats_(other.lastStats_)
+{
+    if (obj_) {
+        lv_obj_set_user_data(obj_, this);
+    }
+
+    other.obj_ = nullptr;
+    other.cells_ = nullptr;
+    other.initialized_ = false;
+}
+
+LedPreview& LedPreview::operator=(LedPreview&& other) noexcept {
+    if (this != &other) {
+        cleanup();
+
+        obj_ = other.obj_;
+        initialized_ = other.initialized_;
+        ledCols_ = other.ledCols_;
+        ledRows_ = other.ledRows_;
+        cols_ = other.cols_;
+        rows_ = other.rows_;
+        cellPx_ = other.cellPx_;
+        offsetX_ = other.offsetX_;
+        offsetY_ = other.offsetY_;
+        cells_ = other.cells_;
+        lastFrameSeq_ = other.lastFrameSeq_;
+        lastUpdate_ = other.lastUpdate_;
+        windowStart_ = other.windowStart_;
+        samples_ = other.samples_;
+        sampleUs_ = other.sampleUs_;
+        drawUs_ = other.drawUs_;
+        changedCells_ = other.changedCells_;
+        maxSampleUs_ = other.maxSampleUs_;
+        lastStats_ = other.lastStats_;
+
+        if (obj_) {
+            lv_obj_set_user_data(obj_, this);
+        }
+
+        other.obj_ = nullptr;
+        other.cells_ = nullptr;
+        other.initialized_ = false;
+    }
+    return *this;
+}
+
+bool LedPreview::initialize(lv_obj_t* parent, int32_t width, int32_t height) {
+    if (initialized_) {
+        return true;
+    }
+
+    if (!parent) {
+        return false;
+    }
+
+    try {
+        obj_ = lv_obj_create(parent);
+        if (!obj_) {
+            return false;
+        }
+
+        lv_obj_set_size(obj_, width, height);
+        lv_obj_add_style(obj_, &ui_style_panel_inset, 0);
+        lv_obj_clear_flag(obj_, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_clear_flag(obj_, LV_OBJ_FLAG_CLICKABLE);
+
+        lv_obj_set_user_data(obj_, this);
+        lv_obj_add_event_cb(obj_, drawEvent, LV_EVENT_DRAW_MAIN, nullptr);
+
+        windowStart_ = millis();
+        initialized_ = true;
+        return true;
+
+    } catch (...) {
+        cleanup();
+        return false;
+    }
+}
+
+bool LedPreview::layoutGrid() {
+    if (!g_ledManager || !g_ledManager->isConfigValid()) {
+        return false;
+    }
+
+    int ledCols = g_ledManager->getLedsPerStrip();
+    int ledRows = g_ledManager->getNumStrips();
+    if (cells_ && ledCols == ledCols_ && ledRows == ledRows_) {
+        return true;  // Layout unchanged
+    }
+
+    freeCells();
+
+    lv_obj_update_layout(obj_);
+    int32_t width = lv_obj_get_content_width(obj_);
+    int32_t height = lv_obj_get_content_height(obj_);
+    if (width <= 0 || height <= 0 || ledCols <= 0 || ledRows <= 0) {
+        return false;
+    }
+
+    // Downsample to the cell budget, then to what fits on screen at >= 1px per cell
+    int cols = ledCols < MAX_COLS ? ledCols : MAX_COLS;
+    int rows = ledRows < MAX_ROWS ? ledRows : MAX_ROWS;
+    if (cols > width) cols = width;
+    if (rows > height) rows = height;
+
+    int cellPx = width / cols;
+    if (height / rows < cellPx) {
+        cellPx = height / rows;
+    }
+    if (cellPx < 1) {
+        cellPx = 1;
+    }
+
+    cells_ = new uint16_t[cols * rows];
+    if (!cells_) {
+        return false;
+    }
+    memset(cells_, 0, cols * rows * sizeof(uint16_t));
+
+    ledCols_ = ledCols;
+    ledRows_ = ledRows;
+    cols_ = cols;
+    rows_ = rows;
+    cellPx_ = cellPx;
+    offsetX_ = (width - cols * cellPx) / 2;
+    offsetY_ = (height - rows * cellPx) / 2;
+    lastFrameSeq_ = 0;
+
+    lv_obj_invalidate(obj_);
+    return true;
+}
+
+void LedPreview::update() {
+    if (!initialized_ || !obj_) {
+        return;
+    }
+
+    unsigned long now = millis();
+    rollWindow(now);
+
+    if (now - lastUpdate_ < UPDATE_INTERVAL_MS) {
+        return;
+    }
+    lastUpdate_ = now;
+
+    if (!layoutGrid()) {
+        return;
+    }
+
+    const CRGB* frame = g_ledManager->getFrame();
+    uint32_t frameSeq = g_ledManager->getFrameSequence();
+    if (!frame || frameSeq == lastFrameSeq_) {
+        return;  // Nothing new was shown
+    }
+    lastFrameSeq_ = frameSeq;
+
+    uint32_t startUs = micros();
+
+    // Point-sample the centre LED of each cell; track the changed column span per row
+    int16_t spanMin[MAX_ROWS];
+    int16_t spanMax[MAX_ROWS];
+    int changedRows = 0;
+    uint32_t changed = 0;
+
+    for (int row = 0; row < rows_; row++) {
+        int ledY = ((2 * row + 1) * ledRows_) / (2 * rows_);
+        uint16_t* cellRow = &cells_[row * cols_];
+        spanMin[row] = -1;
+        spanMax[row] = -1;
+
+        for (int col = 0; col < cols_; col++) {
+            int ledX = ((2 * col + 1) * ledCols_) / (2 * cols_);
+            int index = g_ledManager->xyToIndex(ledX, ledY);
+            uint16_t colour = (index >= 0) ? toRgb565(frame[index]) : 0;
+
+            if (colour != cellRow[col]) {
+                cellRow[col] = colour;
+                if (spanMin[row] < 0) {
+                    spanMin[row] = col;
+                }
+                spanMax[row] = col;
+                changed++;
+            }
+        }
+
+        if (spanMin[row] >= 0) {
+            changedRows++;
+        }
+    }
+
+    if (changedRows > MAX_ROW_INVALIDATIONS) {
+        // Many rows changed - one bounding box keeps LVGL's invalidation buffer small
+        int first = -1, last = -1, minCol = cols_, maxCol = -1;
+        for (int row = 0; row < rows_; row++) {
+            if (spanMin[row] < 0) continue;
+            if (first < 0) first = row;
+            last = row;
+            if (spanMin[row] < minCol) minCol = spanMin[row];
+            if (spanMax[row] > maxCol) maxCol = spanMax[row];
+        }
+
+        lv_area_t content;
+        lv_obj_get_content_coords(obj_, &content);
+        lv_area_t area;
+        area.x1 = content.x1 + offsetX_ + minCol * cellPx_;
+        area.x2 = content.x1 + offsetX_ + (maxCol + 1) * cellPx_ - 1;
+        area.y1 = content.y1 + offsetY_ + first * cellPx_;
+        area.y2 = content.y1 + offsetY_ + (last + 1) * cellPx_ - 1;
+        lv_obj_invalidate_area(obj_, &area);
+    } else if (changedRows > 0) {
+        for (int row = 0; row < rows_; row++) {
+            if (spanMin[row] >= 0) {
+                invalidateSpan(row, spanMin[row], spanMax[row]);
+            }
+        }
+    }
+
+    uint32_t elapsedUs = micros() - startUs;
+    samples_++;
+    sampleUs_ += elapsedUs;
+    changedCells_ += changed;
+    if (elapsedUs > maxSampleUs_) {
+        maxSampleUs_ = elapsedUs;
+    }
+}
+
+void LedPreview::invalidateSpan(int row, int col0, int col1) {
+    lv_area_t content;
+    lv_obj_get_content_coords(obj_, &content);
+
+    lv_area_t area;
+    area.x1 = content.x1 + offsetX_ + col0 * cellPx_;
+    area.x2 = content.x1 + offsetX_ + (col1 + 1) * cellPx_ - 1;
+    area.y1 = content.y1 + offsetY_ + row * cellPx_;
+    area.y2 = area.y1 + cellPx_ - 1;
+    lv_obj_invalidate_area(obj_, &area);
+}
+
+void LedPreview::draw(lv_event_t* e) {
+    if (!cells_ || cellPx_ <= 0) {
+        return;
+    }
+
+    uint32_t startUs = micros();
+
+    lv_layer_t* layer = lv_event_get_layer(e);
+    lv_area_t content;
+    lv_obj_get_content_coords(obj_, &content);
+    int32_t originX = content.x1 + offsetX_;
+    int32_t originY = content.y1 + offsetY_;
+
+    // Only walk the cells inside the area being redrawn
+    const lv_area_t& clip = layer->_clip_area;
+    int colStart = (clip.x1 - originX) / cellPx_;
+    int colEnd = (clip.x2 - originX) / cellPx_;
+    int rowStart = (clip.y1 - originY) / cellPx_;
+    int rowEnd = (clip.y2 - originY) / cellPx_;
+    if (colStart < 0) colStart = 0;
+    if (rowStart < 0) rowStart = 0;
+    if (colEnd >= cols_) colEnd = cols_ - 1;
+    if (rowEnd >= rows_) rowEnd = rows_ - 1;
+
+    // Leave a 1px gap between cells when they're big enough to look like LEDs;
+    // otherwise merge equal neighbours into one rectangle
+    int32_t gap = (cellPx_ >= 4) ? 1 : 0;
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.bg_opa = LV_OPA_COVER;
+    dsc.radius = 0;
+
+    for (int row = rowStart; row <= rowEnd; row++) {
+        const uint16_t* cellRow = &cells_[row * cols_];
+        int col = colStart;
+
+        while (col <= colEnd) {
+            uint16_t colour = cellRow[col];
+            int runEnd = col;
+            if (gap == 0) {
+                while (runEnd < colEnd && cellRow[runEnd + 1] == colour) {
+                    runEnd++;
+                }
+            }
+
+            // Off LEDs are left as panel background
+            if (colour != 0) {
+                lv_area_t area;
+                area.x1 = originX + col * cellPx_;
+                area.x2 = originX + (runEnd + 1) * cellPx_ - 1 - gap;
+                area.y1 = originY + row * cellPx_;
+                area.y2 = area.y1 + cellPx_ - 1 - gap;
+                dsc.bg_color = fromRgb565(colour);
+                lv_draw_rect(layer, &dsc, &area);
+            }
+
+            col = runEnd + 1;
+        }
+    }
+
+    drawUs_ += micros() - startUs;
+}
+
+void LedPreview::rollWindow(unsigned long now) {
+    if (now - windowStart_ < 1000) {
+        return;
+    }
+
+    lastStats_.cols = cols_;
+    lastStats_.rows = rows_;
+    lastStats_.cellPx = cellPx_;
+    lastStats_.samplesPerSec = samples_;
+    lastStats_.sampleUsPerSec = sampleUs_;
+    lastStats_.drawUsPerSec = drawUs_;
+    lastStats_.changedCellsPerSec = changedCells_;
+    lastStats_.maxSampleUs = maxSampleUs_;
+
+    samples_ = 0;
+    sampleUs_ = 0;
+    drawUs_ = 0;
+    changedCells_ = 0;
+    maxSampleUs_ = 0;
+    windowStart_ = now;
+}
+
+LedPreview::Stats LedPreview::getStats() const {
+    return lastStats_;
+}
+
+void LedPreview::drawEvent(lv_event_t* e) {
+    lv_obj_t* target = static_cast<lv_obj_t*>(lv_event_get_target(e));
+    LedPreview* instance = static_cast<LedPreview*>(lv_obj_get_user_data(target));
+
+    if (instance && lv_event_get_code(e) == LV_EVENT_DRAW_MAIN) {
+        instance->draw(e);
+    }
+}
+
+void LedPreview::freeCells() {
+    if (cells_) {
+        delete[] cells_;
+        cells_ = nullptr;
+    }
+    ledCols_ = 0;
+    ledRows_ = 0;
+    cols_ = 0;
+    rows_ = 0;
+    cellPx_ = 0;
+}
+
+void LedPreview::cleanup() {
+    if (obj_) {
+        lv_obj_del(obj_);
+        obj_ = nullptr;
+    }
+
+    freeCells();
+    initialized_ = false;
+}
@@ -1,8 +1,12 @@
 #include "UIManager.h"
 #include "modular-ui.h"
 #include "ui.h"
+#include "BootProfiler.h"
+#include "Metrics.h"
+#include "UIStyles.h"
 #include <memory>
 #include <Logger.h>
+#include <Preferences.h>
 
 // Global instance definitions
 UIManager* g_uiManager = nullptr;
@@ -13,60 +17,18 @@ WhiteButton* g_whiteButton = nullptr;
 VuButton* g_vuButton = nullptr;
 VuGraph* g_vuGraph = nullptr;
 
-// Static style definitions
-lv_style_t UIManager::stylePanelMain_;
-lv_style_t UIManager::stylePanelInset_;
-lv_style_t UIManager::styleSectionLabel_;
-bool UIManager::stylesInitialized_ = false;
-
-void UIManager::initStyles() {
-    if (stylesInitialized_) return;
-
-    // Panel main style - raised hardware module look
-    lv_style_init(&stylePanelMain_);
-    lv_style_set_bg_color(&stylePanelMain_, lv_color_hex(UI_COLOR_SURFACE));
-    lv_style_set_bg_opa(&stylePanelMain_, LV_OPA_COVER);
-    lv_style_set_border_color(&stylePanelMain_, lv_color_hex(UI_COLOR_BORDER));
-    lv_style_set_border_width(&stylePanelMain_, UI_BORDER_NORMAL);
-    lv_style_set_border_opa(&stylePanelMain_, LV_OPA_COVER);
-    lv_style_set_radius(&stylePanelMain_, UI_RADIUS_MEDIUM);
-    lv_style_set_pad_all(&stylePanelMain_, UI_PADDING_MEDIUM);
-
-    // Panel inset style - darker recessed area
-    lv_style_init(&stylePanelInset_);
-    lv_style_set_bg_color(&stylePanelInset_, lv_color_hex(UI_COLOR_SURFACE_DARK));
-    lv_style_set_bg_opa(&stylePanelInset_, LV_OPA_COVER);
-    lv_style_set_border_color(&stylePanelInset_, lv_color_hex(UI_COLOR_BORDER));
-    lv_style_set_border_width(&stylePanelInset_, UI_BORDER_THIN);
-    lv_style_set_border_side(&stylePanelInset_, LV_BORDER_SIDE_FULL);
-    lv_style_set_radius(&stylePanelInset_, UI_RADIUS_SMALL);
-    lv_style_set_pad_all(&stylePanelInset_, UI_PADDING_SMALL);
-
-    // Section label style
-    lv_style_init(&styleSectionLabel_);
-    lv_style_set_text_color(&styleSectionLabel_, lv_color_hex(UI_COLOR_TEXT_MUTED));
-    lv_style_set_text_font(&styleSectionLabel_, &lv_font_montserrat_12);
-    lv_style_set_pad_bottom(&styleSectionLabel_, UI_PADDING_SMALL);
-
-    stylesInitialized_ = true;
-}
-
 lv_obj_t* UIManager::createPanel(lv_obj_t* parent) {
-    initStyles();
-
     lv_obj_t* panel = lv_obj_create(parent);
-    lv_obj_add_style(panel, &stylePanelMain_, 0);
+    lv_obj_add_style(panel, &ui_style_panel_main, 0);
     lv_obj_clear_flag(panel, LV_OBJ_FLAG_SCROLLABLE);
 
     return panel;
 }
 
 lv_obj_t* UIManager::createSectionLabel(lv_obj_t* parent, const char* text) {
-    initStyles();
-
     lv_obj_t* label = lv_label_create(parent);
     lv_label_set_text(label, text);
-    lv_obj_add_style(label, &styleSectionLabel_, 0);
+    lv_obj_add_style(label, &ui_style_section_label, 0);
 
     return label;
 }
@@ -173,11 +135,34 @@ void displayFlush(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
     lv_display_flush_ready(disp);
 }
 
+// Touch activity shared between the read callback and UIManager's display policy
+static volatile bool touchPressed = false;
+static volatile unsigned long lastTouchTime = 0;
+static volatile bool displayAsleep = false;   // Backlight dimmed or off
+static volatile bool swallowTouch = false;    // Wake touch is held back from LVGL until release
+
 // Touch read callback
 void touchpadRead(lv_indev_t* indev_driver, lv_indev_data_t* data) {
     uint16_t touchX, touchY;
     bool touched = lcd.getTouch(&touchX, &touchY);
 
+    touchPressed = touched;
+    if (touched) {
+        lastTouchTime = millis();
+        // The first touch on a dark panel only wakes it - don't press whatever is under the finger
+        if (displayAsleep) {
+            swallowTouch = true;
+        }
+    }
+
+    if (swallowTouch) {
+        if (!touched) {
+            swallowTouch = false;
+        }
+        data->state = LV_INDEV_STATE_RELEASED;
+        return;
+    }
+
     if (!touched) {
         data->state = LV_INDEV_STATE_RELEASED;
     } else {
@@ -194,9 +179,12 @@ UIManager::UIManager()
     , whiteButton_(nullptr)
     , vuButton_(nullptr)
     , vuGraph_(nullptr)
+    , ledPreview_(nullptr)
     , tabview_(nullptr)
     , tab1_(nullptr)
     , tab2_(nullptr)
+    , tab3_(nullptr)
+    , tabReleaseMs_(DEFAULT_TAB_RELEASE_MS)
     , otaScreen_(nullptr)
     , otaLabel_(nullptr)
     , otaBar_(nullptr)
@@ -205,7 +193,27 @@ UIManager::UIManager()
     , otaProgressChanged_(false)
     , initialized_(false)
     , screenInitialized_(false)
+    , display_(nullptr)
+    , indev_(nullptr)
+    , displayState_(DisplayState::IDLE)
+    , refreshPeriodMs_(LV_DEF_REFR_PERIOD)
+    , dimTimeoutMs_(DEFAULT_DIM_TIMEOUT_MS)
+    , suspendTimeoutMs_(DEFAULT_SUSPEND_TIMEOUT_MS)
+    , backlightLevel_(255)
+    , suspendedSince_(0)
+    , lastTouchPoll_(0)
+    , suspendedMs_(0)
+    , wakeCount_(0)
+    , busyWindowStart_(0)
+    , busyAccumUs_(0)
+    , busyLastUs_(0)
+    , busyBaselineUs_(0)
+    , styleToggleUs_(0)
 {
+    for (int i = 0; i < TAB_COUNT; i++) {
+        tabBuilt_[i] = false;
+        tabHiddenSince_[i] = 0;
+    }
 }
 
 UIManager::~UIManager() {
@@ -219,9 +227,12 @@ UIManager::UIManager(UIManager&& other) noexcept
     , whiteButton_(std::move(other.whiteButton_))
     , vuButton_(std::move(other.vuButton_))
     , vuGraph_(std::move(other.vuGraph_))
+    , ledPreview_(std::move(other.ledPreview_))
     , tabview_(other.tabview_)
     , tab1_(other.tab1_)
     , tab2_(other.tab2_)
+    , tab3_(other.tab3_)
+    , tabReleaseMs_(other.tabReleaseMs_)
     , otaScreen_(other.otaScreen_)
     , otaLabel_(other.otaLabel_)
     , otaBar_(other.otaBar_)
@@ -230,11 +241,34 @@ UIManager::UIManager(UIManager&& other) noexcept
     , otaProgressChanged_(other.otaProgressChanged_)
     , initialized_(other.initialized_)
     , screenInitialized_(other.screenInitialized_)
+    , display_(other.display_)
+    , indev_(other.indev_)
+    , displayState_(other.displayState_)
+    , refreshPeriodMs_(other.refreshPeriodMs_)
+    , dimTimeoutMs_(other.dimTimeoutMs_)
+    , suspendTimeoutMs_(other.suspendTimeoutMs_)
+    , backlightLevel_(other.backlightLevel_)
+    , suspendedSince_(other.suspendedSince_)
+    , lastTouchPoll_(other.lastTouchPoll_)
+    , suspendedMs_(other.suspendedMs_)
+    , wakeCount_(other.wakeCount_)
+    , busyWindowStart_(other.busyWindowStart_)
+    , busyAccumUs_(other.busyAccumUs_)
+    , busyLastUs_(other.busyLastUs_)
+    , busyBaselineUs_(other.busyBaselineUs_)
+    , styleToggleUs_(other.styleToggleUs_)
 {
+    for (int i = 0; i < TAB_COUNT; i++) {
+        tabBuilt_[i] = other.tabBuilt_[i];
+        tabHiddenSince_[i] = other.tabHiddenSince_[i];
+        other.tabBuilt_[i] = false;
+    }
+
     // Reset the moved-from object
     other.tabview_ = nullptr;
     other.tab1_ = nullptr;
     other.tab2_ = nullptr;
+    other.tab3_ = nullptr;
     other.otaScreen_ = nullptr;
     other.otaLabel_ = nullptr;
     other.otaBar_ = nullptr;
@@ -243,6 +277,8 @@ UIManager::UIManager(UIManager&& other) noexcept
     other.otaProgressChanged_ = false;
     other.initialized_ = false;
     other.screenInitialized_ = false;
+    other.display_ = nullptr;
+    other.indev_ = nullptr;
 }
 
 UIManager& UIManager::operator=(UIManager&& other) noexcept {
@@ -257,9 +293,17 @@ UIManager& UIManager::operator=(UIManager&& other) noexcept {
         whiteButton_ = std::move(other.whiteButton_);
         vuButton_ = std::move(other.vuButton_);
         vuGraph_ = std::move(other.vuGraph_);
+        ledPreview_ = std::move(other.ledPreview_);
         tabview_ = other.tabview_;
         tab1_ = other.tab1_;
         tab2_ = other.tab2_;
+        tab3_ = other.tab3_;
+        tabReleaseMs_ = other.tabReleaseMs_;
+        for (int i = 0; i < TAB_COUNT; i++) {
+            tabBuilt_[i] = other.tabBuilt_[i];
+            tabHiddenSince_[i] = other.tabHiddenSince_[i];
+            other.tabBuilt_[i] = false;
+        }
         otaScreen_ = other.otaScreen_;
         otaLabel_ = other.otaLabel_;
         otaBar_ = other.otaBar_;
@@ -268,11 +312,28 @@ UIManager& UIManager::operator=(UIManager&& other) noexcept {
         otaProgressChanged_ = other.otaProgressChanged_;
         initialized_ = other.initialized_;
         screenInitialized_ = other.screenInitialized_;
+        display_ = other.display_;
+        indev_ = other.indev_;
+        displayState_ = other.displayState_;
+        refreshPeriodMs_ = other.refreshPeriodMs_;
+        dimTimeoutMs_ = other.dimTimeoutMs_;
+        suspendTimeoutMs_ = other.suspendTimeoutMs_;
+        backlightLevel_ = other.backlightLevel_;
+        suspendedSince_ = other.suspendedSince_;
+        lastTouchPoll_ = other.lastTouchPoll_;
+        suspendedMs_ = other.suspendedMs_;
+        wakeCount_ = other.wakeCount_;
+        busyWindowStart_ = other.busyWindowStart_;
+        busyAccumUs_ = other.busyAccumUs_;
+        busyLastUs_ = other.busyLastUs_;
+        busyBaselineUs_ = other.busyBaselineUs_;
+        styleToggleUs_ = other.styleToggleUs_;
 
         // Reset the moved-from object
         other.tabview_ = nullptr;
         other.tab1_ = nullptr;
         other.tab2_ = nullptr;
+        other.tab3_ = nullptr;
         other.otaScreen_ = nullptr;
         other.otaLabel_ = nullptr;
         other.otaBar_ = nullptr;
@@ -281,6 +342,8 @@ UIManager& UIManager::operator=(UIManager&& other) noexcept {
         other.otaProgressChanged_ = false;
         other.initialized_ = false;
         other.screenInitialized_ = false;
+        other.display_ = nullptr;
+        other.indev_ = nullptr;
     }
     return *this;
 }
@@ -296,6 +359,7 @@ bool UIManager::initializeScreen() {
         lv_init();
         
         lcd.setRotation(2);
+        backlightLevel_ = lcd.getBrightness();
         
         setupDisplayDriver();
         setupTouchDriver();
@@ -331,6 +395,10 @@ bool UIManager::initializeUI() {
             cleanup();
             return false;
         }
+
+        loadDisplayConfig();
+        lastTouchTime = millis();
+        busyWindowStart_ = millis();
         
         initialized_ = true;
         return true;
@@ -346,6 +414,10 @@ void UIManager::update() {
         return;
     }
 
+    METRICS_SCOPE(UI_UPDATE);
+    unsigned long now = millis();
+    uint32_t startUs = micros();
+
     // Handle OTA screen updates (must be in main loop for LVGL thread safety)
     if (otaProgressChanged_) {
         otaProgressChanged_ = false;
@@ -401,13 +473,280 @@ void UIManager::update() {
         }
     }
 
-    // Update VU graph if it exists
+    updateDisplayPolicy(now);
+    bool rendering = (displayState_ != DisplayState::SUSPENDED);
+
+    if (rendering) {
+        updateLazyTabs(now);
+    }
+
+    // Update VU graph if it exists - audio is always sampled for the LED effects,
+    // but the bars are only redrawn while the VU tab is actually on screen
     if (vuGraph_) {
-        vuGraph_->update();
+        bool vuVisible = rendering && tabview_ && lv_tabview_get_tab_active(tabview_) == TAB_VU;
+        vuGraph_->update(vuVisible);
+    }
+
+    // Sample the LED frame into the preview only while it's on screen
+    if (ledPreview_ && rendering && lv_tabview_get_tab_active(tabview_) == TAB_LEDS) {
+        ledPreview_->update();
+    }
+
+    // Process LVGL tasks (skipped entirely while suspended)
+    if (rendering) {
+        METRICS_SCOPE(UI_RENDER);
+        lv_timer_handler();
+    }
+
+    accountBusyTime(now, micros() - startUs);
+}
+
+void UIManager::loadDisplayConfig() {
+    Preferences prefs;
+    prefs.begin("ui-config", true); // Read-only
+    dimTimeoutMs_ = prefs.getUInt("dim_ms", DEFAULT_DIM_TIMEOUT_MS);
+    suspendTimeoutMs_ = prefs.getUInt("suspend_ms", DEFAULT_SUSPEND_TIMEOUT_MS);
+    tabReleaseMs_ = prefs.getUInt("tab_free_ms", DEFAULT_TAB_RELEASE_MS);
+    prefs.end();
+
+    Logger.info("Display idle policy: dim after %lu ms, suspend after %lu ms (0 = never)",
+                (unsigned long)dimTimeoutMs_, (unsigned long)suspendTimeoutMs_);
+    if (tabReleaseMs_ > 0) {
+        Logger.info("Hidden tabs released after %lu ms", (unsigned long)tabReleaseMs_);
+    }
+}
+
+void UIManager::updateLazyTabs(unsigned long now) {
+    if (!tabview_) {
+        return;
+    }
+
+    uint32_t active = lv_tabview_get_tab_active(tabview_);
+
+    for (int i = 0; i < TAB_COUNT; i++) {
+        if ((uint32_t)i == active) {
+            tabHiddenSince_[i] = 0;
+            if (!tabBuilt_[i]) {
+                uint32_t startUs = micros();
+                uint32_t lvglBefore = BootProfiler::getLvglHeapUsed();
+                if (buildTab(i)) {
+                    // Newly created widgets start at defaults - pull in the current LED state
+                    syncWithLEDState();
+                    Logger.info("Tab %d built on first view in %lu us (+%ld bytes LVGL heap)",
+                                i, (unsigned long)(micros() - startUs),
+                                (long)BootProfiler::getLvglHeapUsed() - (long)lvglBefore);
+                }
+            }
+            continue;
+        }
+
+        // The colour tab is the home screen and is never released
+        if (i == TAB_COLOUR || !tabBuilt_[i] || tabReleaseMs_ == 0) {
+            continue;
+        }
+
+        if (tabHiddenSince_[i] == 0) {
+            tabHiddenSince_[i] = now;
+        } else if (now - tabHiddenSince_[i] >= tabReleaseMs_) {
+            uint32_t lvglBefore = BootProfiler::getLvglHeapUsed();
+            releaseTab(i);
+            Logger.info("Tab %d released after %lu ms hidden (-%ld bytes LVGL heap)",
+                        i, (unsigned long)(now - tabHiddenSince_[i]),
+                        (long)lvglBefore - (long)BootProfiler::getLvglHeapUsed());
+            tabHiddenSince_[i] = 0;
+        }
+    }
+}
+
+bool UIManager::buildTab(int tab) {
+    if (tab < 0 || tab >= TAB_COUNT) {
+        return false;
+    }
+    if (tabBuilt_[tab]) {
+        return true;
+    }
+
+    bool ok = false;
+    switch (tab) {
+        case TAB_COLOUR: ok = buildColourTab(); break;
+        case TAB_VU: ok = buildVuTab(); break;
+        case TAB_LEDS: ok = buildLedsTab(); break;
+        default: break;
+    }
+
+    if (!ok) {
+        Logger.error("Failed to build tab %d", tab);
+        return false;
+    }
+
+    tabBuilt_[tab] = true;
+    return true;
+}
+
+void UIManager::releaseTab(int tab) {
+    if (tab == TAB_COLOUR || tab < 0 || tab >= TAB_COUNT || !tabBuilt_[tab]) {
+        return;
+    }
+
+    if (tab == TAB_VU && vuGraph_) {
+        // Audio sampling keeps running for the LED VU effect - only the widgets go
+        vuGraph_->destroyWidgets();
+    } else if (tab == TAB_LEDS) {
+        ledPreview_.reset();
+    }
+
+    tabBuilt_[tab] = false;
+}
+
+void UIManager::setIdleTimeouts(uint32_t dimMs, uint32_t suspendMs) {
+    dimTimeoutMs_ = dimMs;
+    suspendTimeoutMs_ = suspendMs;
+
+    Preferences prefs;
+    prefs.begin("ui-config", false);
+    prefs.putUInt("dim_ms", dimMs);
+    prefs.putUInt("suspend_ms", suspendMs);
+    prefs.end();
+
+    // Restart the idle clock so the new timeouts apply from now
+    wakeDisplay();
+}
+
+void UIManager::wakeDisplay() {
+    // Only touches the idle clock - safe from web/OTA callbacks, the
+    // actual backlight/refresh change happens in update()
+    lastTouchTime = millis();
+}
+
+void UIManager::updateDisplayPolicy(unsigned long now) {
+    if (displayState_ == DisplayState::SUSPENDED && now - lastTouchPoll_ >= SUSPENDED_TOUCH_POLL_MS) {
+        // LVGL isn't reading the touch controller while suspended, so poll it here
+        lastTouchPoll_ = now;
+        uint16_t touchX, touchY;
+        if (lcd.getTouch(&touchX, &touchY)) {
+            lastTouchTime = now;
+            swallowTouch = true;
+        }
+    }
+
+    unsigned long lastTouch = lastTouchTime;
+    unsigned long idleMs = ((long)(now - lastTouch) > 0) ? now - lastTouch : 0;
+
+    DisplayState target;
+    if (touchPressed && !swallowTouch) {
+        target = DisplayState::ACTIVE;
+    } else if (otaScreenActive_) {
+        target = DisplayState::IDLE;  // Keep OTA progress visible
+    } else if (suspendTimeoutMs_ > 0 && idleMs >= suspendTimeoutMs_) {
+        target = DisplayState::SUSPENDED;
+    } else if (dimTimeoutMs_ > 0 && idleMs >= dimTimeoutMs_) {
+        target = DisplayState::DIMMED;
+    } else {
+        target = DisplayState::IDLE;
+    }
+
+    if (target != displayState_) {
+        DisplayState previous = displayState_;
+        displayState_ = target;
+
+        if (target == DisplayState::SUSPENDED) {
+            lcd.setBrightness(0);
+            displayAsleep = true;
+            suspendedSince_ = now;
+            lastTouchPoll_ = now;
+            Logger.info("Display suspended after %lu s idle", idleMs / 1000);
+        } else if (target == DisplayState::DIMMED) {
+            lcd.setBrightness(DIM_BACKLIGHT_LEVEL);
+            displayAsleep = true;
+        } else if (previous == DisplayState::DIMMED || previous == DisplayState::SUSPENDED) {
+            if (previous == DisplayState::SUSPENDED) {
+                suspendedMs_ += now - suspendedSince_;
+                // Widgets may have changed while nothing was being drawn
+                lv_obj_invalidate(lv_screen_active());
+            }
+            lcd.setBrightness(backlightLevel_);
+            displayAsleep = false;
+            wakeCount_++;
+        }
+    }
+
+    if (displayState_ == DisplayState::ACTIVE) {
+        setRefreshPeriod(REFRESH_ACTIVE_MS);
+    } else if (displayState_ == DisplayState::IDLE && idleMs < IDLE_THROTTLE_MS) {
+        setRefreshPeriod(REFRESH_NORMAL_MS);
+    } else {
+        setRefreshPeriod(REFRESH_IDLE_MS);
+    }
+}
+
+void UIManager::setRefreshPeriod(uint32_t periodMs) {
+    if (periodMs == refreshPeriodMs_) {
+        return;
+    }
+    refreshPeriodMs_ = periodMs;
+
+    if (display_) {
+        lv_timer_t* refrTimer = lv_display_get_refr_timer(display_);
+        if (refrTimer) {
+            lv_timer_set_period(refrTimer, periodMs);
+        }
+    }
+
+    // Touch polling never drops below the default rate so the first touch is picked up promptly
+    if (indev_) {
+        lv_timer_t* readTimer = lv_indev_get_read_timer(indev_);
+        if (readTimer) {
+            uint32_t readPeriodMs = periodMs;
+            if (readPeriodMs > REFRESH_NORMAL_MS) {
+                readPeriodMs = REFRESH_NORMAL_MS;
+            }
+            lv_timer_set_period(readTimer, readPeriodMs);
+        }
+    }
+}
+
+void UIManager::accountBusyTime(unsigned long now, uint32_t busyUs) {
+    busyAccumUs_ += busyUs;
+    if (now - busyWindowStart_ < 1000) {
+        return;
+    }
+
+    busyLastUs_ = busyAccumUs_;
+    // Baseline tracks what update() costs when rendering at the normal rate or faster
+    if (displayState_ != DisplayState::SUSPENDED && refreshPeriodMs_ <= REFRESH_NORMAL_MS) {
+        busyBaselineUs_ = (busyBaselineUs_ == 0) ? busyLastUs_ : (busyBaselineUs_ * 7 + busyLastUs_) / 8;
     }
 
-    // Process LVGL tasks
-    lv_timer_handler();
+    busyAccumUs_ = 0;
+    busyWindowStart_ = now;
+}
+
+UIManager::DisplayStats UIManager::getDisplayStats() const {
+    DisplayStats stats;
+    stats.state = displayState_;
+    stats.refreshPeriodMs = refreshPeriodMs_;
+    stats.uiBusyUs = busyLastUs_;
+    stats.baselineBusyUs = busyBaselineUs_;
+    stats.freedUs = (busyBaselineUs_ > busyLastUs_) ? busyBaselineUs_ - busyLastUs_ : 0;
+    stats.suspendedMs = suspendedMs_;
+    if (displayState_ == DisplayState::SUSPENDED) {
+        stats.suspendedMs += millis() - suspendedSince_;
+    }
+    stats.wakeCount = wakeCount_;
+    stats.dimTimeoutMs = dimTimeoutMs_;
+    stats.suspendTimeoutMs = suspendTimeoutMs_;
+    stats.styleToggleUs = styleToggleUs_;
+    return stats;
+}
+
+const char* UIManager::getDisplayStateName(DisplayState state) {
+    switch (state) {
+        case DisplayState::ACTIVE: return "active";
+        case DisplayState::IDLE: return "idle";
+        case DisplayState::DIMMED: return "dimmed";
+        case DisplayState::SUSPENDED: return "suspended";
+        default: return "unknown";
+    }
 }
 
 void UIManager::applyCurrentColor() {
@@ -613,58 +952,56 @@ bool UIManager::createTabview() {
     lv_obj_add_event_cb(tabContent, scrollBeginEvent, LV_EVENT_SCROLL_BEGIN, NULL);
 
     // Style the tabview with synth theme - hardware module look
-    lv_obj_set_style_bg_color(tabview_, lv_color_hex(UI_COLOR_SURFACE), 0);
-    lv_obj_set_style_bg_opa(tabview_, LV_OPA_COVER, 0);
-    lv_obj_set_style_border_width(tabview_, UI_BORDER_NORMAL, 0);
-    lv_obj_set_style_border_color(tabview_, lv_color_hex(UI_COLOR_BORDER), 0);
-    lv_obj_set_style_border_opa(tabview_, LV_OPA_COVER, 0);
-    lv_obj_set_style_radius(tabview_, UI_RADIUS_MEDIUM, 0);
+    lv_obj_add_style(tabview_, &ui_style_tabview, 0);
     lv_obj_add_flag(tabview_, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
 
     // Create tabs (Effects moved to dropdown on Colour tab)
     tab1_ = lv_tabview_add_tab(tabview_, "Colour");
     tab2_ = lv_tabview_add_tab(tabview_, "VU");
+    tab3_ = lv_tabview_add_tab(tabview_, "LEDs");
 
-    if (!tab1_ || !tab2_) {
+    if (!tab1_ || !tab2_ || !tab3_) {
         return false;
     }
 
     // Style individual tabs
-    lv_obj_set_style_bg_color(tab1_, lv_color_hex(UI_COLOR_SURFACE), 0);
-    lv_obj_set_style_bg_color(tab2_, lv_color_hex(UI_COLOR_SURFACE), 0);
-    
+    lv_obj_add_style(tab1_, &ui_style_tab_page, 0);
+    lv_obj_add_style(tab2_, &ui_style_tab_page, 0);
+    lv_obj_add_style(tab3_, &ui_style_tab_page, 0);
+
     // === TAB BAR - Hardware selector style ===
     lv_obj_t* tab_bar = lv_tabview_get_tab_bar(tabview_);
-    lv_obj_set_style_bg_color(tab_bar, lv_color_hex(UI_COLOR_SURFACE), 0);
-    lv_obj_set_style_border_color(tab_bar, lv_color_hex(UI_COLOR_BORDER), 0);
-    lv_obj_set_style_border_width(tab_bar, UI_BORDER_NORMAL, 0);
-    lv_obj_set_style_border_side(tab_bar, LV_BORDER_SIDE_BOTTOM, 0);
-    lv_obj_set_style_pad_all(tab_bar, UI_PADDING_SMALL, 0);
+    lv_obj_add_style(tab_bar, &ui_style_tab_bar, 0);
 
-    // Style each tab button
+    // Style each tab button - the active tab is LV_STATE_CHECKED
     uint32_t child_count = lv_obj_get_child_count(tab_bar);
     for (uint32_t i = 0; i < child_count; i++) {
         lv_obj_t* btn = lv_obj_get_child(tab_bar, i);
-
-        // === INACTIVE STATE - Light text on dark background ===
-        lv_obj_set_style_bg_color(btn, lv_color_hex(UI_COLOR_SURFACE), 0);
-        lv_obj_set_style_text_color(btn, lv_color_hex(UI_COLOR_TEXT), 0);  // Bright white text
-        lv_obj_set_style_border_color(btn, lv_color_hex(UI_COLOR_BORDER), 0);
-        lv_obj_set_style_border_width(btn, UI_BORDER_THIN, 0);
-        lv_obj_set_style_radius(btn, UI_RADIUS_SMALL, 0);
-
-        // === ACTIVE/CHECKED STATE - Cyan background, white text ===
-        lv_obj_set_style_bg_color(btn, lv_color_hex(UI_COLOR_PRIMARY), LV_STATE_CHECKED);
-        lv_obj_set_style_text_color(btn, lv_color_hex(UI_COLOR_WHITE), LV_STATE_CHECKED);
-        lv_obj_set_style_border_color(btn, lv_color_hex(UI_COLOR_PRIMARY), LV_STATE_CHECKED);
+        lv_obj_add_style(btn, &ui_style_tab_button, 0);
+        lv_obj_add_style(btn, &ui_style_tab_button_checked, LV_STATE_CHECKED);
     }
     
     return true;
 }
 
 bool UIManager::initializeComponents() {
-    initStyles();
+    // The colour tab is the home screen and is shown straight away
+    if (!buildTab(TAB_COLOUR)) {
+        return false;
+    }
+    measureStyleToggle();
+
+    // Audio sampling starts now (the LED VU effect needs it), the bar widgets
+    // are only created the first time the VU tab is opened
+    vuGraph_.reset(new VuGraph());
+    if (vuGraph_ && !vuGraph_->initializeAudio()) {
+        return false;
+    }
 
+    return true;
+}
+
+bool UIManager::buildColourTab() {
     // ==========================================================================
     // TAB 1: COLOUR - Fader style layout
     // Layout: Left column (fader + VU) | Center (wheel) | Bottom (White + Effects)
@@ -681,9 +1018,7 @@ bool UIManager::initializeComponents() {
     lv_obj_set_flex_grow(mainRow, 1);
     lv_obj_set_flex_flow(mainRow, LV_FLEX_FLOW_ROW);
     lv_obj_set_flex_align(mainRow, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_bg_opa(mainRow, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_width(mainRow, 0, 0);
-    lv_obj_set_style_pad_all(mainRow, 0, 0);
+    lv_obj_add_style(mainRow, &ui_style_container_clear, 0);
     lv_obj_set_style_pad_left(mainRow, UI_PADDING_LARGE, 0);  // Push fader right a bit
     lv_obj_set_style_pad_column(mainRow, UI_SPACING_LOOSE, 0);
     lv_obj_clear_flag(mainRow, LV_OBJ_FLAG_SCROLLABLE);
@@ -694,9 +1029,7 @@ bool UIManager::initializeComponents() {
     lv_obj_set_size(leftColumn, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     lv_obj_set_flex_flow(leftColumn, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(leftColumn, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_bg_opa(leftColumn, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_width(leftColumn, 0, 0);
-    lv_obj_set_style_pad_all(leftColumn, 0, 0);
+    lv_obj_add_style(leftColumn, &ui_style_container_clear, 0);
     lv_obj_set_style_pad_row(leftColumn, UI_SPACING_NORMAL, 0);
     lv_obj_clear_flag(leftColumn, LV_OBJ_FLAG_SCROLLABLE);
 
@@ -747,8 +1080,7 @@ bool UIManager::initializeComponents() {
     lv_obj_set_height(wheelContainer, LV_SIZE_CONTENT);
     lv_obj_set_flex_flow(wheelContainer, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(wheelContainer, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_bg_opa(wheelContainer, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_width(wheelContainer, 0, 0);
+    lv_obj_add_style(wheelContainer, &ui_style_container_clear, 0);
     lv_obj_set_style_pad_all(wheelContainer, 20, 0);  // Room for indicator
     lv_obj_clear_flag(wheelContainer, LV_OBJ_FLAG_SCROLLABLE);
 
@@ -767,9 +1099,7 @@ bool UIManager::initializeComponents() {
     lv_obj_set_size(bottomRow, LV_PCT(100), LV_SIZE_CONTENT);
     lv_obj_set_flex_flow(bottomRow, LV_FLEX_FLOW_ROW);
     lv_obj_set_flex_align(bottomRow, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_bg_opa(bottomRow, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_width(bottomRow, 0, 0);
-    lv_obj_set_style_pad_all(bottomRow, 0, 0);
+    lv_obj_add_style(bottomRow, &ui_style_container_clear, 0);
     lv_obj_set_style_pad_column(bottomRow, UI_SPACING_NORMAL, 0);
     lv_obj_clear_flag(bottomRow, LV_OBJ_FLAG_SCROLLABLE);
 
@@ -802,15 +1132,53 @@ bool UIManager::initializeComponents() {
         });
     }
 
+    return true;
+}
+
+bool UIManager::buildVuTab() {
     // ==========================================================================
     // TAB 2: VU GRAPH
     // ==========================================================================
-    vuGraph_.reset(new VuGraph());
-    if (vuGraph_ && !vuGraph_->initialize(tab2_)) {
+    if (!vuGraph_) {
         return false;
     }
 
-    return true;
+    return vuGraph_->createWidgets(tab2_);
+}
+
+bool UIManager::buildLedsTab() {
+    // ==========================================================================
+    // TAB 3: LED PREVIEW
+    // ==========================================================================
+    ledPreview_.reset(new LedPreview());
+    if (ledPreview_ && !ledPreview_->initialize(tab3_, LV_PCT(100), LV_PCT(100))) {
+        ledPreview_.reset();
+        return false;
+    }
+
+    return ledPreview_ != nullptr;
+}
+
+void UIManager::measureStyleToggle() {
+    if (!effectsList_ || !effectsList_->getLvglObject()) {
+        return;
+    }
+
+    // Active/inactive looks are shared const styles selected by state, so a
+    // toggle is only a style re-resolve - no allocation, no property copies
+    lv_obj_t* obj = effectsList_->getLvglObject();
+    const int iterations = 8;
+    uint32_t lvglBefore = BootProfiler::getLvglHeapUsed();
+    uint32_t startUs = micros();
+    for (int i = 0; i < iterations; i++) {
+        lv_obj_add_state(obj, UI_STATE_ACTIVE);
+        lv_obj_remove_state(obj, UI_STATE_ACTIVE);
+    }
+    styleToggleUs_ = (micros() - startUs) / (iterations * 2);
+
+    Logger.info("Style state toggle: %lu us, LVGL heap delta %ld bytes",
+                (unsigned long)styleToggleUs_,
+                (long)BootProfiler::getLvglHeapUsed() - (long)lvglBefore);
 }
 
 void UIManager::setupDisplayDriver() {
@@ -822,6 +1190,8 @@ void UIManager::setupDisplayDriver() {
 
     // Set flush callback
     lv_display_set_flush_cb(disp, displayFlush);
+
+    display_ = disp;
 }
 
 void UIManager::setupTouchDriver() {
@@ -829,6 +1199,8 @@ void UIManager::setupTouchDriver() {
     lv_indev_t* indev = lv_indev_create();
     lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
     lv_indev_set_read_cb(indev, touchpadRead);
+
+    indev_ = indev;
 }
 
 void UIManager::cleanup() {
@@ -839,6 +1211,7 @@ void UIManager::cleanup() {
     whiteButton_.reset();
     vuButton_.reset();
     vuGraph_.reset();
+    ledPreview_.reset();
 
     // Clean up LVGL objects
     if (tabview_) {
@@ -856,6 +1229,11 @@ void UIManager::cleanup() {
 
     tab1_ = nullptr;
     tab2_ = nullptr;
+    tab3_ = nullptr;
+    for (int i = 0; i < TAB_COUNT; i++) {
+        tabBuilt_[i] = false;
+        tabHiddenSince_[i] = 0;
+    }
     initialized_ = false;
 }
 
@@ -0,0 +1,319 @@
+/**
+ * @file UIStyles.c
+ *
+ * Constant LVGL style tables for the synth theme (see UIStyles.h).
+ *
+ * Written in C so the LV_STYLE_CONST_* designated initializers compile as-is;
+ * every table is const and is placed in flash by the linker.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "UIStyles.h"
+#include "UITheme.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Compile-time lv_color_t from a 0xRRGGBB theme constant */
+#define UI_HEX(c) LV_COLOR_MAKE((((c) >> 16) & 0xFF), (((c) >> 8) & 0xFF), ((c) & 0xFF))
+
+#define UI_CONST_PAD_ALL(p) \
+    LV_STYLE_CONST_PAD_TOP(p), LV_STYLE_CONST_PAD_BOTTOM(p), \
+    LV_STYLE_CONST_PAD_LEFT(p), LV_STYLE_CONST_PAD_RIGHT(p)
+
+/**********************
+ *     CONTAINERS
+ **********************/
+/* Raised hardware module look */
+static const lv_style_const_prop_t panel_main_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_BORDER)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_NORMAL),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_RADIUS(UI_RADIUS_MEDIUM),
+    UI_CONST_PAD_ALL(UI_PADDING_MEDIUM),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_panel_main, panel_main_props);
+
+/* Darker recessed area */
+static const lv_style_const_prop_t panel_inset_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE_DARK)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_BORDER)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_THIN),
+    LV_STYLE_CONST_BORDER_SIDE(LV_BORDER_SIDE_FULL),
+    LV_STYLE_CONST_RADIUS(UI_RADIUS_SMALL),
+    UI_CONST_PAD_ALL(UI_PADDING_SMALL),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_panel_inset, panel_inset_props);
+
+static const lv_style_const_prop_t section_label_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_TEXT_MUTED)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_montserrat_12),
+    LV_STYLE_CONST_PAD_BOTTOM(UI_PADDING_SMALL),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_section_label, section_label_props);
+
+/* Layout-only rows/columns */
+static const lv_style_const_prop_t container_clear_props[] = {
+    LV_STYLE_CONST_BG_OPA(LV_OPA_TRANSP),
+    LV_STYLE_CONST_BORDER_WIDTH(0),
+    UI_CONST_PAD_ALL(0),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_container_clear, container_clear_props);
+
+/**********************
+ *      TABVIEW
+ **********************/
+static const lv_style_const_prop_t tabview_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_NORMAL),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_BORDER)),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_RADIUS(UI_RADIUS_MEDIUM),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_tabview, tabview_props);
+
+static const lv_style_const_prop_t tab_page_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_tab_page, tab_page_props);
+
+/* Hardware selector style */
+static const lv_style_const_prop_t tab_bar_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE)),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_BORDER)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_NORMAL),
+    LV_STYLE_CONST_BORDER_SIDE(LV_BORDER_SIDE_BOTTOM),
+    UI_CONST_PAD_ALL(UI_PADDING_SMALL),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_tab_bar, tab_bar_props);
+
+/* Inactive - light text on dark background */
+static const lv_style_const_prop_t tab_button_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE)),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_TEXT)),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_BORDER)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_THIN),
+    LV_STYLE_CONST_RADIUS(UI_RADIUS_SMALL),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_tab_button, tab_button_props);
+
+/* Active - cyan background, white text */
+static const lv_style_const_prop_t tab_button_checked_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_WHITE)),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_tab_button_checked, tab_button_checked_props);
+
+/**********************
+ *      BUTTONS
+ **********************/
+/* Dark hardware button look */
+static const lv_style_const_prop_t button_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE_LIGHT)),
+    LV_STYLE_CONST_BG_GRAD_COLOR(UI_HEX(UI_COLOR_SURFACE_DARK)),
+    LV_STYLE_CONST_BG_GRAD_DIR(LV_GRAD_DIR_VER),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_BORDER)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_NORMAL),
+    LV_STYLE_CONST_RADIUS(UI_RADIUS_MEDIUM),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_TEXT_MUTED)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_button, button_props);
+
+/* On - bright cyan with white border */
+static const lv_style_const_prop_t button_checked_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_BG_GRAD_COLOR(UI_HEX(UI_COLOR_PRIMARY_DARK)),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_WHITE)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_THICK),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_BLACK)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_button_checked, button_checked_props);
+
+static const lv_style_const_prop_t button_pressed_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_PRIMARY_DIM)),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_WHITE)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_button_pressed, button_pressed_props);
+
+/* White mode on - bright white with cyan border */
+static const lv_style_const_prop_t button_white_checked_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_WHITE)),
+    LV_STYLE_CONST_BG_GRAD_COLOR(UI_HEX(UI_COLOR_TEXT)),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_THICK),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_BLACK)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_button_white_checked, button_white_checked_props);
+
+static const lv_style_const_prop_t button_white_pressed_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_TEXT)),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_WHITE)),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_BLACK)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_button_white_pressed, button_white_pressed_props);
+
+/**********************
+ *  EFFECTS DROPDOWN
+ **********************/
+/* Added on top of ui_style_button */
+static const lv_style_const_prop_t dropdown_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_TEXT)),
+    UI_CONST_PAD_ALL(UI_PADDING_SMALL),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_dropdown, dropdown_props);
+
+static const lv_style_const_prop_t dropdown_pressed_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE)),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_dropdown_pressed, dropdown_pressed_props);
+
+static const lv_style_const_prop_t dropdown_list_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE)),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_NORMAL),
+    LV_STYLE_CONST_RADIUS(UI_RADIUS_MEDIUM),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_TEXT)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_dropdown_list, dropdown_list_props);
+
+static const lv_style_const_prop_t dropdown_list_selected_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_BLACK)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_dropdown_list_selected, dropdown_list_selected_props);
+
+/**********************
+ *  BRIGHTNESS FADER
+ **********************/
+/* Recessed track */
+static const lv_style_const_prop_t slider_track_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_SURFACE_DARK)),
+    LV_STYLE_CONST_BG_GRAD_COLOR(UI_HEX(UI_COLOR_TRACK)),
+    LV_STYLE_CONST_BG_GRAD_DIR(LV_GRAD_DIR_HOR),
+    LV_STYLE_CONST_RADIUS(UI_RADIUS_SMALL),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_BORDER)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_THIN),
+    LV_STYLE_CONST_BORDER_SIDE(LV_BORDER_SIDE_FULL),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_slider_track, slider_track_props);
+
+/* Cyan gradient fill */
+static const lv_style_const_prop_t slider_indicator_props[] = {
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_BG_GRAD_COLOR(UI_HEX(UI_COLOR_PRIMARY_DARK)),
+    LV_STYLE_CONST_BG_GRAD_DIR(LV_GRAD_DIR_VER),
+    LV_STYLE_CONST_RADIUS(UI_RADIUS_SMALL),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_slider_indicator, slider_indicator_props);
+
+/* Fader cap */
+static const lv_style_const_prop_t slider_knob_props[] = {
+    LV_STYLE_CONST_BG_COLOR(UI_HEX(UI_COLOR_WHITE)),
+    LV_STYLE_CONST_BG_GRAD_COLOR(UI_HEX(UI_COLOR_TEXT)),
+    LV_STYLE_CONST_BG_GRAD_DIR(LV_GRAD_DIR_VER),
+    LV_STYLE_CONST_RADIUS(UI_RADIUS_SMALL),
+    LV_STYLE_CONST_WIDTH(44),
+    LV_STYLE_CONST_HEIGHT(16),
+    LV_STYLE_CONST_BORDER_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_BORDER_WIDTH(UI_BORDER_NORMAL),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_slider_knob, slider_knob_props);
+
+/**********************
+ *      VU GRAPH
+ **********************/
+static const lv_style_const_prop_t vu_segment_props[] = {
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_0),
+    LV_STYLE_CONST_RADIUS(2),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_vu_segment, vu_segment_props);
+
+/* Zone colours: unlit is applied at the default state, lit at LV_STATE_CHECKED
+ * (segments) or the zone's UI_STATE_PEAK_* state (peak indicator) */
+static const lv_style_const_prop_t vu_green_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0x22, 0x00)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_vu_segment_green, vu_green_props);
+
+static const lv_style_const_prop_t vu_green_lit_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0xFF, 0x00)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_vu_segment_green_lit, vu_green_lit_props);
+
+static const lv_style_const_prop_t vu_yellow_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x22, 0x22, 0x00)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_vu_segment_yellow, vu_yellow_props);
+
+static const lv_style_const_prop_t vu_yellow_lit_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0xFF, 0xFF, 0x00)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_vu_segment_yellow_lit, vu_yellow_lit_props);
+
+static const lv_style_const_prop_t vu_red_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x22, 0x00, 0x00)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_vu_segment_red, vu_red_props);
+
+static const lv_style_const_prop_t vu_red_lit_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0xFF, 0x00, 0x00)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_vu_segment_red_lit, vu_red_lit_props);
+
+/* Peak indicator - hidden until a zone state is set */
+static const lv_style_const_prop_t vu_peak_props[] = {
+    LV_STYLE_CONST_BG_OPA(LV_OPA_0),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_0),
+    LV_STYLE_CONST_RADIUS(2),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_vu_peak, vu_peak_props);
+
+static const lv_style_const_prop_t vu_label_props[] = {
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_montserrat_14),
+    LV_STYLE_CONST_TEXT_COLOR(UI_HEX(UI_COLOR_PRIMARY)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(ui_style_vu_label, vu_label_props);
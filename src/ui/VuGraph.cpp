@@ -1,6 +1,8 @@
 #include "VuGraph.h"
 #include "modular-ui.h"
 #include "ui.h"
+#include "UIStyles.h"
+#include "AudioSnapshot.h"
 
 VuGraph::VuGraph()
     : canvas_(nullptr)
@@ -100,10 +102,34 @@ VuGraph& VuGraph::operator=(VuGraph&& other) noexcept {
 }
 
 bool VuGraph::initialize(lv_obj_t* parent) {
+    if (!parent) {
+        return false; // Invalid parent
+    }
+
+    if (!initializeAudio()) {
+        return false;
+    }
+
+    return createWidgets(parent);
+}
+
+bool VuGraph::initializeAudio() {
     if (initialized_) {
         return true; // Already initialized
     }
 
+    // Initialize audio analyzer
+    audio_.Init();
+
+    initialized_ = true;
+    return true;
+}
+
+bool VuGraph::createWidgets(lv_obj_t* parent) {
+    if (canvas_) {
+        return true; // Already created
+    }
+
     if (!parent) {
         return false; // Invalid parent
     }
@@ -117,9 +143,7 @@ bool VuGraph::initialize(lv_obj_t* parent) {
 
         lv_obj_set_size(canvas_, LV_PCT(95), LV_PCT(90));
         lv_obj_center(canvas_);
-        lv_obj_set_style_bg_opa(canvas_, LV_OPA_0, 0);
-        lv_obj_set_style_border_opa(canvas_, LV_OPA_0, 0);
-        lv_obj_set_style_pad_all(canvas_, 0, 0);
+        lv_obj_add_style(canvas_, &ui_style_container_clear, 0);
         lv_obj_clear_flag(canvas_, LV_OBJ_FLAG_SCROLLABLE);
 
         // Calculate centering offset (320px display width)
@@ -134,7 +158,7 @@ bool VuGraph::initialize(lv_obj_t* parent) {
             for (int j = 0; j < SEGMENTS_PER_BAR; j++) {
                 segments_[i][j] = lv_obj_create(canvas_);
                 if (!segments_[i][j]) {
-                    cleanup();
+                    destroyWidgets();
                     return false;
                 }
 
@@ -144,27 +168,27 @@ bool VuGraph::initialize(lv_obj_t* parent) {
                 lv_obj_set_size(segments_[i][j], SEGMENT_WIDTH, SEGMENT_HEIGHT);
                 lv_obj_set_pos(segments_[i][j], bar_x, seg_y);
 
-                // Style: dim (unlit) by default
-                lv_obj_set_style_bg_color(segments_[i][j], getSegmentColor(j, false), 0);
-                lv_obj_set_style_bg_opa(segments_[i][j], LV_OPA_COVER, 0);
-                lv_obj_set_style_border_opa(segments_[i][j], LV_OPA_0, 0);
-                lv_obj_set_style_radius(segments_[i][j], 2, 0);
+                // Style: dim (unlit) by default, lit colour while CHECKED
+                lv_obj_add_style(segments_[i][j], &ui_style_vu_segment, 0);
+                lv_obj_add_style(segments_[i][j], getSegmentStyle(j, false), 0);
+                lv_obj_add_style(segments_[i][j], getSegmentStyle(j, true), LV_STATE_CHECKED);
                 lv_obj_clear_flag(segments_[i][j], LV_OBJ_FLAG_SCROLLABLE);
             }
 
             // Create peak indicator segment (overlays the peak position)
             peakSegments_[i] = lv_obj_create(canvas_);
             if (!peakSegments_[i]) {
-                cleanup();
+                destroyWidgets();
                 return false;
             }
 
             lv_obj_set_size(peakSegments_[i], SEGMENT_WIDTH, SEGMENT_HEIGHT);
             lv_obj_set_pos(peakSegments_[i], bar_x, BAR_TOTAL_HEIGHT - SEGMENT_HEIGHT);
-            lv_obj_set_style_bg_color(peakSegments_[i], lv_color_white(), 0);
-            lv_obj_set_style_bg_opa(peakSegments_[i], LV_OPA_0, 0); // Hidden initially
-            lv_obj_set_style_border_opa(peakSegments_[i], LV_OPA_0, 0);
-            lv_obj_set_style_radius(peakSegments_[i], 2, 0);
+            // Hidden until one of the zone states is set
+            lv_obj_add_style(peakSegments_[i], &ui_style_vu_peak, 0);
+            lv_obj_add_style(peakSegments_[i], &ui_style_vu_segment_green_lit, UI_STATE_PEAK_GREEN);
+            lv_obj_add_style(peakSegments_[i], &ui_style_vu_segment_yellow_lit, UI_STATE_PEAK_YELLOW);
+            lv_obj_add_style(peakSegments_[i], &ui_style_vu_segment_red_lit, UI_STATE_PEAK_RED);
             lv_obj_clear_flag(peakSegments_[i], LV_OBJ_FLAG_SCROLLABLE);
 
             peakLevels_[i] = 0;
@@ -175,25 +199,41 @@ bool VuGraph::initialize(lv_obj_t* parent) {
         // Create frequency labels
         createFrequencyLabels();
 
-        // Initialize audio analyzer
-        audio_.Init();
-
-        initialized_ = true;
         return true;
 
     } catch (...) {
-        cleanup(); // Clean up on any exception
+        destroyWidgets(); // Clean up on any exception
         return false;
     }
 }
 
-void VuGraph::update() {
+void VuGraph::destroyWidgets() {
+    // Segments, peaks and labels are children of the canvas and go with it
+    for (int i = 0; i < NUM_VU_CHANNELS; i++) {
+        for (int j = 0; j < SEGMENTS_PER_BAR; j++) {
+            segments_[i][j] = nullptr;
+        }
+        peakSegments_[i] = nullptr;
+        peakLevels_[i] = 0;
+        peakTimers_[i] = 0;
+        prevLitSegments_[i] = -1;
+    }
+
+    if (canvas_) {
+        lv_obj_del(canvas_);
+        canvas_ = nullptr;
+    }
+}
+
+void VuGraph::update(bool render) {
     if (!initialized_) {
         return;
     }
     
     readFrequencies();
-    updateVuBars();
+    if (render && canvas_) {
+        updateVuBars();
+    }
     getVuLevels();
     
     // Sync global variables for LED animations
@@ -297,23 +337,26 @@ void VuGraph::updateVuBars() {
 
             for (int j = minSeg; j < maxSeg && j < SEGMENTS_PER_BAR; j++) {
                 if (!segments_[i][j]) continue;
-                bool lit = (j < litSegments);
-                lv_obj_set_style_bg_color(segments_[i][j], getSegmentColor(j, lit), 0);
+                lv_obj_set_state(segments_[i][j], LV_STATE_CHECKED, j < litSegments);
             }
             prevLitSegments_[i] = litSegments;
         }
 
         // Update peak indicator
         if (peakSegments_[i]) {
+            lv_state_t peakState = 0;
             if (peakLevels_[i] > 0 && peakLevels_[i] > litSegments) {
                 // Show peak indicator
                 int peakY = BAR_TOTAL_HEIGHT - peakLevels_[i] * (SEGMENT_HEIGHT + SEGMENT_GAP);
                 lv_obj_set_y(peakSegments_[i], peakY);
-                lv_obj_set_style_bg_color(peakSegments_[i], getSegmentColor(peakLevels_[i] - 1, true), 0);
-                lv_obj_set_style_bg_opa(peakSegments_[i], LV_OPA_COVER, 0);
-            } else {
-                // Hide peak indicator when it matches current level
-                lv_obj_set_style_bg_opa(peakSegments_[i], LV_OPA_0, 0);
+                peakState = getPeakState(peakLevels_[i] - 1);
+            }
+            // No zone state hides the indicator (peak matches current level)
+            if ((lv_obj_get_state(peakSegments_[i]) & UI_STATE_PEAK_ANY) != peakState) {
+                lv_obj_remove_state(peakSegments_[i], UI_STATE_PEAK_ANY & ~peakState);
+                if (peakState) {
+                    lv_obj_add_state(peakSegments_[i], peakState);
+                }
             }
         }
     }
@@ -342,29 +385,16 @@ void VuGraph::readFrequencies() {
     if (g_ledManager) {
         g_ledManager->updateVuLevels(vuValues_, audioLevel_);
     }
+
+    // Publish the raw bands for the web spectrum stream (never blocks)
+    g_audioSnapshot.publish(vuValues_, audioLevel_);
 }
 
 void VuGraph::cleanup() {
+    destroyWidgets();
+
     for (int i = 0; i < NUM_VU_CHANNELS; i++) {
-        for (int j = 0; j < SEGMENTS_PER_BAR; j++) {
-            if (segments_[i][j]) {
-                lv_obj_del(segments_[i][j]);
-                segments_[i][j] = nullptr;
-            }
-        }
-        if (peakSegments_[i]) {
-            lv_obj_del(peakSegments_[i]);
-            peakSegments_[i] = nullptr;
-        }
         vuValues_[i] = 0;
-        peakLevels_[i] = 0;
-        peakTimers_[i] = 0;
-        prevLitSegments_[i] = -1;
-    }
-
-    if (canvas_) {
-        lv_obj_del(canvas_);
-        canvas_ = nullptr;
     }
 
     initialized_ = false;
@@ -385,29 +415,33 @@ void VuGraph::createFrequencyLabels() {
     for (int i = 0; i < NUM_VU_CHANNELS; i++) {
         lv_obj_t* label = lv_label_create(canvas_);
         lv_label_set_text(label, freq_labels[i]);
-        lv_obj_set_style_text_font(label, &lv_font_montserrat_14, 0);
-        lv_obj_set_style_text_color(label, lv_color_hex(UI_COLOR_PRIMARY), 0);
+        lv_obj_add_style(label, &ui_style_vu_label, 0);
         int label_x = start_x + i * (SEGMENT_WIDTH + BAR_SPACING);
         lv_obj_set_pos(label, label_x, BAR_TOTAL_HEIGHT + 5);
     }
 }
 
-lv_color_t VuGraph::getSegmentColor(int segmentIndex, bool lit) {
+const lv_style_t* VuGraph::getSegmentStyle(int segmentIndex, bool lit) {
     // Segments: 0 = bottom (green), SEGMENTS_PER_BAR-1 = top (red)
     // 10 segments: Green 0-5, Yellow 6-7, Red 8-9
 
-    lv_color_t color;
-
     if (segmentIndex < 6) {
         // Green zone (bottom 60%)
-        color = lit ? lv_color_hex(0x00FF00) : lv_color_hex(0x002200);
+        return lit ? &ui_style_vu_segment_green_lit : &ui_style_vu_segment_green;
     } else if (segmentIndex < 8) {
         // Yellow zone (middle 20%)
-        color = lit ? lv_color_hex(0xFFFF00) : lv_color_hex(0x222200);
+        return lit ? &ui_style_vu_segment_yellow_lit : &ui_style_vu_segment_yellow;
     } else {
         // Red zone (top 20%)
-        color = lit ? lv_color_hex(0xFF0000) : lv_color_hex(0x220000);
+        return lit ? &ui_style_vu_segment_red_lit : &ui_style_vu_segment_red;
     }
+}
 
-    return color;
-}
\ No newline at end of file
+lv_state_t VuGraph::getPeakState(int segmentIndex) {
+    if (segmentIndex < 6) {
+        return UI_STATE_PEAK_GREEN;
+    } else if (segmentIndex < 8) {
+        return UI_STATE_PEAK_YELLOW;
+    }
+    return UI_STATE_PEAK_RED;
+}
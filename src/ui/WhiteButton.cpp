@@ -1,5 +1,6 @@
 #include "WhiteButton.h"
 #include "UIManager.h"
+#include "UIStyles.h"
 #include "modular-ui.h"
 #include "ui.h"
 
@@ -172,24 +173,8 @@ void WhiteButton::applyButtonStyling() {
         return;
     }
 
-    // === INACTIVE STATE - Dark hardware button ===
-    lv_obj_set_style_bg_color(button_, lv_color_hex(UI_COLOR_SURFACE_LIGHT), 0);
-    lv_obj_set_style_bg_grad_color(button_, lv_color_hex(UI_COLOR_SURFACE_DARK), 0);
-    lv_obj_set_style_bg_grad_dir(button_, LV_GRAD_DIR_VER, 0);
-    lv_obj_set_style_border_color(button_, lv_color_hex(UI_COLOR_BORDER), 0);
-    lv_obj_set_style_border_width(button_, UI_BORDER_NORMAL, 0);
-    lv_obj_set_style_radius(button_, UI_RADIUS_MEDIUM, 0);
-    lv_obj_set_style_text_color(button_, lv_color_hex(UI_COLOR_TEXT_MUTED), 0);
-
-    // === ACTIVE STATE - Bright white, thick bright border (simulates glow) ===
-    lv_obj_set_style_bg_color(button_, lv_color_hex(UI_COLOR_WHITE), LV_STATE_CHECKED);
-    lv_obj_set_style_bg_grad_color(button_, lv_color_hex(UI_COLOR_TEXT), LV_STATE_CHECKED);
-    lv_obj_set_style_border_color(button_, lv_color_hex(UI_COLOR_PRIMARY), LV_STATE_CHECKED);
-    lv_obj_set_style_border_width(button_, UI_BORDER_THICK, LV_STATE_CHECKED);
-    lv_obj_set_style_text_color(button_, lv_color_hex(UI_COLOR_BLACK), LV_STATE_CHECKED);
-
-    // === PRESSED STATE - Feedback ===
-    lv_obj_set_style_bg_color(button_, lv_color_hex(UI_COLOR_TEXT), LV_STATE_PRESSED);
-    lv_obj_set_style_border_color(button_, lv_color_hex(UI_COLOR_WHITE), LV_STATE_PRESSED);
-    lv_obj_set_style_text_color(button_, lv_color_hex(UI_COLOR_BLACK), LV_STATE_PRESSED);
+    // Shared const styles - state changes only switch which ones apply
+    lv_obj_add_style(button_, &ui_style_button, 0);                                // Dark hardware button
+    lv_obj_add_style(button_, &ui_style_button_white_checked, LV_STATE_CHECKED);   // Bright white, cyan border
+    lv_obj_add_style(button_, &ui_style_button_white_pressed, LV_STATE_PRESSED);   // Feedback
 }
\ No newline at end of file
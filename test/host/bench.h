@@ -0,0 +1,39 @@
+#pragma once
+
+// Timing helper for the host benchmarks. Host numbers are for comparing
+// the variants within one run, not a prediction of ESP32-S3 timings.
+
+#include <stdio.h>
+#include <chrono>
+
+/**
+ * @brief Run fn() iterations times and print the mean cost per call
+ * @param unitsPerCall Work items per call (pixels, messages) for a per-item figure
+ * @return Nanoseconds per call
+ */
+template <typename Fn>
+double bench(const char* name, long iterations, Fn fn, long unitsPerCall = 1) {
+    for (long i = 0; i < iterations / 10 + 1; i++) {
+        fn();  // Warm up caches and branch predictors
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+        fn();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    double perCall = ns / iterations;
+    if (unitsPerCall > 1) {
+        printf("%-40s %10.1f ns/call %8.2f ns/unit\n", name, perCall, perCall / unitsPerCall);
+    } else {
+        printf("%-40s %10.1f ns/call\n", name, perCall);
+    }
+    return perCall;
+}
+
+/**
+ * @brief Keep the optimiser from discarding a benchmark's result
+ */
+template <typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
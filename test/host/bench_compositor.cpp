@@ -0,0 +1,75 @@
+// Cost of the effect layers: LayerCompositor::blend() per mode, and a
+// whole compose() with one to MAX_LAYERS layers, at the size of a full
+// 8 x 150 install.
+
+#include "bench.h"
+#include "host.h"
+#include "LayerCompositor.h"
+#include <vector>
+
+static const int PIXELS = 8 * 150;
+
+static void fillNoise(std::vector<CRGB>& frame, uint32_t seed) {
+    for (size_t i = 0; i < frame.size(); i++) {
+        seed = seed * 1664525 + 1013904223;
+        frame[i] = CRGB(seed >> 24, seed >> 16, seed >> 8);
+    }
+}
+
+int main() {
+    hostSetQuiet(true);
+    std::vector<CRGB> base(PIXELS), layer(PIXELS), out(PIXELS);
+    fillNoise(base, 1);
+    fillNoise(layer, 2);
+
+    const long iterations = 5000;
+    char name[48];
+    for (uint8_t mode = 0; mode < LayerCompositor::BLEND_COUNT; mode++) {
+        const uint8_t opacities[] = {255, 128};
+        for (size_t o = 0; o < sizeof(opacities); o++) {
+            snprintf(name, sizeof(name), "blend %s, opacity %u", LayerCompositor::getBlendName(mode),
+                     opacities[o]);
+            bench(name, iterations, [&]() {
+                // Blending in place compounds, so start from the base each time
+                memcpy(out.data(), base.data(), sizeof(CRGB) * PIXELS);
+                LayerCompositor::blend(out.data(), layer.data(), PIXELS, (LayerCompositor::BlendMode)mode,
+                                       opacities[o]);
+                benchKeep(out[0]);
+            }, PIXELS);
+        }
+    }
+    bench("memcpy of the frame (baseline)", iterations, [&]() {
+        memcpy(out.data(), base.data(), sizeof(CRGB) * PIXELS);
+        benchKeep(out[0]);
+    }, PIXELS);
+
+    // compose() as LEDManager::update() runs it: base copy plus each layer
+    LayerCompositor compositor;
+    if (!compositor.begin(PIXELS)) {
+        printf("out of memory\n");
+        return 1;
+    }
+    const LayerCompositor::Layer layers[LayerCompositor::MAX_LAYERS] = {
+        { 0, LayerCompositor::BLEND_ADD, 255 },
+        { 0, LayerCompositor::BLEND_SCREEN, 200 },
+        { 0, LayerCompositor::BLEND_ALPHA, 128 },
+    };
+    double previous = 0;
+    for (uint8_t count = 1; count <= LayerCompositor::MAX_LAYERS; count++) {
+        compositor.request(layers, count);
+        compositor.applyPending(PIXELS);
+        for (uint8_t i = 0; i < count; i++) {
+            memcpy(compositor.getLayer(i).buffer, layer.data(), sizeof(CRGB) * PIXELS);
+        }
+        snprintf(name, sizeof(name), "compose, %u layer%s", count, count > 1 ? "s" : "");
+        double ns = bench(name, iterations, [&]() {
+            compositor.compose(out.data(), base.data(), PIXELS);
+            benchKeep(out[0]);
+        }, PIXELS);
+        if (count > 1) {
+            printf("  layer %u adds %.2f ns/pixel\n", count, (ns - previous) / PIXELS);
+        }
+        previous = ns;
+    }
+    return 0;
+}
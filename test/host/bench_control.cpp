@@ -0,0 +1,70 @@
+// JSON vs binary control messages: parse, decode and post to the
+// ControlQueue, as WebUIManager does for each WebSocket frame.
+
+#include "bench.h"
+#include "host.h"
+#include "ControlJson.h"
+#include "ControlQueue.h"
+#include "JsonArena.h"
+
+static JsonArena s_arena;
+static ControlQueue s_queue;
+
+static const char* const JSON_MESSAGES[] = {
+    "{\"message\":\"brightness\",\"value\":128}",
+    "{\"message\":\"colour\",\"value\":\"#ffa500\"}",
+    "{\"message\":\"animation\",\"value\":true,\"animation\":7}",
+    "{\"message\":\"white\",\"value\":false}",
+};
+static const uint8_t BINARY_MESSAGES[][ControlProtocol::FRAME_SIZE] = {
+    { ControlProtocol::OP_BRIGHTNESS, 128, 0, 0 },
+    { ControlProtocol::OP_COLOUR, 0xff, 0xa5, 0x00 },
+    { ControlProtocol::OP_ANIMATION, 1, 7, 0 },
+    { ControlProtocol::OP_WHITE, 0, 0, 0 },
+};
+static const size_t MESSAGE_COUNT = sizeof(BINARY_MESSAGES) / sizeof(BINARY_MESSAGES[0]);
+static size_t s_jsonLengths[MESSAGE_COUNT];
+
+static void drainQueue() {
+    ControlProtocol::Control pending[ControlQueue::SLOT_COUNT];
+    benchKeep(s_queue.drain(pending));
+}
+
+int main() {
+    hostSetQuiet(true);
+    for (size_t i = 0; i < MESSAGE_COUNT; i++) {
+        s_jsonLengths[i] = strlen(JSON_MESSAGES[i]);
+    }
+
+    const long iterations = 200000;
+    size_t next = 0;
+    double json = bench("json: parse + decode + post", iterations, [&]() {
+        size_t i = next++ % MESSAGE_COUNT;
+        JsonDocument request(&s_arena);
+        deserializeJson(request, JSON_MESSAGES[i], s_jsonLengths[i]);
+        const char* type = request["message"];
+        ControlProtocol::Control control;
+        if (type && ControlJson::decodeControl(ControlJson::hashMessageType(type), request, control)) {
+            s_queue.post(control);
+        }
+        if (i == MESSAGE_COUNT - 1) {
+            drainQueue();
+        }
+    });
+
+    double binary = bench("binary: decode + post", iterations, [&]() {
+        size_t i = next++ % MESSAGE_COUNT;
+        ControlProtocol::Control control;
+        if (ControlProtocol::decode(BINARY_MESSAGES[i], ControlProtocol::FRAME_SIZE, control)) {
+            s_queue.post(control);
+        }
+        if (i == MESSAGE_COUNT - 1) {
+            drainQueue();
+        }
+    });
+
+    printf("json / binary: %.1fx, %zu vs %zu bytes per message\n", json / binary,
+           (s_jsonLengths[0] + s_jsonLengths[1] + s_jsonLengths[2] + s_jsonLengths[3]) / MESSAGE_COUNT,
+           ControlProtocol::FRAME_SIZE);
+    return 0;
+}
@@ -0,0 +1,88 @@
+// The OutputStage pass against what it replaced: copying the frame and
+// scaling it with FastLED's scale8() (brightness only - no gamma,
+// calibration or colour order), at the size of a full 8 x 150 install.
+// The dithered pass is timed separately: it is what runs at high frame
+// rates.
+
+#include "bench.h"
+#include "host.h"
+#include "LedOverlay.h"
+#include "OutputStage.h"
+#include <Preferences.h>
+#include <vector>
+
+static const int STRIPS = 8;
+static const int LEDS = 150;
+static const int PIXELS = STRIPS * LEDS;
+static const uint8_t LEVEL = 128;
+
+int main() {
+    hostSetQuiet(true);
+    std::vector<CRGB> frame(PIXELS), out(PIXELS), publish(PIXELS);
+    uint32_t seed = 1;
+    for (int i = 0; i < PIXELS; i++) {
+        seed = seed * 1664525 + 1013904223;
+        frame[i] = CRGB(seed >> 24, seed >> 16, seed >> 8);
+    }
+
+    const long iterations = 5000;
+    bench("copy + nscale8 (FastLED brightness)", iterations, [&]() {
+        memcpy(out.data(), frame.data(), sizeof(CRGB) * PIXELS);
+        nscale8(out.data(), PIXELS, LEVEL);
+        benchKeep(out[0]);
+    }, PIXELS);
+
+    // Gamma and a calibration change the tables, not the pass
+    Preferences::eraseAll();
+    OutputStage::Settings settings = OutputStage::defaults();
+    settings.gamma = 22;
+    settings.calibrationCount = 1;
+    settings.calibrations[0] = { 4, 4, { 255, 230, 200 } };
+    OutputStage stage;
+    stage.request(settings);
+    stage.prepare(LEVEL);
+
+    bench("output stage: LUT pass", iterations, [&]() {
+        stage.render(out.data(), frame.data(), nullptr, STRIPS, LEDS, nullptr);
+        benchKeep(out[0]);
+    }, PIXELS);
+    bench("output stage: LUT pass + publish", iterations, [&]() {
+        stage.render(out.data(), frame.data(), publish.data(), STRIPS, LEDS, nullptr);
+        benchKeep(out[0]);
+    }, PIXELS);
+
+    LedOverlay overlay;
+    overlay.showProgress(50);
+    std::vector<CRGB> drawn(PIXELS);
+    overlay.render(drawn.data(), frame.data(), STRIPS, LEDS);
+    bench("output stage: LUT pass, progress overlay", iterations, [&]() {
+        stage.render(out.data(), drawn.data(), nullptr, STRIPS, LEDS, nullptr, &overlay);
+        benchKeep(out[0]);
+    }, PIXELS);
+
+    // Dithering needs the error buffer and a frame rate over DITHER_ON_FPS
+    OutputStage dithered;
+    if (!dithered.begin(PIXELS)) {
+        printf("out of memory\n");
+        return 1;
+    }
+    dithered.request(settings);
+    for (int i = 0; i < 16; i++) {
+        hostAdvanceMs(1000 / (OutputStage::DITHER_ON_FPS * 2));
+        dithered.prepare(LEVEL);
+    }
+    if (!dithered.getStats().dithering) {
+        printf("dithering did not turn on\n");
+        return 1;
+    }
+    double plain = bench("output stage: LUT pass, not dithered", iterations, [&]() {
+        stage.render(out.data(), frame.data(), nullptr, STRIPS, LEDS, nullptr);
+        benchKeep(out[0]);
+    }, PIXELS);
+    double dither = bench("output stage: LUT pass, dithered", iterations, [&]() {
+        dithered.render(out.data(), frame.data(), nullptr, STRIPS, LEDS, nullptr);
+        benchKeep(out[0]);
+    }, PIXELS);
+    printf("dithering adds %.2f ns/pixel\n", (dither - plain) / PIXELS);
+    return 0;
+}
@@ -0,0 +1,143 @@
+// GET/PATCH /api/state throughput: each request runs the handler's path
+// the way WebUIManager does - PATCH bodies are parsed into an
+// arena-backed document, decoded with ControlJson::decodeState(), posted
+// to the ControlQueue, then drained and applied as the main loop would;
+// GET builds and serializes the state object. The HTTP server itself is
+// left out, so this is the handlers' share of a request.
+
+#include "bench.h"
+#include "host.h"
+#include "ControlJson.h"
+#include "ControlQueue.h"
+#include "JsonArena.h"
+
+static JsonArena s_arena;
+static ControlQueue s_queue;
+
+/**
+ * @brief What WebUIManager::applyControl() changes, without the LEDs
+ */
+struct State {
+    uint8_t brightness;
+    bool vu;
+    bool white;
+    bool animation;
+    uint8_t index;
+    uint8_t colour[3];
+};
+
+static State s_state = { 128, false, false, false, 0, { 0, 0, 0 } };
+
+static void applyControl(const ControlProtocol::Control& control) {
+    switch (control.opcode) {
+        case ControlProtocol::OP_VU:
+            s_state.vu = control.payload[0] != 0;
+            break;
+        case ControlProtocol::OP_WHITE:
+            s_state.white = control.payload[0] != 0;
+            break;
+        case ControlProtocol::OP_BRIGHTNESS:
+            s_state.brightness = control.payload[0];
+            break;
+        case ControlProtocol::OP_ANIMATION:
+            s_state.animation = control.payload[0] != 0;
+            s_state.index = control.payload[1];
+            if (s_state.animation) {
+                s_state.white = false;
+            }
+            break;
+        case ControlProtocol::OP_COLOUR:
+            memcpy(s_state.colour, control.payload, sizeof(s_state.colour));
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief One PATCH, from the collected body to the applied state
+ * @return The status the handler responds with
+ */
+static int patchState(const char* body, size_t length) {
+    JsonDocument state(&s_arena);
+    DeserializationError error = deserializeJson(state, body, length);
+
+    ControlProtocol::Control controls[ControlQueue::SLOT_COUNT];
+    uint8_t count = 0;
+    if (error || !state.is<JsonObjectConst>() ||
+        !ControlJson::decodeState(state, s_state.index, controls, count)) {
+        return 400;
+    }
+    s_queue.post(controls, count);
+
+    // Main loop: applyPendingControls()
+    ControlProtocol::Control pending[ControlQueue::SLOT_COUNT];
+    uint8_t applied = s_queue.drain(pending);
+    for (uint8_t i = 0; i < applied; i++) {
+        applyControl(pending[i]);
+    }
+    return 200;
+}
+
+/**
+ * @brief One GET, as generateStateResponse() builds it
+ */
+static size_t getState(char* response, size_t size) {
+    JsonDocument doc(&s_arena);
+    doc["brightness"] = s_state.brightness;
+    doc["vu"] = s_state.vu;
+    doc["white"] = s_state.white;
+    JsonObject animation = doc["animation"].to<JsonObject>();
+    animation["state"] = s_state.animation;
+    animation["index"] = (int)s_state.index;
+    char colour[8];
+    snprintf(colour, sizeof(colour), "#%02x%02x%02x", s_state.colour[0], s_state.colour[1], s_state.colour[2]);
+    doc["colour"] = colour;
+    return serializeJson(doc, response, size);
+}
+
+struct Body {
+    const char* name;
+    const char* json;
+    int status;         ///< Expected response
+};
+
+static const Body BODIES[] = {
+    { "PATCH brightness", "{\"brightness\":180}", 200 },
+    { "PATCH colour + brightness", "{\"colour\":\"#ffa500\",\"brightness\":200}", 200 },
+    { "PATCH full scene",
+      "{\"animation\":{\"state\":true,\"index\":7},\"colour\":\"#20c0ff\",\"white\":false,"
+      "\"vu\":true,\"brightness\":150}", 200 },
+    { "PATCH rejected (invalid field)", "{\"colour\":\"#ffa500\",\"brightness\":\"loud\"}", 400 },
+};
+
+static void report(const char* name, double ns) {
+    printf("  %-38s %10.0f requests/s\n", name, 1e9 / ns);
+}
+
+int main() {
+    hostSetQuiet(true);
+    const long iterations = 200000;
+    char name[64];
+
+    for (size_t i = 0; i < sizeof(BODIES) / sizeof(BODIES[0]); i++) {
+        const Body& body = BODIES[i];
+        size_t length = strlen(body.json);
+        if (patchState(body.json, length) != body.status) {
+            printf("%s: unexpected status\n", body.name);
+            return 1;
+        }
+        snprintf(name, sizeof(name), "%s (%zu bytes)", body.name, length);
+        double ns = bench(name, iterations, [&]() {
+            benchKeep(patchState(body.json, length));
+        });
+        report(body.name, ns);
+    }
+
+    char response[160];
+    double ns = bench("GET state", iterations, [&]() {
+        benchKeep(getState(response, sizeof(response)));
+    });
+    report("GET state", ns);
+    return 0;
+}
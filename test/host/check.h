@@ -0,0 +1,38 @@
+#pragma once
+
+// Minimal assertions for the host tests: a failed CHECK prints where and
+// marks the run failed, RUN() executes one test function and reports it.
+
+#include <stdio.h>
+
+static int g_checkFailures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_checkFailures++;                                              \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                   \
+    do {                                                                             \
+        long long checkActual_ = (long long)(actual);                                \
+        long long checkExpected_ = (long long)(expected);                            \
+        if (checkActual_ != checkExpected_) {                                        \
+            printf("  %s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__,       \
+                   #actual, checkActual_, checkExpected_);                           \
+            g_checkFailures++;                                                       \
+        }                                                                            \
+    } while (0)
+
+#define RUN(test)                                                       \
+    do {                                                                \
+        int checkBefore_ = g_checkFailures;                             \
+        test();                                                         \
+        printf("%s %s\n", g_checkFailures == checkBefore_ ? "ok  " : "FAIL", #test); \
+    } while (0)
+
+inline int checkResult() {
+    return g_checkFailures == 0 ? 0 : 1;
+}
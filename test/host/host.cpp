@@ -0,0 +1,200 @@
+#include "host.h"
+#include <FastLED.h>
+#include <Logger.h>
+#include <esp_rom_crc.h>
+#include <stdarg.h>
+#include <chrono>
+
+HardwareSerial Serial;
+EspClass ESP;
+LoggerClass Logger;
+CFastLED FastLED;
+
+static unsigned long s_offsetUs = 0;
+static esp_reset_reason_t s_resetReason = ESP_RST_POWERON;
+static bool s_quiet = false;
+
+static uint64_t hostMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const uint64_t s_startUs = hostMicros();
+
+unsigned long micros() {
+    return (unsigned long)(hostMicros() - s_startUs + s_offsetUs);
+}
+
+unsigned long millis() {
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+    hostAdvanceMs(ms);
+}
+
+void hostAdvanceMs(unsigned long ms) {
+    s_offsetUs += ms * 1000;
+}
+
+void hostSetResetReason(esp_reset_reason_t reason) {
+    s_resetReason = reason;
+}
+
+void hostSetQuiet(bool quiet) {
+    s_quiet = quiet;
+}
+
+esp_reset_reason_t esp_reset_reason(void) {
+    return s_resetReason;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void HardwareSerial::println(const char* line) {
+    if (!s_quiet) {
+        puts(line);
+    }
+}
+
+void HardwareSerial::printf(const char* format, ...) {
+    if (s_quiet) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+static void logLine(const char* level, const char* format, va_list args) {
+    if (s_quiet) {
+        return;
+    }
+    printf("[%s] ", level);
+    vprintf(format, args);
+    putchar('\n');
+}
+
+#define LOGGER_LEVEL(name, label)                   \
+    void LoggerClass::name(const char* format, ...) { \
+        va_list args;                               \
+        va_start(args, format);                     \
+        logLine(label, format, args);               \
+        va_end(args);                               \
+    }
+
+LOGGER_LEVEL(debug, "D")
+LOGGER_LEVEL(info, "I")
+LOGGER_LEVEL(warning, "W")
+LOGGER_LEVEL(error, "E")
+
+// FastLED's random8/random16 generator
+static uint16_t s_rand16seed = 1337;
+
+uint16_t random16() {
+    s_rand16seed = (s_rand16seed * 2053) + 13849;
+    return s_rand16seed;
+}
+
+uint16_t random16(uint16_t lim) {
+    return ((uint32_t)random16() * lim) >> 16;
+}
+
+uint8_t random8() {
+    random16();
+    return (uint8_t)((s_rand16seed & 0xFF) + (s_rand16seed >> 8));
+}
+
+uint8_t random8(uint8_t lim) {
+    return (random8() * lim) >> 8;
+}
+
+uint8_t random8(uint8_t min, uint8_t lim) {
+    return random8(lim - min) + min;
+}
+
+uint8_t sin8(uint8_t theta) {
+    return (uint8_t)(128 + 127 * sinf(theta * 6.2831853f / 256));
+}
+
+uint16_t sqrt16(uint16_t x) {
+    uint16_t root = 0;
+    while ((uint32_t)(root + 1) * (root + 1) <= x) {
+        root++;
+    }
+    return root;
+}
+
+uint16_t beatsin16(uint16_t bpm, uint16_t lowest, uint16_t highest) {
+    float phase = millis() * bpm / 60000.0f;
+    float wave = (sinf(phase * 6.2831853f) + 1) / 2;
+    return lowest + (uint16_t)(wave * (highest - lowest));
+}
+
+CRGB::CRGB(const CHSV& hsv) {
+    // Six-sector HSV, close enough to FastLED's rainbow for the tests
+    uint8_t region = hsv.h / 43;
+    uint8_t remainder = (hsv.h - region * 43) * 6;
+    uint8_t p = scale8(hsv.v, 255 - hsv.s);
+    uint8_t q = scale8(hsv.v, 255 - scale8(hsv.s, remainder));
+    uint8_t t = scale8(hsv.v, 255 - scale8(hsv.s, 255 - remainder));
+    switch (region) {
+        case 0: r = hsv.v; g = t; b = p; break;
+        case 1: r = q; g = hsv.v; b = p; break;
+        case 2: r = p; g = hsv.v; b = t; break;
+        case 3: r = p; g = q; b = hsv.v; break;
+        case 4: r = t; g = p; b = hsv.v; break;
+        default: r = hsv.v; g = p; b = q; break;
+    }
+}
+
+void nscale8(CRGB* leds, uint16_t count, uint8_t scale) {
+    for (uint16_t i = 0; i < count; i++) {
+        leds[i].nscale8(scale);
+    }
+}
+
+void fadeToBlackBy(CRGB* leds, uint16_t count, uint8_t fade) {
+    nscale8(leds, count, 255 - fade);
+}
+
+void fill_solid(CRGB* leds, int count, const CRGB& colour) {
+    for (int i = 0; i < count; i++) {
+        leds[i] = colour;
+    }
+}
+
+void fill_rainbow(CRGB* leds, int count, uint8_t initialHue, uint8_t deltaHue) {
+    for (int i = 0; i < count; i++) {
+        leds[i] = CHSV(initialHue + i * deltaHue, 240, 255);
+    }
+}
+
+CRGB blend(const CRGB& p1, const CRGB& p2, fract8 amountOfP2) {
+    return CRGB(blend8(p1.r, p2.r, amountOfP2), blend8(p1.g, p2.g, amountOfP2), blend8(p1.b, p2.b, amountOfP2));
+}
+
+void CFastLED::show() {
+    shows_++;
+    shownLeds_ = controller_.leds();
+    shownCount_ = controller_.size();
+}
+
+void CFastLED::clear(bool writeData) {
+    if (controller_.leds()) {
+        fill_solid(controller_.leds(), controller_.size(), CRGB::Black);
+    }
+    if (writeData) {
+        show();
+    }
+}
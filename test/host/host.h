@@ -0,0 +1,21 @@
+#pragma once
+
+// Controls for the host stand-ins in stubs/ (implemented in host.cpp)
+
+#include <Arduino.h>
+#include <esp_system.h>
+
+/**
+ * @brief Move millis()/micros() forward without waiting
+ */
+void hostAdvanceMs(unsigned long ms);
+
+/**
+ * @brief What esp_reset_reason() reports (default ESP_RST_POWERON)
+ */
+void hostSetResetReason(esp_reset_reason_t reason);
+
+/**
+ * @brief Silence Serial and Logger output (benchmarks, noisy tests)
+ */
+void hostSetQuiet(bool quiet);
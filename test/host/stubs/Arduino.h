@@ -0,0 +1,55 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino-ESP32 core the tested sources
+// use. Time comes from steady_clock plus an offset tests can advance
+// (see host.h); critical sections are no-ops - the host tests are single
+// threaded.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define IRAM_ATTR
+#define PROGMEM
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZE(mux) (*(mux) = 0)
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+template <typename T, typename L, typename H>
+inline T constrain(T value, L low, H high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+class HardwareSerial {
+public:
+    void println(const char* line);
+    void printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 0; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    void restart() { abort(); }
+};
+
+extern EspClass ESP;
@@ -0,0 +1,3 @@
+#pragma once
+
+// Host stand-in: everything the sources use lives in ESPAsyncWebServer.h
@@ -0,0 +1,26 @@
+#pragma once
+
+// Host stand-in for the LVGL colour wheel (shadows include/ColourWheel.h):
+// only the colour the state broadcaster reads
+
+#include <Arduino.h>
+
+class ColourWheel {
+public:
+    ColourWheel() : r_(0), g_(0), b_(0) {}
+
+    void setColor(uint8_t r, uint8_t g, uint8_t b) {
+        r_ = r;
+        g_ = g;
+        b_ = b;
+    }
+
+    void getColorRGB(uint8_t& r, uint8_t& g, uint8_t& b) const {
+        r = r_;
+        g = g_;
+        b = b_;
+    }
+
+private:
+    uint8_t r_, g_, b_;
+};
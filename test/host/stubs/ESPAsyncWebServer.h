@@ -0,0 +1,103 @@
+#pragma once
+
+// Host stand-in for the ESPAsyncWebServer WebSocket classes. Clients
+// record what was queued for them instead of sending it. The copying
+// text()/binary() overloads allocate a buffer per call like the library
+// does, so allocation-counting tests see the real cost of each API.
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+using AsyncWebSocketSharedBuffer = std::shared_ptr<std::vector<uint8_t>>;
+
+enum AwsClientStatus { WS_DISCONNECTED, WS_CONNECTED, WS_DISCONNECTING };
+
+class AsyncWebSocketClient {
+public:
+    static const size_t QUEUE_SIZE = 32;    ///< WS_MAX_QUEUED_MESSAGES
+
+    AsyncWebSocketClient() : id_(0), status_(WS_DISCONNECTED), queued_(0), messages_(0), bytes_(0) {}
+
+    uint32_t id() const { return id_; }
+    AwsClientStatus status() const { return status_; }
+    bool queueIsFull() const { return queued_ >= QUEUE_SIZE; }
+    size_t queueLen() const { return queued_; }
+
+    bool text(AsyncWebSocketSharedBuffer buffer) { return queue(buffer); }
+
+    bool text(const char* message, size_t len) {
+        return queue(std::make_shared<std::vector<uint8_t>>(message, message + len));
+    }
+
+    bool binary(const char* message, size_t len) {
+        return queue(std::make_shared<std::vector<uint8_t>>(message, message + len));
+    }
+
+    // Host only
+    void connect(uint32_t id) {
+        id_ = id;
+        status_ = WS_CONNECTED;
+        drain();
+        messages_ = 0;
+        bytes_ = 0;
+        last_.reset();
+    }
+    void disconnect() { status_ = WS_DISCONNECTED; }
+    void drain() { queued_ = 0; }
+    uint32_t getMessageCount() const { return messages_; }
+    size_t getBytes() const { return bytes_; }
+    const AsyncWebSocketSharedBuffer& getLastMessage() const { return last_; }
+
+private:
+    uint32_t id_;
+    AwsClientStatus status_;
+    size_t queued_;
+    uint32_t messages_;
+    size_t bytes_;
+    AsyncWebSocketSharedBuffer last_;
+
+    bool queue(const AsyncWebSocketSharedBuffer& buffer) {
+        if (!buffer || status_ != WS_CONNECTED || queueIsFull()) {
+            return false;
+        }
+        queued_++;
+        messages_++;
+        bytes_ += buffer->size();
+        last_ = buffer;
+        return true;
+    }
+};
+
+class AsyncWebSocket {
+public:
+    static const uint8_t MAX_CLIENTS = 8;
+
+    explicit AsyncWebSocket(const char* url) : url_(url) {}
+
+    AsyncWebSocketClient* client(uint32_t id) {
+        for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+            if (clients_[i].id() == id && clients_[i].status() != WS_DISCONNECTED) {
+                return &clients_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void cleanupClients() {}
+
+    // Host only: connect a client in a free slot
+    AsyncWebSocketClient* connect(uint32_t id) {
+        for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+            if (clients_[i].status() == WS_DISCONNECTED) {
+                clients_[i].connect(id);
+                return &clients_[i];
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    const char* url_;
+    AsyncWebSocketClient clients_[MAX_CLIENTS];
+};
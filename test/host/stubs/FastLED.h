@@ -0,0 +1,165 @@
+#pragma once
+
+// Host stand-in for FastLED 3.7: the 8-bit math helpers (same formulas as
+// FastLED's portable C versions, so benchmarks and tests see the same
+// values), CRGB/CHSV and a controller that records what it was given.
+// Colour conversion and the wave functions are approximations.
+
+#include <Arduino.h>
+
+typedef uint8_t fract8;
+
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+    return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+inline uint8_t scale8_video(uint8_t i, fract8 scale) {
+    return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned int t = i + j;
+    return t > 255 ? 255 : t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j) {
+    return i > j ? i - j : 0;
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+    uint16_t partial = (a << 8) | b;
+    partial += (b * amountOfB);
+    partial -= (a * amountOfB);
+    return partial >> 8;
+}
+
+uint8_t random8();
+uint8_t random8(uint8_t lim);
+uint8_t random8(uint8_t min, uint8_t lim);
+uint16_t random16();
+uint16_t random16(uint16_t lim);
+
+uint8_t sin8(uint8_t theta);
+uint16_t sqrt16(uint16_t x);
+uint16_t beatsin16(uint16_t bpm, uint16_t lowest = 0, uint16_t highest = 65535);
+
+struct CHSV {
+    uint8_t h, s, v;
+    CHSV() : h(0), s(0), v(0) {}
+    CHSV(uint8_t hue, uint8_t sat, uint8_t val) : h(hue), s(sat), v(val) {}
+};
+
+struct CRGB {
+    union {
+        struct {
+            uint8_t r, g, b;
+        };
+        uint8_t raw[3];
+    };
+
+    enum HTMLColorCode : uint32_t {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Green = 0x008000,
+        Orange = 0xFFA500,
+        Red = 0xFF0000,
+        White = 0xFFFFFF
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(uint32_t colour) : r((colour >> 16) & 0xFF), g((colour >> 8) & 0xFF), b(colour & 0xFF) {}
+    CRGB(HTMLColorCode colour) : CRGB((uint32_t)colour) {}
+    CRGB(const CHSV& hsv);
+
+    uint8_t& operator[](uint8_t index) { return raw[index]; }
+    const uint8_t& operator[](uint8_t index) const { return raw[index]; }
+
+    CRGB& operator+=(const CRGB& rhs) {
+        r = qadd8(r, rhs.r);
+        g = qadd8(g, rhs.g);
+        b = qadd8(b, rhs.b);
+        return *this;
+    }
+
+    CRGB& nscale8(uint8_t scale) {
+        r = scale8(r, scale);
+        g = scale8(g, scale);
+        b = scale8(b, scale);
+        return *this;
+    }
+
+    CRGB& fadeToBlackBy(uint8_t fade) { return nscale8(255 - fade); }
+
+    bool operator==(const CRGB& rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+    bool operator!=(const CRGB& rhs) const { return !(*this == rhs); }
+};
+
+static_assert(sizeof(CRGB) == 3, "CRGB must be 3 packed bytes");
+
+void nscale8(CRGB* leds, uint16_t count, uint8_t scale);
+void fadeToBlackBy(CRGB* leds, uint16_t count, uint8_t fade);
+void fill_solid(CRGB* leds, int count, const CRGB& colour);
+void fill_rainbow(CRGB* leds, int count, uint8_t initialHue, uint8_t deltaHue = 5);
+CRGB blend(const CRGB& p1, const CRGB& p2, fract8 amountOfP2);
+
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+#define DISABLE_DITHER 0x00
+#define BINARY_DITHER 0x01
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2812B {};
+
+/**
+ * @brief Records the buffer it was last given and what show() sent
+ */
+class CLEDController {
+public:
+    CLEDController() : leds_(nullptr), count_(0) {}
+
+    CLEDController& setLeds(CRGB* leds, int count) {
+        leds_ = leds;
+        count_ = count;
+        return *this;
+    }
+
+    CRGB* leds() const { return leds_; }
+    int size() const { return count_; }
+
+private:
+    CRGB* leds_;
+    int count_;
+};
+
+class CFastLED {
+public:
+    CFastLED() : brightness_(255), dither_(BINARY_DITHER), shows_(0), shownLeds_(nullptr), shownCount_(0) {}
+
+    template <template <uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CLEDController& addLeds(CRGB* leds, int count) {
+        controller_.setLeds(leds, count);
+        return controller_;
+    }
+
+    void show();
+    void clear(bool writeData = false);
+    void setBrightness(uint8_t brightness) { brightness_ = brightness; }
+    uint8_t getBrightness() const { return brightness_; }
+    void setDither(uint8_t dither) { dither_ = dither; }
+
+    // Host only: what the last show() sent
+    uint32_t getShowCount() const { return shows_; }
+    const CRGB* getShownLeds() const { return shownLeds_; }
+    int getShownCount() const { return shownCount_; }
+    CLEDController& getController() { return controller_; }
+
+private:
+    CLEDController controller_;
+    uint8_t brightness_;
+    uint8_t dither_;
+    uint32_t shows_;
+    const CRGB* shownLeds_;
+    int shownCount_;
+};
+
+extern CFastLED FastLED;
@@ -0,0 +1,14 @@
+#pragma once
+
+// Host stand-in for the Logger library: lines go to stdout unless the
+// test run is quiet (see host.h)
+
+class LoggerClass {
+public:
+    void debug(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    void info(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    void warning(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    void error(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern LoggerClass Logger;
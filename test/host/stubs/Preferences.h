@@ -0,0 +1,98 @@
+#pragma once
+
+// Host stand-in for the ESP32 NVS Preferences: an in-memory store shared
+// by every instance, so what one object writes the next one reads.
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences {
+public:
+    Preferences() : open_(false), readOnly_(false) {}
+
+    bool begin(const char* name, bool readOnly = false) {
+        name_ = name;
+        readOnly_ = readOnly;
+        open_ = true;
+        return true;
+    }
+
+    void end() { open_ = false; }
+
+    bool isKey(const char* key) { return open_ && store().count(path(key)) > 0; }
+
+    bool remove(const char* key) {
+        return open_ && !readOnly_ && store().erase(path(key)) > 0;
+    }
+
+    bool clear() {
+        if (!open_ || readOnly_) {
+            return false;
+        }
+        std::string prefix = name_ + "/";
+        for (Store::iterator it = store().begin(); it != store().end();) {
+            it = it->first.compare(0, prefix.size(), prefix) == 0 ? store().erase(it) : ++it;
+        }
+        return true;
+    }
+
+    size_t getBytesLength(const char* key) {
+        Store::const_iterator it = store().find(path(key));
+        return open_ && it != store().end() ? it->second.size() : 0;
+    }
+
+    size_t getBytes(const char* key, void* buffer, size_t length) {
+        Store::const_iterator it = store().find(path(key));
+        if (!open_ || it == store().end() || it->second.size() > length) {
+            return 0;
+        }
+        memcpy(buffer, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+    size_t putBytes(const char* key, const void* value, size_t length) {
+        if (!open_ || readOnly_) {
+            return 0;
+        }
+        const uint8_t* bytes = (const uint8_t*)value;
+        store()[path(key)].assign(bytes, bytes + length);
+        return length;
+    }
+
+    int32_t getInt(const char* key, int32_t value = 0) { return get(key, value); }
+    uint32_t getUInt(const char* key, uint32_t value = 0) { return get(key, value); }
+    uint8_t getUChar(const char* key, uint8_t value = 0) { return get(key, value); }
+    bool getBool(const char* key, bool value = false) { return get(key, value); }
+
+    size_t putInt(const char* key, int32_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putUChar(const char* key, uint8_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putBool(const char* key, bool value) { return putBytes(key, &value, sizeof(value)); }
+
+    /**
+     * @brief Host only: forget every namespace
+     */
+    static void eraseAll() { store().clear(); }
+
+private:
+    typedef std::map<std::string, std::vector<uint8_t> > Store;
+
+    std::string name_;
+    bool open_;
+    bool readOnly_;
+
+    static Store& store() {
+        static Store values;
+        return values;
+    }
+
+    std::string path(const char* key) const { return name_ + "/" + key; }
+
+    template <typename T>
+    T get(const char* key, T value) {
+        T stored;
+        return getBytesLength(key) == sizeof(T) && getBytes(key, &stored, sizeof(T)) ? stored : value;
+    }
+};
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in: no RTC memory, the attribute is dropped
+#define RTC_NOINIT_ATTR
+#define IRAM_ATTR
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+// Host stand-in for the ROM CRC32 (IEEE 802.3, little-endian, same results)
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stand-in: every start is a power-on unless a test says otherwise
+
+typedef enum {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC
+} esp_reset_reason_t;
+
+esp_reset_reason_t esp_reset_reason(void);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Host stand-in for the few LVGL calls BootProfiler makes: LVGL is never
+// initialised on the host
+
+typedef struct {
+    uint32_t total_size;
+    uint32_t free_size;
+} lv_mem_monitor_t;
+
+inline bool lv_is_initialized(void) { return false; }
+inline void lv_mem_monitor(lv_mem_monitor_t* mon) { mon->total_size = 0; mon->free_size = 0; }
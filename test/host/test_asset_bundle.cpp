@@ -0,0 +1,185 @@
+// AssetBundle::Reader: open a bundle laid out the way
+// scripts/build_web_assets.py writes it, and reject damaged ones. Each
+// corruption past the checksum recomputes it, so the check under test is
+// the one that fails.
+
+#include "check.h"
+#include "AssetBundle.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+using AssetBundle::Entry;
+using AssetBundle::Header;
+
+struct File {
+    const char* path;
+    const char* type;
+    std::string gz;     ///< Stands in for the gzipped contents
+};
+
+static const uint32_t BUILD = 0x5eed1d01;
+
+static size_t align4(size_t n) {
+    return (n + 3) & ~(size_t)3;
+}
+
+static std::vector<uint8_t> buildBundle(const std::vector<File>& files) {
+    size_t indexEnd = sizeof(Header) + files.size() * sizeof(Entry);
+    size_t size = indexEnd;
+    for (size_t i = 0; i < files.size(); i++) {
+        size += align4(files[i].gz.size());
+    }
+
+    std::vector<uint8_t> bundle(size, 0);
+    size_t offset = indexEnd;
+    for (size_t i = 0; i < files.size(); i++) {
+        Entry entry;
+        memset(&entry, 0, sizeof(entry));
+        strncpy(entry.path, files[i].path, sizeof(entry.path) - 1);
+        strncpy(entry.type, files[i].type, sizeof(entry.type) - 1);
+        memcpy(entry.etag, "0123456789abcdef", sizeof(entry.etag));
+        entry.offset = offset;
+        entry.size = files[i].gz.size() * 3;
+        entry.gzSize = files[i].gz.size();
+        entry.flags = AssetBundle::FLAG_IMMUTABLE;
+        memcpy(&bundle[sizeof(Header) + i * sizeof(Entry)], &entry, sizeof(entry));
+        memcpy(&bundle[offset], files[i].gz.data(), files[i].gz.size());
+        offset += align4(files[i].gz.size());
+    }
+
+    Header header;
+    header.magic = AssetBundle::MAGIC;
+    header.version = AssetBundle::VERSION;
+    header.count = files.size();
+    header.size = size;
+    header.checksum = AssetBundle::checksum(&bundle[sizeof(Header)], size - sizeof(Header));
+    header.build = BUILD;
+    memcpy(&bundle[0], &header, sizeof(header));
+    return bundle;
+}
+
+static std::vector<File> sampleFiles() {
+    std::vector<File> files;
+    files.push_back(File{ "/index.html", "text/html", std::string("\x1f\x8b index", 8) });
+    files.push_back(File{ "/script.js", "application/javascript", "script body, not aligned" });
+    files.push_back(File{ "/style.css", "text/css", "css" });
+    return files;
+}
+
+static Entry* entryAt(std::vector<uint8_t>& bundle, size_t index) {
+    return (Entry*)&bundle[sizeof(Header) + index * sizeof(Entry)];
+}
+
+static void resign(std::vector<uint8_t>& bundle) {
+    Header* header = (Header*)&bundle[0];
+    header->checksum = AssetBundle::checksum(&bundle[sizeof(Header)], header->size - sizeof(Header));
+}
+
+static void testRoundTrip() {
+    std::vector<File> files = sampleFiles();
+    std::vector<uint8_t> bundle = buildBundle(files);
+    AssetBundle::Reader reader;
+    CHECK(reader.open(bundle.data(), bundle.size()));
+    CHECK_EQ(reader.count(), files.size());
+    CHECK_EQ(reader.build(), BUILD);
+
+    for (size_t i = 0; i < files.size(); i++) {
+        const Entry* entry = reader.find(files[i].path);
+        CHECK(entry != nullptr);
+        if (!entry) {
+            continue;
+        }
+        CHECK(entry == reader.entry(i));
+        CHECK(strcmp(entry->type, files[i].type) == 0);
+        CHECK_EQ(entry->gzSize, files[i].gz.size());
+        CHECK_EQ(entry->offset % 4, 0);
+        CHECK(memcmp(reader.data(*entry), files[i].gz.data(), entry->gzSize) == 0);
+    }
+    CHECK(reader.find("/missing.html") == nullptr);
+    CHECK(reader.entry(files.size()) == nullptr);
+
+    // A partition is larger than the bundle it holds
+    std::vector<uint8_t> partition(bundle);
+    partition.resize(bundle.size() + 4096, 0xFF);
+    CHECK(reader.open(partition.data(), partition.size()));
+
+    std::vector<uint8_t> empty = buildBundle(std::vector<File>());
+    CHECK(reader.open(empty.data(), empty.size()));
+    CHECK_EQ(reader.count(), 0);
+
+    // A bundle from before build ids is never used
+    std::vector<uint8_t> old(bundle);
+    ((Header*)&old[0])->version = 1;
+    CHECK(!reader.open(old.data(), old.size()));
+    CHECK_EQ(reader.build(), 0);
+}
+
+static void testCorruptByte() {
+    std::vector<uint8_t> bundle = buildBundle(sampleFiles());
+    AssetBundle::Reader reader;
+    for (size_t i = sizeof(Header); i < bundle.size(); i += 37) {
+        std::vector<uint8_t> corrupt(bundle);
+        corrupt[i] ^= 0x40;
+        CHECK(!reader.open(corrupt.data(), corrupt.size()));
+        CHECK_EQ(reader.count(), 0);
+        CHECK(reader.find("/index.html") == nullptr);
+    }
+
+    std::vector<uint8_t> badMagic(bundle);
+    badMagic[0] ^= 1;
+    CHECK(!reader.open(badMagic.data(), badMagic.size()));
+    CHECK(!reader.open(nullptr, bundle.size()));
+}
+
+static void testTruncated() {
+    std::vector<uint8_t> bundle = buildBundle(sampleFiles());
+    AssetBundle::Reader reader;
+    CHECK(!reader.open(bundle.data(), bundle.size() - 1));
+    CHECK(!reader.open(bundle.data(), sizeof(Header) - 1));
+
+    // A header whose size doesn't even cover its own index
+    std::vector<uint8_t> shortIndex(bundle);
+    ((Header*)&shortIndex[0])->size = sizeof(Header) + sizeof(Entry);
+    resign(shortIndex);
+    CHECK(!reader.open(shortIndex.data(), shortIndex.size()));
+}
+
+static void testEntryOutOfBounds() {
+    std::vector<uint8_t> bundle = buildBundle(sampleFiles());
+    uint32_t size = ((Header*)&bundle[0])->size;
+    AssetBundle::Reader reader;
+
+    std::vector<uint8_t> pastEnd(bundle);
+    entryAt(pastEnd, 1)->offset = size + 4;
+    resign(pastEnd);
+    CHECK(!reader.open(pastEnd.data(), pastEnd.size()));
+
+    std::vector<uint8_t> intoIndex(bundle);
+    entryAt(intoIndex, 0)->offset = sizeof(Header);
+    resign(intoIndex);
+    CHECK(!reader.open(intoIndex.data(), intoIndex.size()));
+
+    std::vector<uint8_t> overrun(bundle);
+    entryAt(overrun, 2)->gzSize = size - entryAt(overrun, 2)->offset + 1;
+    resign(overrun);
+    CHECK(!reader.open(overrun.data(), overrun.size()));
+
+    std::vector<uint8_t> unterminated(bundle);
+    memset(entryAt(unterminated, 0)->path, 'a', sizeof(Entry().path));
+    resign(unterminated);
+    CHECK(!reader.open(unterminated.data(), unterminated.size()));
+
+    // Re-signing alone leaves a valid bundle - the checks above are what failed
+    std::vector<uint8_t> resigned(bundle);
+    resign(resigned);
+    CHECK(reader.open(resigned.data(), resigned.size()));
+}
+
+int main() {
+    RUN(testRoundTrip);
+    RUN(testCorruptByte);
+    RUN(testTruncated);
+    RUN(testEntryOutOfBounds);
+    return checkResult();
+}
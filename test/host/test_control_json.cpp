@@ -0,0 +1,159 @@
+// ControlJson: PATCH /api/state bodies and WebSocket control messages,
+// decoded the way WebUIManager::handleStatePatch() does it - parsed into
+// an arena-backed document, decoded, posted to the ControlQueue - with
+// the HTTP request replaced by the status code the handler would send.
+
+#include "check.h"
+#include "host.h"
+#include "ControlJson.h"
+#include "ControlQueue.h"
+#include "JsonArena.h"
+
+static JsonArena s_arena;
+static ControlQueue s_queue;
+static uint8_t s_currentAnimation = 3;
+
+/**
+ * @brief Run a PATCH /api/state body through the handler's path
+ * @return The status the handler responds with
+ */
+static int patchState(const char* body) {
+    JsonDocument state(&s_arena);
+    DeserializationError error = deserializeJson(state, body, strlen(body));
+
+    ControlProtocol::Control controls[ControlQueue::SLOT_COUNT];
+    uint8_t count = 0;
+    if (error || !state.is<JsonObjectConst>() ||
+        !ControlJson::decodeState(state, s_currentAnimation, controls, count)) {
+        return 400;
+    }
+    s_queue.post(controls, count);
+    return 200;
+}
+
+static void testStateFields() {
+    ControlProtocol::Control out[ControlQueue::SLOT_COUNT];
+    CHECK_EQ(patchState("{\"brightness\":300,\"white\":true,\"colour\":\"#0a0B0c\"}"), 200);
+    CHECK_EQ(s_queue.drain(out), 3);
+    CHECK_EQ(out[0].opcode, ControlProtocol::OP_COLOUR);
+    CHECK_EQ(out[0].payload[0], 0x0a);
+    CHECK_EQ(out[0].payload[1], 0x0b);
+    CHECK_EQ(out[0].payload[2], 0x0c);
+    CHECK_EQ(out[1].opcode, ControlProtocol::OP_WHITE);
+    CHECK_EQ(out[1].payload[0], 1);
+    CHECK_EQ(out[2].opcode, ControlProtocol::OP_BRIGHTNESS);
+    CHECK_EQ(out[2].payload[0], 255);
+
+    CHECK_EQ(patchState("{}"), 400);
+    CHECK_EQ(patchState("[1]"), 400);
+    CHECK_EQ(patchState("{\"vu\":1}"), 400);
+    CHECK_EQ(patchState("{\"brightness\":\"80\"}"), 400);
+    CHECK_EQ(s_queue.drain(out), 0);
+}
+
+static void testAnimation() {
+    ControlProtocol::Control out[ControlQueue::SLOT_COUNT];
+
+    CHECK_EQ(patchState("{\"animation\":14}"), 200);
+    CHECK_EQ(s_queue.drain(out), 1);
+    CHECK_EQ(out[0].payload[0], 1);
+    CHECK_EQ(out[0].payload[1], 14);
+
+    CHECK_EQ(patchState("{\"animation\":false}"), 200);
+    CHECK_EQ(s_queue.drain(out), 1);
+    CHECK_EQ(out[0].payload[0], 0);
+    CHECK_EQ(out[0].payload[1], s_currentAnimation);
+
+    CHECK_EQ(patchState("{\"animation\":{\"index\":2}}"), 200);
+    CHECK_EQ(s_queue.drain(out), 1);
+    CHECK_EQ(out[0].payload[0], 1);
+    CHECK_EQ(out[0].payload[1], 2);
+
+    CHECK_EQ(patchState("{\"animation\":{\"state\":false}}"), 200);
+    CHECK_EQ(s_queue.drain(out), 1);
+    CHECK_EQ(out[0].payload[0], 0);
+    CHECK_EQ(out[0].payload[1], s_currentAnimation);
+
+    CHECK_EQ(patchState("{\"animation\":15}"), 400);
+    CHECK_EQ(patchState("{\"animation\":99}"), 400);
+    CHECK_EQ(patchState("{\"animation\":300}"), 400);      // Used to wrap to 44
+    CHECK_EQ(patchState("{\"animation\":-1}"), 400);
+    CHECK_EQ(patchState("{\"animation\":2.5}"), 400);
+    CHECK_EQ(patchState("{\"animation\":{\"index\":99}}"), 400);
+    CHECK_EQ(patchState("{\"animation\":{\"state\":\"off\"}}"), 400);
+    CHECK_EQ(patchState("{\"animation\":{\"state\":0}}"), 400);
+    CHECK_EQ(patchState("{\"animation\":\"fire\"}"), 400);
+    CHECK_EQ(s_queue.drain(out), 0);
+}
+
+static void testColour() {
+    ControlProtocol::Control control;
+    CHECK(ControlJson::decodeColour("#FFa500", control));
+    CHECK_EQ(control.payload[0], 0xFF);
+    CHECK_EQ(control.payload[1], 0xA5);
+    CHECK_EQ(control.payload[2], 0x00);
+    CHECK(ControlJson::decodeColour("000001", control));
+    CHECK_EQ(control.payload[2], 1);
+
+    CHECK(!ControlJson::decodeColour(nullptr, control));
+    CHECK(!ControlJson::decodeColour("", control));
+    CHECK(!ControlJson::decodeColour("#", control));
+    CHECK(!ControlJson::decodeColour(" 12345", control));   // strtoul skipped the space
+    CHECK(!ControlJson::decodeColour("-00001", control));   // ... and took the sign
+    CHECK(!ControlJson::decodeColour("+12345", control));
+    CHECK(!ControlJson::decodeColour("0x1234", control));
+    CHECK(!ControlJson::decodeColour("12345", control));
+    CHECK(!ControlJson::decodeColour("1234567", control));
+    CHECK(!ControlJson::decodeColour("12345g", control));
+    CHECK(!ControlJson::decodeColour("##123456", control));
+
+    CHECK_EQ(patchState("{\"colour\":\" 12345\"}"), 400);
+    CHECK_EQ(patchState("{\"colour\":\"-00001\"}"), 400);
+    CHECK_EQ(patchState("{\"colour\":123456}"), 400);
+}
+
+static void testWebSocketControls() {
+    JsonDocument request(&s_arena);
+    ControlProtocol::Control control;
+
+    deserializeJson(request, "{\"message\":\"animation\",\"value\":true,\"animation\":7}");
+    CHECK(ControlJson::decodeControl(ControlJson::hashMessageType(request["message"]), request, control));
+    CHECK_EQ(control.opcode, ControlProtocol::OP_ANIMATION);
+    CHECK_EQ(control.payload[1], 7);
+
+    // What the web UI sends to stop animations
+    deserializeJson(request, "{\"message\":\"animation\",\"value\":false}");
+    CHECK(ControlJson::decodeControl(ControlJson::hashMessageType(request["message"]), request, control));
+    CHECK_EQ(control.payload[0], 0);
+
+    deserializeJson(request, "{\"message\":\"animation\",\"value\":true,\"animation\":300}");
+    CHECK(!ControlJson::decodeControl(ControlJson::hashMessageType(request["message"]), request, control));
+
+    deserializeJson(request, "{\"message\":\"colour\",\"value\":\"-00001\"}");
+    CHECK(!ControlJson::decodeControl(ControlJson::hashMessageType(request["message"]), request, control));
+
+    deserializeJson(request, "{\"message\":\"brightness\",\"value\":-5}");
+    CHECK(ControlJson::decodeControl(ControlJson::hashMessageType(request["message"]), request, control));
+    CHECK_EQ(control.payload[0], 0);
+
+    deserializeJson(request, "{\"message\":\"reboot\"}");
+    CHECK(!ControlJson::decodeControl(ControlJson::hashMessageType(request["message"]), request, control));
+}
+
+static void testBinaryAnimationRange() {
+    ControlProtocol::Control control;
+    const uint8_t valid[] = { ControlProtocol::OP_ANIMATION, 1, ControlProtocol::ANIMATION_COUNT - 1, 0 };
+    const uint8_t invalid[] = { ControlProtocol::OP_ANIMATION, 1, ControlProtocol::ANIMATION_COUNT, 0 };
+    CHECK(ControlProtocol::decode(valid, sizeof(valid), control));
+    CHECK(!ControlProtocol::decode(invalid, sizeof(invalid), control));
+}
+
+int main() {
+    hostSetQuiet(true);
+    RUN(testStateFields);
+    RUN(testAnimation);
+    RUN(testColour);
+    RUN(testWebSocketControls);
+    RUN(testBinaryAnimationRange);
+    return checkResult();
+}
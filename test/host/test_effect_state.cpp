@@ -0,0 +1,100 @@
+// Effect state is per instance: the same stateful effect (comet) running
+// as a layer, or on several runs of strips between zones, must draw
+// exactly what a lone instance draws.
+
+#include "check.h"
+#include "host.h"
+#include "LEDManager.h"
+#include <vector>
+
+static const int FRAMES = 40;
+
+static void bootConfig(int numStrips, int ledsPerStrip) {
+    Preferences::eraseAll();
+    Preferences prefs;
+    prefs.begin("led-config", false);
+    prefs.putInt("num_strips", numStrips);
+    prefs.putInt("leds_per_strip", ledsPerStrip);
+    prefs.end();
+}
+
+/**
+ * @brief Effect frames (leds_, before layers and output) of a fresh manager
+ * @param setup Adds layers or zones before the first frame
+ */
+template <typename Setup>
+static std::vector<CRGB> runComet(int numStrips, int ledsPerStrip, Setup setup) {
+    bootConfig(numStrips, ledsPerStrip);
+    LEDManager leds;
+    g_ledManager = &leds;
+    CHECK(leds.initialize());
+    leds.setCurrentAnimation(LEDManager::COMET);
+    leds.setAnimationEnabled(true);
+    setup(leds);
+
+    for (int i = 0; i < FRAMES; i++) {
+        hostAdvanceMs(50);
+        leds.update();
+    }
+    const CRGB* effect = FastLED.getController().leds();
+    std::vector<CRGB> frame(effect, effect + leds.getTotalLeds());
+    g_ledManager = nullptr;
+    return frame;
+}
+
+static void noSetup(LEDManager&) {}
+
+static bool lit(const std::vector<CRGB>& frame) {
+    for (size_t i = 0; i < frame.size(); i++) {
+        if (frame[i] != CRGB(CRGB::Black)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void testLayerDoesNotStepMainEffect() {
+    std::vector<CRGB> alone = runComet(4, 40, noSetup);
+    std::vector<CRGB> layered = runComet(4, 40, [](LEDManager& leds) {
+        LayerCompositor::Layer layers[2] = {
+            { LEDManager::COMET, LayerCompositor::BLEND_ADD, 255 },
+            { LEDManager::RIPPLE, LayerCompositor::BLEND_MAX, 128 },
+        };
+        CHECK(leds.setLayers(layers, 2));
+    });
+    CHECK(lit(alone));
+    CHECK(alone == layered);
+}
+
+static void testRunsStepOncePerFrame() {
+    // Strip 1 is an idle zone, leaving runs {0} and {2, 3} to the main effect
+    std::vector<CRGB> zoned = runComet(4, 40, [](LEDManager& leds) {
+        LedZones::Zone zone;
+        memset(&zone, 0, sizeof(zone));
+        strcpy(zone.name, "gap");
+        zone.firstStrip = 1;
+        zone.stripCount = 1;
+        zone.effect = LedZones::EFFECT_OFF;
+        zone.brightness = 255;
+        zone.audioBand = LedZones::AUDIO_SPREAD;
+        CHECK(leds.setZones(&zone, 1));
+    });
+
+    // Each run draws what a lone layout of its strips would (same wiring
+    // parity: runs start on even strips)
+    std::vector<CRGB> one = runComet(1, 40, noSetup);
+    std::vector<CRGB> two = runComet(2, 40, noSetup);
+    CHECK(lit(one));
+    CHECK(std::equal(one.begin(), one.end(), zoned.begin()));
+    CHECK(std::equal(two.begin(), two.end(), zoned.begin() + 2 * 40));
+
+    std::vector<CRGB> gap(zoned.begin() + 40, zoned.begin() + 2 * 40);
+    CHECK(!lit(gap));
+}
+
+int main() {
+    hostSetQuiet(true);
+    RUN(testLayerDoesNotStepMainEffect);
+    RUN(testRunsStepOncePerFrame);
+    return checkResult();
+}
@@ -0,0 +1,217 @@
+// LEDManager::requestReconfigure(): shrinking, growing and repeating
+// layouts in place. Every buffer sized by the layout - the effect,
+// published and transmit frames, the layer buffers, the dither error and
+// the frame stream baselines - must follow the new layout, and a layout
+// larger than the boot capacity must leave everything as it was. Built
+// with AddressSanitizer, so an access past a buffer fails the test too.
+
+#include "check.h"
+#include "host.h"
+#include "LEDManager.h"
+#include "FrameStreamer.h"
+
+static const int BOOT_STRIPS = 4;
+static const int BOOT_LEDS_PER_STRIP = 30;
+static const uint32_t CLIENT_ID = 1;
+
+static AsyncWebSocket s_webSocket("/ws");
+
+static void bootConfig(int numStrips, int ledsPerStrip) {
+    Preferences::eraseAll();
+    Preferences prefs;
+    prefs.begin("led-config", false);
+    prefs.putInt("num_strips", numStrips);
+    prefs.putInt("leds_per_strip", ledsPerStrip);
+    prefs.end();
+}
+
+/**
+ * @brief Run a few frames and stream them
+ * @param frameMs Simulated time per frame - 0 runs flat out, which turns
+ *        dithering on
+ */
+static void runFrames(LEDManager& leds, FrameStreamer& streamer, int frames = 3, unsigned long frameMs = 50) {
+    for (int i = 0; i < frames; i++) {
+        hostAdvanceMs(frameMs);
+        leds.update();
+        streamer.update();
+        s_webSocket.client(CLIENT_ID)->drain();
+    }
+}
+
+/**
+ * @brief The published frame is the effect with the layers blended over
+ */
+static void checkPublished(const LEDManager& leds) {
+    int total = leds.getTotalLeds();
+    const CRGB* effect = FastLED.getController().leds();
+    CHECK_EQ(FastLED.getController().size(), total);
+
+    std::vector<CRGB> expected(effect, effect + total);
+    const LayerCompositor& compositor = leds.getCompositor();
+    for (uint8_t i = 0; i < compositor.getLayerCount(); i++) {
+        const LayerCompositor::ActiveLayer& layer = compositor.getLayer(i);
+        LayerCompositor::blend(expected.data(), layer.buffer, total,
+                               (LayerCompositor::BlendMode)layer.layer.blend, layer.layer.opacity);
+    }
+    CHECK(leds.getFrame() != nullptr);
+    CHECK(memcmp(leds.getFrame(), expected.data(), sizeof(CRGB) * total) == 0);
+}
+
+/**
+ * @brief The transmit buffer was shown with the layout's length
+ */
+static void checkOutput(const LEDManager& leds) {
+    CHECK_EQ(FastLED.getShownCount(), leds.getTotalLeds());
+    CHECK(FastLED.getShownLeds() != FastLED.getController().leds());
+    CHECK(FastLED.getShownLeds() != leds.getFrame());
+    CHECK_EQ(leds.getOutputStage().getStats().pixels, leds.getTotalLeds());
+}
+
+/**
+ * @brief The last frame streamed is a keyframe of the whole new layout
+ */
+static void checkStreamedKeyframe(const LEDManager& leds) {
+    AsyncWebSocketClient* client = s_webSocket.client(CLIENT_ID);
+    const AsyncWebSocketSharedBuffer& message = client->getLastMessage();
+    CHECK(message != nullptr);
+    if (!message) {
+        return;
+    }
+    const uint8_t* data = message->data();
+    uint16_t cols = data[2] | (data[3] << 8);
+    uint16_t rows = data[4] | (data[5] << 8);
+    CHECK_EQ(data[0], ControlProtocol::MSG_FRAME);
+    CHECK_EQ(cols, leds.getLedsPerStrip());
+    CHECK_EQ(rows, leds.getNumStrips());
+    CHECK_EQ(message->size(), ControlProtocol::FRAME_HEADER_SIZE + ControlProtocol::FRAME_RUN_HEADER_SIZE +
+                              (size_t)cols * rows * 3);
+
+    const uint8_t* pixels = data + ControlProtocol::FRAME_HEADER_SIZE + ControlProtocol::FRAME_RUN_HEADER_SIZE;
+    bool match = true;
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            const CRGB& led = leds.getFrame()[leds.xyToIndex(x, y)];
+            const uint8_t* sent = pixels + (y * cols + x) * 3;
+            match = match && sent[0] == led.r && sent[1] == led.g && sent[2] == led.b;
+        }
+    }
+    CHECK(match);
+}
+
+static void testShrinkGrowRepeat() {
+    bootConfig(BOOT_STRIPS, BOOT_LEDS_PER_STRIP);
+    LEDManager leds;
+    g_ledManager = &leds;
+    CHECK(leds.initialize());
+    leds.setBrightness(100);
+    leds.setCurrentAnimation(LEDManager::SPARKLE);
+    leds.setAnimationEnabled(true);
+
+    LayerCompositor::Layer layer = { LEDManager::CONFETTI, LayerCompositor::BLEND_SCREEN, 160 };
+    CHECK(leds.setLayers(&layer, 1));
+
+    FrameStreamer streamer(&s_webSocket);
+    s_webSocket.connect(CLIENT_ID);
+    CHECK(streamer.subscribe(CLIENT_ID, FrameStreamer::MAX_FPS, 1));
+    runFrames(leds, streamer);
+    CHECK_EQ(leds.getCompositor().getLayerCount(), 1);
+    const CRGB* layerBuffer = leds.getCompositor().getLayer(0).buffer;
+
+    static const struct {
+        int numStrips;
+        int ledsPerStrip;
+    } LAYOUTS[] = {
+        { 2, 10 },      // Shrink
+        { 4, 30 },      // Back to the boot capacity
+        { 3, 7 },
+        { 1, 120 },     // Same LED count, different shape
+        { 1, 120 },     // Repeated - nothing to do
+        { 5, 24 },
+        { 2, 10 },
+    };
+
+    for (size_t i = 0; i < sizeof(LAYOUTS) / sizeof(LAYOUTS[0]); i++) {
+        uint32_t version = leds.getGeometryVersion();
+        bool repeat = LAYOUTS[i].numStrips == leds.getNumStrips() &&
+                      LAYOUTS[i].ledsPerStrip == leds.getLedsPerStrip();
+        uint32_t framesBefore = s_webSocket.client(CLIENT_ID)->getMessageCount();
+
+        CHECK(leds.requestReconfigure(LAYOUTS[i].numStrips, LAYOUTS[i].ledsPerStrip));
+        runFrames(leds, streamer, 1);
+        CHECK_EQ(leds.getNumStrips(), LAYOUTS[i].numStrips);
+        CHECK_EQ(leds.getLedsPerStrip(), LAYOUTS[i].ledsPerStrip);
+        CHECK_EQ(leds.getTotalLeds(), LAYOUTS[i].numStrips * LAYOUTS[i].ledsPerStrip);
+        CHECK_EQ(leds.getGeometryVersion(), repeat ? version : version + 1);
+
+        // Layers keep their pool slice, now used for the new layout
+        CHECK_EQ(leds.getCompositor().getLayerCount(), 1);
+        CHECK(leds.getCompositor().getLayer(0).buffer == layerBuffer);
+
+        checkPublished(leds);
+        checkOutput(leds);
+        if (!repeat) {
+            CHECK(s_webSocket.client(CLIENT_ID)->getMessageCount() == framesBefore + 1);
+            checkStreamedKeyframe(leds);
+        }
+
+        runFrames(leds, streamer, 50, 0);
+        CHECK(leds.getOutputStage().getStats().dithering);
+        checkPublished(leds);
+        checkOutput(leds);
+    }
+
+    s_webSocket.client(CLIENT_ID)->disconnect();
+    g_ledManager = nullptr;
+}
+
+static void testRejectedLayoutLeavesStateUnchanged() {
+    bootConfig(BOOT_STRIPS, BOOT_LEDS_PER_STRIP);
+    LEDManager leds;
+    g_ledManager = &leds;
+    CHECK(leds.initialize());
+    leds.setCurrentAnimation(LEDManager::RAINBOW);
+    leds.setAnimationEnabled(true);
+
+    FrameStreamer streamer(&s_webSocket);
+    s_webSocket.connect(CLIENT_ID);
+    CHECK(streamer.subscribe(CLIENT_ID, FrameStreamer::MAX_FPS, 1));
+    CHECK(leds.requestReconfigure(2, 15));
+    runFrames(leds, streamer);
+
+    const CRGB* frame = leds.getFrame();
+    const CRGB* effect = FastLED.getController().leds();
+    uint32_t version = leds.getGeometryVersion();
+    int capacity = BOOT_STRIPS * BOOT_LEDS_PER_STRIP;
+
+    CHECK(!leds.requestReconfigure(BOOT_STRIPS + 1, BOOT_LEDS_PER_STRIP));
+    CHECK(!leds.requestReconfigure(1, capacity + 1));
+    CHECK(!leds.requestReconfigure(0, 10));
+    CHECK(!leds.requestReconfigure(10, -1));
+    runFrames(leds, streamer);
+
+    CHECK_EQ(leds.getNumStrips(), 2);
+    CHECK_EQ(leds.getLedsPerStrip(), 15);
+    CHECK_EQ(leds.getGeometryVersion(), version);
+    CHECK(leds.getFrame() == frame);
+    CHECK(FastLED.getController().leds() == effect);
+    checkPublished(leds);
+    checkOutput(leds);
+
+    // A rejected request doesn't cancel one already accepted
+    CHECK(leds.requestReconfigure(3, 10));
+    CHECK(!leds.requestReconfigure(BOOT_STRIPS, BOOT_LEDS_PER_STRIP + 1));
+    runFrames(leds, streamer);
+    CHECK_EQ(leds.getTotalLeds(), 30);
+    checkStreamedKeyframe(leds);
+
+    s_webSocket.client(CLIENT_ID)->disconnect();
+    g_ledManager = nullptr;
+}
+
+int main() {
+    hostSetQuiet(true);
+    RUN(testShrinkGrowRepeat);
+    RUN(testRejectedLayoutLeavesStateUnchanged);
+    return checkResult();
+}
@@ -0,0 +1,92 @@
+// Metrics histograms: which bucket an observation lands in (bounds are
+// inclusive, like Prometheus "le"), and the count and sum beside them.
+
+#include "check.h"
+#include "host.h"
+#include "Metrics.h"
+
+static const uint32_t CYCLES_PER_US = 1000;     ///< Host "cycles" are nanoseconds
+
+static int bucketOf(const Metrics::HistogramData& histogram) {
+    for (int i = 0; i < Metrics::BUCKET_COUNT; i++) {
+        if (histogram.buckets[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Bucket a single observation of us microseconds lands in
+ */
+static int observeOnce(uint32_t us) {
+    Metrics metrics;
+    metrics.observe(Metrics::LOOP, us * CYCLES_PER_US);
+    const Metrics::HistogramData& histogram = metrics.getHistogram(Metrics::LOOP);
+    CHECK_EQ(histogram.count, 1);
+    CHECK_EQ(histogram.sumUs, us);
+    return bucketOf(histogram);
+}
+
+static void testBucketPlacement() {
+    CHECK_EQ(observeOnce(0), 0);
+    for (int i = 0; i < Metrics::BUCKET_COUNT - 1; i++) {
+        uint32_t bound = Metrics::BUCKET_BOUNDS_US[i];
+        CHECK_EQ(observeOnce(bound), i);
+        CHECK_EQ(observeOnce(bound + 1), i + 1);
+    }
+    // Everything past the last bound is +Inf
+    CHECK_EQ(observeOnce(0xFFFFFFFF / CYCLES_PER_US), Metrics::BUCKET_COUNT - 1);
+    // Part of a microsecond is dropped, not rounded up into the next bucket
+    Metrics metrics;
+    metrics.observe(Metrics::LED_SHOW, 50 * CYCLES_PER_US + CYCLES_PER_US - 1);
+    CHECK_EQ(metrics.getHistogram(Metrics::LED_SHOW).buckets[0], 1);
+}
+
+static void testCountAndSum() {
+    Metrics metrics;
+    const uint32_t durations[] = {10, 75, 75, 3000, 200000};
+    uint64_t sum = 0;
+    for (size_t i = 0; i < sizeof(durations) / sizeof(durations[0]); i++) {
+        metrics.observe(Metrics::LED_UPDATE, durations[i] * CYCLES_PER_US);
+        sum += durations[i];
+    }
+    const Metrics::HistogramData& histogram = metrics.getHistogram(Metrics::LED_UPDATE);
+    CHECK_EQ(histogram.count, 5);
+    CHECK_EQ(histogram.sumUs, sum);
+    CHECK_EQ(histogram.buckets[0], 1);     // 10
+    CHECK_EQ(histogram.buckets[1], 2);     // 75, 75
+    CHECK_EQ(histogram.buckets[6], 1);     // 3000
+    CHECK_EQ(histogram.buckets[Metrics::BUCKET_COUNT - 1], 1);
+    uint32_t total = 0;
+    for (int i = 0; i < Metrics::BUCKET_COUNT; i++) {
+        total += histogram.buckets[i];
+    }
+    CHECK_EQ(total, histogram.count);
+
+    // Other histograms are untouched
+    CHECK_EQ(metrics.getHistogram(Metrics::LOOP).count, 0);
+}
+
+static void testMacrosObserveGlobal() {
+    uint32_t before = g_metrics.getHistogram(Metrics::UI_UPDATE).count;
+    {
+        METRICS_SCOPE(UI_UPDATE);
+    }
+    METRICS_START(start);
+    METRICS_OBSERVE(UI_UPDATE, start);
+    CHECK_EQ(g_metrics.getHistogram(Metrics::UI_UPDATE).count, before + 2);
+
+    METRICS_GAUGE(WS_QUEUE_DEPTH, 7);
+    METRICS_GAUGE(WS_QUEUE_DEPTH, 3);
+    CHECK_EQ(g_metrics.getGauge(Metrics::WS_QUEUE_DEPTH).value, 3);
+    CHECK_EQ(g_metrics.getGauge(Metrics::WS_QUEUE_DEPTH).peak, 7);
+}
+
+int main() {
+    hostSetQuiet(true);
+    RUN(testBucketPlacement);
+    RUN(testCountAndSum);
+    RUN(testMacrosObserveGlobal);
+    return checkResult();
+}
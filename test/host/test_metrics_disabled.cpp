@@ -0,0 +1,43 @@
+// Built with METRICS_ENABLED=0: the macros expand to nothing, arguments
+// included, and neither Metrics nor g_metrics is declared - the
+// definitions below would clash with them otherwise.
+
+#if METRICS_ENABLED
+#error "build with -DMETRICS_ENABLED=0"
+#endif
+
+#include "check.h"
+#include "host.h"
+#include "Metrics.h"
+
+struct Metrics {};
+static int g_metrics = 0;
+static int s_evaluated = 0;
+
+// Only ever named in macro arguments, so unused when they are dropped
+uint32_t sideEffect() {
+    return ++s_evaluated;
+}
+
+static void testMacrosExpandToNothing() {
+    {
+        METRICS_SCOPE(NO_SUCH_HISTOGRAM);
+    }
+    METRICS_START(start);
+    METRICS_OBSERVE(NO_SUCH_HISTOGRAM, start);
+    METRICS_GAUGE(NO_SUCH_GAUGE, sideEffect());
+    // Macros stay single statements
+    if (s_evaluated)
+        METRICS_GAUGE(NO_SUCH_GAUGE, sideEffect());
+    else
+        METRICS_OBSERVE(NO_SUCH_HISTOGRAM, undeclared);
+    CHECK_EQ(s_evaluated, 0);
+    CHECK_EQ(g_metrics, 0);
+    CHECK_EQ(sizeof(Metrics), 1);
+}
+
+int main() {
+    hostSetQuiet(true);
+    RUN(testMacrosExpandToNothing);
+    return checkResult();
+}
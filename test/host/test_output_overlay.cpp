@@ -0,0 +1,130 @@
+// The overlay goes through the output stage's gamma like the effect does:
+// overlay pixels are gamma(colour) at LedOverlay::LEVEL whatever the
+// brightness, effect pixels gamma(colour) at the brightness.
+
+#include "check.h"
+#include "host.h"
+#include "LedOverlay.h"
+#include "OutputStage.h"
+#include <Preferences.h>
+#include <vector>
+
+static const int STRIPS = 2;
+static const int LEDS = 10;
+static const uint8_t GAMMA = 22;
+
+static void setGamma(OutputStage& stage) {
+    Preferences::eraseAll();
+    OutputStage::Settings settings = OutputStage::defaults();
+    settings.gamma = GAMMA;
+    settings.order = OutputStage::ORDER_RGB;
+    CHECK(stage.request(settings));
+}
+
+/**
+ * @brief Gamma first, then the level - what the LUT is meant to give
+ */
+static int expected(uint8_t value, uint8_t level) {
+    return (int)(powf(value / 255.0f, GAMMA / 10.0f) * 255.0f * (level + 1) / 256.0f);
+}
+
+static bool near(const CRGB& actual, const CRGB& colour, uint8_t level) {
+    for (int c = 0; c < 3; c++) {
+        if (abs(actual[c] - expected(colour[c], level)) > 1) {
+            printf("  channel %d: %d, expected %d\n", c, actual[c], expected(colour[c], level));
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testOverlayPixelsGetGammaAtOverlayLevel() {
+    const CRGB effect(200, 120, 60);
+    const uint8_t levels[] = {10, 128, 255};
+    for (size_t l = 0; l < sizeof(levels); l++) {
+        OutputStage stage;
+        setGamma(stage);
+        stage.prepare(levels[l]);
+
+        LedOverlay overlay;
+        overlay.flash(CRGB(255, 160, 40), 1, 1000);
+        std::vector<CRGB> frame(STRIPS * LEDS, effect);
+        CHECK(overlay.render(frame.data(), frame.data(), STRIPS, LEDS));
+
+        std::vector<CRGB> out(STRIPS * LEDS);
+        stage.render(out.data(), frame.data(), nullptr, STRIPS, LEDS, nullptr, &overlay);
+        for (int i = 0; i < STRIPS * LEDS; i++) {
+            CHECK(near(out[i], CRGB(255, 160, 40), LedOverlay::LEVEL));
+        }
+    }
+}
+
+static void testEffectAroundBarKeepsBrightness() {
+    const CRGB effect(200, 120, 60);
+    const uint8_t level = 64;
+    OutputStage stage;
+    setGamma(stage);
+    stage.prepare(level);
+
+    LedOverlay overlay;
+    overlay.showProgress(50);
+    std::vector<CRGB> frame(STRIPS * LEDS, effect);
+    std::vector<CRGB> drawn(STRIPS * LEDS);
+    CHECK(overlay.render(drawn.data(), frame.data(), STRIPS, LEDS));
+
+    std::vector<CRGB> out(STRIPS * LEDS);
+    stage.render(out.data(), drawn.data(), nullptr, STRIPS, LEDS, nullptr, &overlay);
+
+    for (int strip = 0; strip < STRIPS; strip++) {
+        int first, count;
+        overlay.getSpan(strip, LEDS, first, count);
+        CHECK_EQ(count, LEDS / 2);
+        // Even strips are wired reversed, so their bar ends at the last LED
+        CHECK_EQ(first, strip % 2 == 0 ? LEDS - count : 0);
+        for (int led = 0; led < LEDS; led++) {
+            int i = strip * LEDS + led;
+            if (led >= first && led < first + count) {
+                CHECK(drawn[i] != effect);
+                CHECK(near(out[i], drawn[i], LedOverlay::LEVEL));
+            } else {
+                CHECK(drawn[i] == effect);
+                CHECK(near(out[i], effect, level));
+            }
+        }
+    }
+}
+
+static void testFlashOffShowsEffect() {
+    OutputStage stage;
+    setGamma(stage);
+    stage.prepare(90);
+
+    LedOverlay overlay;
+    overlay.flash(CRGB::Red, 2, 100);
+    std::vector<CRGB> frame(STRIPS * LEDS, CRGB(30, 60, 90));
+    std::vector<CRGB> drawn(STRIPS * LEDS);
+    CHECK(overlay.render(drawn.data(), frame.data(), STRIPS, LEDS));
+    hostAdvanceMs(150);
+    CHECK(overlay.render(drawn.data(), frame.data(), STRIPS, LEDS));
+
+    int first, count;
+    overlay.getSpan(1, LEDS, first, count);
+    CHECK_EQ(count, 0);
+    std::vector<CRGB> out(STRIPS * LEDS);
+    stage.render(out.data(), drawn.data(), nullptr, STRIPS, LEDS, nullptr, &overlay);
+    for (int i = 0; i < STRIPS * LEDS; i++) {
+        CHECK(near(out[i], frame[i], 90));
+    }
+
+    hostAdvanceMs(300);
+    CHECK(!overlay.render(drawn.data(), frame.data(), STRIPS, LEDS));
+    CHECK(!overlay.isActive());
+}
+
+int main() {
+    hostSetQuiet(true);
+    RUN(testOverlayPixelsGetGammaAtOverlayLevel);
+    RUN(testEffectAroundBarKeepsBrightness);
+    RUN(testFlashOffShowsEffect);
+    return checkResult();
+}
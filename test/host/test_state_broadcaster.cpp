@@ -0,0 +1,150 @@
+// StateBroadcaster: a broadcast serializes one shared buffer that every
+// client's queue references, so heap allocations per broadcast don't grow
+// with the number of clients.
+
+#include "check.h"
+#include "host.h"
+#include "StateBroadcaster.h"
+#include "LEDManager.h"
+#include "ColourWheel.h"
+#include <new>
+
+// The control globals captureSnapshot() reads (LEDManager.cpp on the device)
+uint8_t brightness = 128;
+bool showAnimation = false;
+bool vu = false;
+bool white = false;
+LEDManager::AnimationType currentAnimation = LEDManager::RAINBOW;
+static ColourWheel s_colourWheel;
+ColourWheel* g_colourWheel = &s_colourWheel;
+
+static size_t s_allocations = 0;
+
+void* operator new(size_t size) {
+    s_allocations++;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+static const uint8_t CLIENTS = 6;
+static const int BROADCASTS = 50;
+
+/**
+ * @brief Change one control, wait out the interval and broadcast
+ */
+static void broadcastChange(StateBroadcaster& broadcaster, int i) {
+    brightness = (uint8_t)i;
+    broadcaster.markDirty();
+    hostAdvanceMs(StateBroadcaster::DEFAULT_INTERVAL_MS);
+    broadcaster.update();
+}
+
+/**
+ * @brief Heap allocations over BROADCASTS broadcasts to clientCount clients
+ */
+static size_t allocationsFor(uint8_t clientCount) {
+    AsyncWebSocket webSocket("/ws");
+    StateBroadcaster broadcaster(&webSocket);
+    for (uint8_t i = 0; i < clientCount; i++) {
+        webSocket.connect(i + 1);
+        broadcaster.addClient(i + 1);
+    }
+    broadcastChange(broadcaster, 0);  // Initial full state
+
+    size_t before = s_allocations;
+    for (int i = 1; i <= BROADCASTS; i++) {
+        broadcastChange(broadcaster, i);
+        for (uint8_t c = 0; c < clientCount; c++) {
+            webSocket.client(c + 1)->drain();  // Keep the queues from filling
+        }
+    }
+    return s_allocations - before;
+}
+
+static void testAllocationsIndependentOfClients() {
+    size_t one = allocationsFor(1);
+    size_t many = allocationsFor(CLIENTS);
+    CHECK_EQ(many, one);
+    // Control block + vector in one allocation, the JSON bytes in another
+    CHECK(one <= 2 * (size_t)BROADCASTS);
+}
+
+static void testClientsShareOneBuffer() {
+    AsyncWebSocket webSocket("/ws");
+    StateBroadcaster broadcaster(&webSocket);
+    for (uint8_t i = 0; i < CLIENTS; i++) {
+        webSocket.connect(i + 1);
+        broadcaster.addClient(i + 1);
+    }
+    broadcastChange(broadcaster, 1);
+    broadcastChange(broadcaster, 2);
+
+    const AsyncWebSocketSharedBuffer& first = webSocket.client(1)->getLastMessage();
+    CHECK(first != nullptr);
+    for (uint8_t i = 1; i < CLIENTS; i++) {
+        CHECK(webSocket.client(i + 1)->getLastMessage() == first);
+    }
+    CHECK_EQ(webSocket.client(1)->getMessageCount(), 2);
+
+    std::string delta(first->begin(), first->end());
+    CHECK(delta == "{\"message\":\"states\",\"controls\":[{\"name\":\"brightness\",\"state\":2}]}");
+
+    StateBroadcaster::Stats stats = broadcaster.getStats();
+    CHECK_EQ(stats.serialized, 2);
+    CHECK_EQ(stats.messagesSent, 2 * CLIENTS);
+    CHECK_EQ(stats.bytesSent, CLIENTS * (webSocket.client(1)->getBytes()));
+}
+
+static void testResyncReusesCachedFullState() {
+    AsyncWebSocket webSocket("/ws");
+    StateBroadcaster broadcaster(&webSocket);
+    webSocket.connect(1);
+    webSocket.connect(2);
+    broadcaster.addClient(1);
+    broadcaster.addClient(2);
+    broadcaster.requestFullState(1);
+    broadcaster.update();
+    broadcaster.requestFullState(2);
+    broadcaster.update();
+
+    CHECK(webSocket.client(1)->getLastMessage() != nullptr);
+    CHECK(webSocket.client(1)->getLastMessage() == webSocket.client(2)->getLastMessage());
+    CHECK_EQ(broadcaster.getStats().resyncs, 2);
+    CHECK_EQ(broadcaster.getStats().serialized, 1);
+}
+
+static void testFullQueueSkipsClient() {
+    AsyncWebSocket webSocket("/ws");
+    StateBroadcaster broadcaster(&webSocket);
+    webSocket.connect(1);
+    broadcaster.addClient(1);
+    for (size_t i = 0; i < AsyncWebSocketClient::QUEUE_SIZE; i++) {
+        webSocket.client(1)->text(StateBroadcaster::serialize(JsonDocument()));
+    }
+    broadcastChange(broadcaster, 7);
+    CHECK_EQ(broadcaster.getStats().dropped, 1);
+
+    webSocket.client(1)->drain();
+    broadcaster.update();  // Resync once the queue has room
+    CHECK_EQ(broadcaster.getStats().resyncs, 1);
+}
+
+int main() {
+    hostSetQuiet(true);
+    RUN(testAllocationsIndependentOfClients);
+    RUN(testClientsShareOneBuffer);
+    RUN(testResyncReusesCachedFullState);
+    RUN(testFullQueueSkipsClient);
+    return checkResult();
+}
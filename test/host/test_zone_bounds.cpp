@@ -0,0 +1,133 @@
+// Effects stay inside the strips they are given: the centre-out effects
+// (Fire, Vu, ...) next to an idle zone leave it dark, and on the last
+// strip of a zone or layer buffer they don't run past its end (ASan).
+// Both strip length parities, since the centre shifts with them.
+
+#include "check.h"
+#include "host.h"
+#include "LEDManager.h"
+#include <vector>
+
+static const int FRAMES = 60;
+
+static void bootConfig(int numStrips, int ledsPerStrip) {
+    Preferences::eraseAll();
+    Preferences prefs;
+    prefs.begin("led-config", false);
+    prefs.putInt("num_strips", numStrips);
+    prefs.putInt("leds_per_strip", ledsPerStrip);
+    prefs.end();
+}
+
+static LedZones::Zone makeZone(const char* name, uint8_t strip, uint8_t effect) {
+    LedZones::Zone zone;
+    memset(&zone, 0, sizeof(zone));
+    strncpy(zone.name, name, LedZones::NAME_LENGTH - 1);
+    zone.firstStrip = strip;
+    zone.stripCount = 1;
+    zone.effect = effect;
+    zone.brightness = 255;
+    zone.audioBand = LedZones::AUDIO_SPREAD;
+    return zone;
+}
+
+/**
+ * @brief Run the zones with the audio at full scale
+ * @return The effect frame after the last update
+ */
+static std::vector<CRGB> runZones(int numStrips, int ledsPerStrip, const LedZones::Zone* zones, uint8_t count) {
+    bootConfig(numStrips, ledsPerStrip);
+    LEDManager leds;
+    g_ledManager = &leds;
+    CHECK(leds.initialize());
+    leds.setAnimationEnabled(false);
+    CHECK(leds.setZones(zones, count));
+
+    const int loud[7] = {255, 255, 255, 255, 255, 255, 255};
+    for (int i = 0; i < FRAMES; i++) {
+        leds.updateVuLevels(loud, 255);
+        hostAdvanceMs(50);
+        leds.update();
+    }
+    const CRGB* effect = FastLED.getController().leds();
+    std::vector<CRGB> frame(effect, effect + leds.getTotalLeds());
+    g_ledManager = nullptr;
+    return frame;
+}
+
+static bool dark(const std::vector<CRGB>& frame, int strip, int ledsPerStrip) {
+    for (int i = strip * ledsPerStrip; i < (strip + 1) * ledsPerStrip; i++) {
+        if (frame[i] != CRGB(CRGB::Black)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testIdleZoneStaysDark() {
+    const int lengths[] = {40, 41};
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        int length = lengths[l];
+        const LedZones::Zone zones[4] = {
+            makeZone("off-a", 0, LedZones::EFFECT_OFF),
+            makeZone("fire", 1, LEDManager::FIRE),
+            makeZone("vu", 2, LEDManager::VU),
+            makeZone("off-b", 3, LedZones::EFFECT_OFF),
+        };
+        std::vector<CRGB> frame = runZones(4, length, zones, 4);
+        CHECK(!dark(frame, 1, length));
+        CHECK(!dark(frame, 2, length));
+        CHECK(dark(frame, 0, length));
+        CHECK(dark(frame, 3, length));
+    }
+}
+
+static void testEdgeStripsStayInBuffer() {
+    // Vu on the first strip, Fire on the last: any overrun leaves leds_
+    const int lengths[] = {40, 41};
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        int length = lengths[l];
+        const LedZones::Zone zones[3] = {
+            makeZone("vu", 0, LEDManager::VU),
+            makeZone("off", 1, LedZones::EFFECT_OFF),
+            makeZone("fire", 2, LEDManager::FIRE),
+        };
+        std::vector<CRGB> frame = runZones(3, length, zones, 3);
+        CHECK(dark(frame, 1, length));
+    }
+}
+
+static void testLayersStayInPool() {
+    // The last layer's buffer ends the pool
+    const int lengths[] = {40, 41};
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        bootConfig(2, lengths[l]);
+        LEDManager leds;
+        g_ledManager = &leds;
+        CHECK(leds.initialize());
+        leds.setCurrentAnimation(LEDManager::ICEWAVES);
+        leds.setAnimationEnabled(true);
+        LayerCompositor::Layer layers[LayerCompositor::MAX_LAYERS] = {
+            { LEDManager::PURPLERAIN, LayerCompositor::BLEND_ADD, 255 },
+            { LEDManager::FIRE, LayerCompositor::BLEND_MAX, 255 },
+            { LEDManager::VU, LayerCompositor::BLEND_SCREEN, 255 },
+        };
+        CHECK(leds.setLayers(layers, LayerCompositor::MAX_LAYERS));
+
+        const int loud[7] = {255, 255, 255, 255, 255, 255, 255};
+        for (int i = 0; i < FRAMES; i++) {
+            leds.updateVuLevels(loud, 255);
+            hostAdvanceMs(50);
+            leds.update();
+        }
+        g_ledManager = nullptr;
+    }
+}
+
+int main() {
+    hostSetQuiet(true);
+    RUN(testIdleZoneStaysDark);
+    RUN(testEdgeStripsStayInBuffer);
+    RUN(testLayersStayInPool);
+    return checkResult();
+}